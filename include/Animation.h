@@ -0,0 +1,106 @@
+#pragma once
+
+#include "gfx.h"
+#include "Rotation.h"
+#include "Scalar.h"
+#include "Transform.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace gfx
+{
+
+/**
+ * How rotations get interpolated between keys. Translation and scale always use lerp.
+ */
+enum class Interpolation
+{
+    /** Cheapest, but the angular speed is not constant (up to ~0.14 radians off slerp). */
+    nlerp,
+    slerp,
+    /** Rotation::fast_slerp, within FAST_SLERP_ERROR radians of slerp. */
+    fast_slerp,
+};
+
+constexpr Transform interpolate(const Transform& a, const Transform& b, const Scalar α, const Interpolation interpolation) noexcept
+{
+    const Rotation rotation =
+        interpolation == Interpolation::nlerp ? nlerp(a.rotation, b.rotation, α) :
+        interpolation == Interpolation::slerp ? slerp(a.rotation, b.rotation, α) :
+                                                fast_slerp(a.rotation, b.rotation, α);
+    return {
+        lerp(a.translation, b.translation, α),
+        rotation,
+        lerp(a.scale, b.scale, α),
+    };
+}
+
+/**
+ * Keyframes of one animated transform, at increasing times.
+ * Sampling before the first key or after the last one holds them.
+ */
+class GFX_API AnimationTrack
+{
+private:
+    std::vector<Scalar> _times;
+    std::vector<Transform> _keys;
+
+public:
+    AnimationTrack() noexcept = default;
+    AnimationTrack(std::vector<Scalar> times, std::vector<Transform> keys);
+
+    /**
+     * Append a key, at a time not before the last one.
+     */
+    void add(Scalar time, const Transform& key);
+
+    std::span<const Scalar> times() const noexcept { return _times; }
+    std::span<const Transform> keys() const noexcept { return _keys; }
+    std::size_t size() const noexcept { return _keys.size(); }
+    bool empty() const noexcept { return _keys.empty(); }
+    Scalar duration() const noexcept { return empty() ? 0 : _times.back() - _times.front(); }
+
+    /**
+     * Index of the last key not after time, or 0 before the first one.
+     */
+    std::size_t segment(Scalar time) const noexcept;
+
+    Transform sample(Scalar time, Interpolation interpolation = Interpolation::slerp) const noexcept;
+};
+
+/**
+ * Samples many tracks at once, e.g. all the bones of a crowd.
+ *
+ * Remembers the segment of each track between calls, so playing forwards
+ * finds the keys in constant time, then blends all the tracks with the SIMD kernels
+ * picked at runtime (see Simd.h). Sampling never allocates.
+ */
+class GFX_API AnimationSampler
+{
+private:
+    std::span<const AnimationTrack> _tracks;
+    std::vector<std::uint32_t> _segments;
+
+    // Per track keys and blend factors of the current call
+    std::vector<const Scalar*> _from;
+    std::vector<const Scalar*> _to;
+    std::vector<Scalar> _α;
+
+public:
+    /**
+     * @param tracks Must outlive the sampler, and keep their keys while it samples them.
+     */
+    explicit AnimationSampler(std::span<const AnimationTrack> tracks);
+
+    std::size_t size() const noexcept { return _tracks.size(); }
+
+    /**
+     * out[i] = tracks[i].sample(time, interpolation).
+     */
+    void sample(Scalar time, std::span<Transform> out, Interpolation interpolation = Interpolation::slerp) noexcept;
+};
+
+} // namespace gfx
@@ -0,0 +1,213 @@
+#pragma once
+
+#include "gfx.h"
+#include "Matrix3.h"
+#include "Quaternion.h"
+#include "Rotation.h"
+#include "Sphere.h"
+#include "Transform.h"
+#include "Vector3.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace gfx
+{
+
+/**
+ * Version of the archive format, a binary container of named arrays
+ * laid out so that a mapped file can be used in place:
+ *
+ * - a 64 bytes header: magic, version, byte order, directory position and a checksum of header and directory;
+ * - the arrays, each starting on a 64 bytes boundary, in the layout of the types in memory;
+ * - the directory, one ArchiveEntry per array.
+ *
+ * Files are only portable between machines with the same byte order and float formats,
+ * which the reader checks.
+ */
+inline constexpr std::uint32_t ARCHIVE_VERSION = 1;
+
+/** Alignment of every array in the file, enough for any SIMD load. */
+inline constexpr std::size_t ARCHIVE_ALIGNMENT = 64;
+
+enum class ArchiveType : std::uint32_t
+{
+    none,
+    vector3,
+    vector3d,
+    quaternion,
+    quaterniond,
+    rotation,
+    rotationd,
+    sphere,
+    sphered,
+    matrix3,
+    matrix3d,
+    transform,
+};
+
+template <typename T> inline constexpr ArchiveType ARCHIVE_TYPE = ArchiveType::none;
+template <> inline constexpr ArchiveType ARCHIVE_TYPE<Vector3>     = ArchiveType::vector3;
+template <> inline constexpr ArchiveType ARCHIVE_TYPE<Vector3d>    = ArchiveType::vector3d;
+template <> inline constexpr ArchiveType ARCHIVE_TYPE<Quaternion>  = ArchiveType::quaternion;
+template <> inline constexpr ArchiveType ARCHIVE_TYPE<Quaterniond> = ArchiveType::quaterniond;
+template <> inline constexpr ArchiveType ARCHIVE_TYPE<Rotation>    = ArchiveType::rotation;
+template <> inline constexpr ArchiveType ARCHIVE_TYPE<Rotationd>   = ArchiveType::rotationd;
+template <> inline constexpr ArchiveType ARCHIVE_TYPE<Sphere>      = ArchiveType::sphere;
+template <> inline constexpr ArchiveType ARCHIVE_TYPE<Sphered>     = ArchiveType::sphered;
+template <> inline constexpr ArchiveType ARCHIVE_TYPE<Matrix3>     = ArchiveType::matrix3;
+template <> inline constexpr ArchiveType ARCHIVE_TYPE<Matrix3d>    = ArchiveType::matrix3d;
+template <> inline constexpr ArchiveType ARCHIVE_TYPE<Transform>   = ArchiveType::transform;
+
+template <typename T>
+concept ArchiveElement = ARCHIVE_TYPE<T> != ArchiveType::none && std::is_trivially_copyable_v<T>;
+
+/**
+ * Directory entry of an array, as stored in the file.
+ */
+struct ArchiveEntry
+{
+    /** Null terminated. */
+    char name[32];
+    ArchiveType type;
+    std::uint32_t element_size;
+    /** From the start of the file. */
+    std::uint64_t offset;
+    std::uint64_t count;
+    /** FNV-1a of the array bytes, see MappedArchive::verify. */
+    std::uint64_t checksum;
+
+    std::string_view name_view() const noexcept { return name; }
+};
+
+/**
+ * Writes an archive front to back, so arrays can be streamed in chunks
+ * without ever holding a whole one in memory.
+ * The header and directory are written by finish(), or on destruction.
+ */
+class GFX_API ArchiveWriter
+{
+private:
+    std::ofstream _file;
+    std::vector<ArchiveEntry> _entries;
+    std::uint64_t _offset;
+    bool _finished;
+
+public:
+    explicit ArchiveWriter(const std::string& path);
+    ~ArchiveWriter();
+
+    ArchiveWriter(const ArchiveWriter&) = delete;
+    ArchiveWriter& operator=(const ArchiveWriter&) = delete;
+
+    /**
+     * @return false if the file could not be opened or written.
+     */
+    bool good() const noexcept { return bool(_file); }
+
+    /**
+     * Start a new array, empty until values are appended to it.
+     * Names are unique, at most 31 bytes long.
+     */
+    template <ArchiveElement T>
+    void begin(const std::string_view name)
+    {
+        begin(name, ARCHIVE_TYPE<T>, sizeof(T));
+    }
+
+    /**
+     * Append values to the array started last, which must have their type.
+     */
+    template <std::ranges::contiguous_range R>
+        requires ArchiveElement<std::ranges::range_value_t<R>>
+    void append(const R& values)
+    {
+        using T = std::ranges::range_value_t<R>;
+        append(ARCHIVE_TYPE<T>, std::ranges::data(values), std::ranges::size(values) * sizeof(T));
+    }
+
+    template <std::ranges::contiguous_range R>
+        requires ArchiveElement<std::ranges::range_value_t<R>>
+    void write(const std::string_view name, const R& values)
+    {
+        begin<std::ranges::range_value_t<R>>(name);
+        append(values);
+    }
+
+    /**
+     * Write the directory and header. Nothing can be added afterwards.
+     *
+     * @return false if any part of the file could not be written.
+     */
+    bool finish();
+
+private:
+    void begin(std::string_view name, ArchiveType type, std::uint32_t element_size);
+    void append(ArchiveType type, const void* data, std::size_t bytes);
+};
+
+/**
+ * Read-only memory mapping of an archive: arrays are spans over the mapping,
+ * valid until it is closed, and only the pages that get used are ever read.
+ */
+class GFX_API MappedArchive
+{
+private:
+    const std::byte* _data;
+    std::size_t _size;
+    std::span<const ArchiveEntry> _entries;
+
+public:
+    MappedArchive() noexcept;
+    explicit MappedArchive(const std::string& path);
+    ~MappedArchive();
+
+    MappedArchive(MappedArchive&& archive) noexcept;
+    MappedArchive& operator=(MappedArchive&& archive) noexcept;
+
+    /**
+     * Map path, closing the current mapping.
+     * Checks the header, the directory and that every array lies within the file,
+     * but not the contents of the arrays (see verify).
+     *
+     * @return false if the file could not be mapped or is not a valid archive for this machine.
+     */
+    bool open(const std::string& path);
+    void close() noexcept;
+
+    bool is_open() const noexcept { return _data != nullptr; }
+
+    std::span<const ArchiveEntry> entries() const noexcept { return _entries; }
+
+    /**
+     * @return The entry named name, or nullptr.
+     */
+    const ArchiveEntry* find(std::string_view name) const noexcept;
+
+    /**
+     * Array named name, without any copy.
+     *
+     * @return An empty span if there is no such array or it holds another type.
+     */
+    template <ArchiveElement T>
+    std::span<const T> get(const std::string_view name) const noexcept
+    {
+        const ArchiveEntry* entry = find(name);
+        if (entry == nullptr || entry->type != ARCHIVE_TYPE<T>) return {};
+        return { reinterpret_cast<const T*>(_data + entry->offset), std::size_t(entry->count) };
+    }
+
+    /**
+     * Check the contents of every array against their checksums, reading the whole file.
+     */
+    bool verify() const noexcept;
+};
+
+} // namespace gfx
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Scalar.h"
+#include "Sphere.h"
+#include "Vector3.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace gfx
+{
+
+/**
+ * Axis-aligned bounding box.
+ * The default one is empty (min = +inf, max = -inf), so that it can be grown from nothing.
+ */
+struct BoundingBox
+{
+    Vector3 min = Vector3::infinity();
+    Vector3 max = -Vector3::infinity();
+
+    static constexpr BoundingBox of(const Sphere& s) noexcept
+    {
+        const Scalar r = std::abs(s.radius);
+        return { s.center - Vector3 { r, r, r }, s.center + Vector3 { r, r, r } };
+    }
+
+    constexpr bool empty() const noexcept
+    {
+        return min.x > max.x || min.y > max.y || min.z > max.z;
+    }
+
+    constexpr Vector3 center() const noexcept { return (min + max) * 0.5f; }
+    constexpr Vector3 extent() const noexcept { return max - min; }
+
+    constexpr Scalar surface_area() const noexcept
+    {
+        if (empty()) return 0;
+
+        const Vector3 e = extent();
+        return 2 * (e.x * e.y + e.y * e.z + e.z * e.x);
+    }
+
+    /**
+     * Axis of the largest extent: 0 for x, 1 for y, 2 for z.
+     */
+    constexpr unsigned largest_axis() const noexcept
+    {
+        const Vector3 e = extent();
+        if (e.x >= e.y && e.x >= e.z) return 0;
+        return e.y >= e.z ? 1 : 2;
+    }
+
+    constexpr bool contains(const Vector3& p) const noexcept
+    {
+        return min.x <= p.x && p.x <= max.x
+            && min.y <= p.y && p.y <= max.y
+            && min.z <= p.z && p.z <= max.z;
+    }
+
+    constexpr BoundingBox& expand(const Vector3& p) noexcept
+    {
+        min = { std::min(min.x, p.x), std::min(min.y, p.y), std::min(min.z, p.z) };
+        max = { std::max(max.x, p.x), std::max(max.y, p.y), std::max(max.z, p.z) };
+        return *this;
+    }
+
+    constexpr BoundingBox& expand(const BoundingBox& box) noexcept
+    {
+        min = { std::min(min.x, box.min.x), std::min(min.y, box.min.y), std::min(min.z, box.min.z) };
+        max = { std::max(max.x, box.max.x), std::max(max.y, box.max.y), std::max(max.z, box.max.z) };
+        return *this;
+    }
+};
+
+constexpr BoundingBox merged(BoundingBox a, const BoundingBox& b) noexcept
+{
+    return a.expand(b);
+}
+
+} // namespace gfx
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "gfx.h"
+#include "BoundingBox.h"
+#include "Hit.h"
+#include "Ray.h"
+#include "Scalar.h"
+#include "Sphere.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+namespace gfx
+{
+
+struct BvhOptions
+{
+    // Nodes with this many spheres or fewer always become leaves
+    unsigned max_leaf_size = 4;
+    // Candidate split planes per axis for the surface area heuristic, at most 64
+    unsigned bins = 16;
+    // Inputs at least this large build their top subtrees on several threads
+    std::size_t parallel_threshold = 1 << 16;
+    // 0 means std::thread::hardware_concurrency()
+    unsigned threads = 0;
+};
+
+/**
+ * Bounding volume hierarchy over a set of spheres,
+ * answering ray queries in logarithmic instead of linear time.
+ *
+ * Built top-down with a binned surface area heuristic,
+ * then flattened depth-first into 32 bytes nodes:
+ * the first child of an inner node always follows it in memory.
+ * Spheres are copied in leaf order, so leaves read contiguous memory.
+ *
+ * The hierarchy lives in the memory resource given at construction,
+ * and each build takes its temporary memory from a scratch resource, e.g. a LinearArena (see Memory.h),
+ * so that rebuilding every frame does not have to touch the heap.
+ */
+class GFX_API Bvh
+{
+public:
+    struct alignas(32) Node
+    {
+        BoundingBox bounds;
+        // Leaves: first sphere. Inner nodes: index of the second child.
+        std::uint32_t offset;
+        // Spheres in the leaf, 0 for inner nodes
+        std::uint32_t count;
+
+        constexpr bool is_leaf() const noexcept { return count != 0; }
+    };
+
+private:
+    std::pmr::vector<Node> _nodes;
+    std::pmr::vector<Sphere> _spheres;
+    std::pmr::vector<std::uint32_t> _indices;
+
+public:
+    Bvh() noexcept = default;
+    explicit Bvh(std::pmr::memory_resource* memory) noexcept;
+    explicit Bvh(
+        std::span<const Sphere> spheres,
+        const BvhOptions& options = {},
+        std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+    /**
+     * Replace the hierarchy, reusing its memory.
+     *
+     * @param scratch Temporary memory of the build, free again when it returns.
+     *                Shared with the threads of a parallel build behind a lock.
+     */
+    void build(
+        std::span<const Sphere> spheres,
+        const BvhOptions& options = {},
+        std::pmr::memory_resource* scratch = std::pmr::get_default_resource());
+
+    std::span<const Node> nodes() const noexcept { return _nodes; }
+    std::size_t size() const noexcept { return _spheres.size(); }
+    bool empty() const noexcept { return _spheres.empty(); }
+    BoundingBox bounds() const noexcept { return _nodes.empty() ? BoundingBox {} : _nodes.front().bounds; }
+
+    /**
+     * Closest sphere hit by the ray within [t_min, t_max],
+     * the same one Ray::closest_hit would find over the array the hierarchy was built from,
+     * with its index in that array as primitive.
+     */
+    Hit closest_hit(const Ray& ray, Scalar t_min = 0, Scalar t_max = INFINITY) const noexcept;
+
+    /**
+     * Whether the ray hits any sphere within [t_min, t_max],
+     * stopping at the first one found (e.g. for shadow rays), see Ray::any_hit.
+     */
+    bool any_hit(const Ray& ray, Scalar t_min = 0, Scalar t_max = INFINITY) const noexcept;
+};
+
+} // namespace gfx
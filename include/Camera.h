@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Frustum.h"
+#include "Ray.h"
+#include "Rotation.h"
+#include "Scalar.h"
+#include "Vector3.h"
+
+#include <cmath>
+
+namespace gfx
+{
+
+/**
+ * Pinhole camera, looking forwards (+z) with up (+y) when not rotated.
+ */
+struct Camera
+{
+    Vector3 position;
+    Rotation rotation;
+    // Vertical field of view, in radians
+    Scalar fov = radians(60);
+
+    /**
+     * Ray through a point of the image plane.
+     *
+     * @param u Horizontal coordinate, from 0 (left) to 1 (right).
+     * @param v Vertical coordinate, from 0 (top) to 1 (bottom).
+     * @param aspect Image width over height.
+     */
+    constexpr Ray ray(const Scalar u, const Scalar v, const Scalar aspect) const noexcept
+    {
+        const Scalar h = std::tan(fov / 2);
+        const Vector3 dir = {
+            (2 * u - 1) * h * aspect,
+            (1 - 2 * v) * h,
+            1,
+        };
+        return { position, rotation.rotate(dir) };
+    }
+
+    /**
+     * Volume seen between the near and far planes, for culling.
+     */
+    constexpr Frustum frustum(const Scalar aspect, const Scalar near_distance, const Scalar far_distance) const noexcept
+    {
+        return Frustum::perspective(position, rotation, fov, aspect, near_distance, far_distance);
+    }
+};
+
+} // namespace gfx
@@ -0,0 +1,154 @@
+#pragma once
+
+#include "MathPolicy.h"
+#include "Quaternion.h"
+#include "Rotation.h"
+#include "Scalar.h"
+#include "Vector3.h"
+
+#include <type_traits>
+
+namespace gfx
+{
+
+/**
+ * Rigid transform as a unit dual quaternion real + ε dual, with dual = ½ t real for a translation t:
+ * blending them and normalizing keeps the rotation rigid, unlike blending matrices.
+ * Ladislav Kavan et al., 2008, Geometric Skinning with Approximate Dual Quaternion Blending
+ */
+template <typename T>
+struct BasicDualQuaternion
+{
+    using Scalar = T;
+    using Vector3 = BasicVector3<T>;
+    using Quaternion = BasicQuaternion<T>;
+    using Rotation = BasicRotation<T>;
+
+    Quaternion real = { Vector3::zero(), 1 };
+    Quaternion dual = { Vector3::zero(), 0 };
+
+    /**
+     * Rotating, then translating.
+     */
+    static constexpr BasicDualQuaternion from_rotation_translation(const Rotation& rotation, const Vector3& translation) noexcept
+    {
+        const Quaternion& q = rotation.as_quaternion();
+        return { q, Quaternion { translation, 0 } * q * Scalar(0.5) };
+    }
+
+    template <typename U>
+    constexpr BasicDualQuaternion<U> cast() const noexcept
+    {
+        return { real.template cast<U>(), dual.template cast<U>() };
+    }
+
+    template <typename Math = PreciseMath>
+    constexpr Rotation rotation() const noexcept
+    {
+        return Rotation::template from_quaternion<Math>(real);
+    }
+
+    /**
+     * Of a unit dual quaternion.
+     */
+    constexpr Vector3 translation() const noexcept
+    {
+        return 2 * (dual * real.conjugated()).imaginary;
+    }
+
+
+    constexpr BasicDualQuaternion operator*(const Scalar k) const noexcept
+    {
+        return { real * k, dual * k };
+    }
+
+    constexpr BasicDualQuaternion operator+(const BasicDualQuaternion& q) const noexcept
+    {
+        return { real + q.real, dual + q.dual };
+    }
+
+    /**
+     * Applying q, then the current transform.
+     */
+    constexpr BasicDualQuaternion operator*(const BasicDualQuaternion& q) const noexcept
+    {
+        return { real * q.real, real * q.dual + dual * q.real };
+    }
+
+    /**
+     * Combine with transform, applying the current transform first, like Rotation::then.
+     */
+    constexpr BasicDualQuaternion then(const BasicDualQuaternion& transform) const noexcept
+    {
+        return transform * *this;
+    }
+
+    /**
+     * Inverse of a unit dual quaternion.
+     */
+    constexpr BasicDualQuaternion conjugated() const noexcept
+    {
+        return { real.conjugated(), dual.conjugated() };
+    }
+
+    /**
+     * Nearest unit dual quaternion: a unit real part, and a dual part orthogonal to it.
+     */
+    template <typename Math = PreciseMath>
+    constexpr BasicDualQuaternion normalized() const noexcept
+    {
+        const Scalar k = Math::rsqrt(real.squared_norm());
+        const Quaternion r = real * k;
+        const Quaternion d = dual * k;
+        return { r, d - r * r.dot(d) };
+    }
+
+    template <typename Math = PreciseMath>
+    constexpr BasicDualQuaternion& normalize() noexcept
+    {
+        return *this = normalized<Math>();
+    }
+
+    /**
+     * Of a unit dual quaternion, or one with a unit real part (e.g. blended, then divided by its norm).
+     */
+    constexpr Vector3 transform_point(const Vector3& p) const noexcept
+    {
+        const Vector3 v = real.imaginary;
+        const Scalar w = real.real;
+        const Vector3 t = 2 * (w * dual.imaginary - dual.real * v + v.cross(dual.imaginary));
+        return transform_direction(p) + t;
+    }
+
+    constexpr Vector3 transform_direction(const Vector3& d) const noexcept
+    {
+        const Vector3 v = real.imaginary;
+        return d + 2 * v.cross(v.cross(d) + real.real * d);
+    }
+};
+
+template <typename T>
+constexpr bool are_equal(const BasicDualQuaternion<T>& a, const BasicDualQuaternion<T>& b, const std::type_identity_t<T> ε) noexcept
+{
+    return are_equal(a.real, b.real, ε) && are_equal(a.dual, b.dual, ε);
+}
+
+/**
+ * Same transform: q and -q are.
+ */
+template <typename T>
+constexpr bool are_equivalent(const BasicDualQuaternion<T>& a, const BasicDualQuaternion<T>& b, const std::type_identity_t<T> ε) noexcept
+{
+    return are_equal(a, b, ε) || are_equal(a, b * T(-1), ε);
+}
+
+template <typename T>
+constexpr bool are_equivalent(const BasicDualQuaternion<T>& a, const BasicDualQuaternion<T>& b) noexcept
+{
+    return are_equivalent(a, b, epsilon<T>);
+}
+
+using DualQuaternion = BasicDualQuaternion<Scalar>;
+using DualQuaterniond = BasicDualQuaternion<double>;
+
+} // namespace gfx
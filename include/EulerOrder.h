@@ -0,0 +1,132 @@
+#pragma once
+
+#include <array>
+
+namespace gfx
+{
+
+/**
+ * Axes of the three rotations of a triple of Euler angles, in the order they are applied
+ * around the fixed axes (extrinsic), which is the reverse order around the rotated axes (intrinsic).
+ * E.g. zxy rotates around z, then x, then y, like Unity; Maya's rotate orders are named the same way.
+ *
+ * Tait-Bryan orders (three distinct axes) take one angle per axis: x around X, y around Y, z around Z.
+ * Proper Euler orders (first axis repeated) take the angles in the order they are applied:
+ * x for the first rotation, y for the second, z for the third.
+ */
+enum class EulerOrder
+{
+    xyz,
+    xzy,
+    yxz,
+    yzx,
+    zxy,
+    zyx,
+
+    xyx,
+    xzx,
+    yxy,
+    yzy,
+    zxz,
+    zyz,
+};
+
+inline constexpr std::array<EulerOrder, 12> EULER_ORDERS = {
+    EulerOrder::xyz, EulerOrder::xzy, EulerOrder::yxz, EulerOrder::yzx, EulerOrder::zxy, EulerOrder::zyx,
+    EulerOrder::xyx, EulerOrder::xzx, EulerOrder::yxy, EulerOrder::yzy, EulerOrder::zxz, EulerOrder::zyz,
+};
+
+constexpr bool is_proper_euler(const EulerOrder order) noexcept
+{
+    return order >= EulerOrder::xyx;
+}
+
+/**
+ * Axis of each rotation, in order: 0 for x, 1 for y, 2 for z.
+ */
+constexpr std::array<unsigned, 3> euler_axes(const EulerOrder order) noexcept
+{
+    switch (order)
+    {
+        case EulerOrder::xyz: return { 0, 1, 2 };
+        case EulerOrder::xzy: return { 0, 2, 1 };
+        case EulerOrder::yxz: return { 1, 0, 2 };
+        case EulerOrder::yzx: return { 1, 2, 0 };
+        case EulerOrder::zxy: return { 2, 0, 1 };
+        case EulerOrder::zyx: return { 2, 1, 0 };
+        case EulerOrder::xyx: return { 0, 1, 0 };
+        case EulerOrder::xzx: return { 0, 2, 0 };
+        case EulerOrder::yxy: return { 1, 0, 1 };
+        case EulerOrder::yzy: return { 1, 2, 1 };
+        case EulerOrder::zxz: return { 2, 0, 2 };
+        default:              return { 2, 1, 2 };
+    }
+}
+
+/**
+ * Component of the angles vector holding the angle of each rotation, in order: 0 for x, 1 for y, 2 for z.
+ */
+constexpr std::array<unsigned, 3> euler_angle_components(const EulerOrder order) noexcept
+{
+    return is_proper_euler(order) ? std::array<unsigned, 3> { 0, 1, 2 } : euler_axes(order);
+}
+
+template <EulerOrder order>
+inline constexpr std::array<unsigned, 3> EULER_ANGLE_COMPONENTS = euler_angle_components(order);
+
+/**
+ * Closed form of the quaternion of a triple of Euler angles, q3 q2 q1 with qk = ck + sk axis_k,
+ * where ck and sk are the cosine and sine of half the angle of rotation k:
+ * each of x, y, z, w is the sum of two of the 8 products of one ck or sk per rotation,
+ * e.g. w = c1 c2 c3 + s1 s2 s3 for xyz.
+ */
+struct EulerProduct
+{
+    struct Term
+    {
+        /** Bit k set for the sine of rotation k + 1, clear for its cosine. */
+        unsigned sines;
+        int sign;
+    };
+
+    /** Terms of x, y, z, w. */
+    Term terms[4][2];
+};
+
+constexpr EulerProduct euler_product(const EulerOrder order) noexcept
+{
+    // Products of the units i, j, k, 1 (indices 0 to 3) are ± a unit
+    struct Unit
+    {
+        unsigned index;
+        int sign;
+    };
+    const auto multiply = [](const Unit a, const Unit b) -> Unit {
+        const int sign = a.sign * b.sign;
+        if (a.index == 3) return { b.index, sign };
+        if (b.index == 3) return { a.index, sign };
+        if (a.index == b.index) return { 3, -sign };
+        // ij = k, jk = i, ki = j, and the opposite the other way round
+        return { 3 - a.index - b.index, (b.index + 3 - a.index) % 3 == 1 ? sign : -sign };
+    };
+
+    const std::array<unsigned, 3> axes = euler_axes(order);
+    EulerProduct product {};
+    unsigned count[4] = {};
+    for (unsigned sines = 0; sines < 8; ++sines)
+    {
+        Unit unit = { 3, 1 };
+        for (unsigned k = 0; k < 3; ++k)
+        {
+            // Later rotations multiply on the left
+            if (sines & (1 << k)) unit = multiply({ axes[k], 1 }, unit);
+        }
+        product.terms[unit.index][count[unit.index]++] = { sines, unit.sign };
+    }
+    return product;
+}
+
+template <EulerOrder order>
+inline constexpr EulerProduct EULER_PRODUCT = euler_product(order);
+
+} // namespace gfx
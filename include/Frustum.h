@@ -0,0 +1,140 @@
+#pragma once
+
+#include "gfx.h"
+#include "Plane.h"
+#include "Rotation.h"
+#include "Scalar.h"
+#include "Sphere.h"
+#include "Vector3.h"
+#include "Vector3Batch.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+namespace gfx
+{
+
+/**
+ * Convex volume bounded by 6 planes with unit normals pointing inwards,
+ * e.g. what a camera sees between its near and far planes.
+ */
+struct Frustum
+{
+    // Left, right, bottom, top, near and far
+    Plane planes[6];
+
+    /**
+     * Frustum of a pinhole camera (see Camera), looking forwards (+z) with up (+y) when not rotated.
+     *
+     * @param fov Vertical field of view, in radians.
+     * @param aspect Image width over height.
+     * @param near_distance, far_distance Distances of the near and far planes to position.
+     */
+    static constexpr Frustum perspective(
+        const Vector3& position,
+        const Rotation& rotation,
+        const Scalar fov,
+        const Scalar aspect,
+        const Scalar near_distance,
+        const Scalar far_distance) noexcept
+    {
+        const Scalar h = std::tan(fov / 2);
+        const Scalar w = h * aspect;
+
+        // In camera space, then rotated and moved to the camera
+        const Vector3 normals[6] = {
+            Vector3 { 1, 0, w }.normalized(),
+            Vector3 { -1, 0, w }.normalized(),
+            Vector3 { 0, 1, h }.normalized(),
+            Vector3 { 0, -1, h }.normalized(),
+            Vector3::forwards(),
+            Vector3::backwards(),
+        };
+        const Scalar distances[6] = { 0, 0, 0, 0, -near_distance, far_distance };
+
+        Frustum frustum {};
+        for (unsigned i = 0; i < 6; ++i)
+        {
+            const Vector3 n = rotation.rotate(normals[i]);
+            frustum.planes[i] = { n, distances[i] - n.dot(position) };
+        }
+        return frustum;
+    }
+
+    constexpr bool contains(const Vector3& p) const noexcept
+    {
+        for (const Plane& plane : planes)
+        {
+            if (plane.signed_distance(p) < 0) return false;
+        }
+        return true;
+    }
+
+    /**
+     * Whether s may be partly inside: false only if it is entirely outside one of the planes,
+     * so spheres near the edges but outside the corners are kept, as usual for culling.
+     */
+    constexpr bool intersects(const Sphere& s) const noexcept
+    {
+        for (const Plane& plane : planes)
+        {
+            if (!plane.reaches(s)) return false;
+        }
+        return true;
+    }
+};
+
+
+/**
+ * Culling of spheres, given as centers and radii, with the SIMD kernels (see Simd.h):
+ * the same test as Frustum::intersects for each of them.
+ *
+ * @param visible Gets the indices of the spheres that intersect frustum, in order.
+ *                As large as radii, its end may be overwritten.
+ * @return Number of visible spheres.
+ */
+GFX_API std::size_t cull_spheres(
+    ConstVector3Span centers,
+    std::span<const Scalar> radii,
+    const Frustum& frustum,
+    std::span<std::uint32_t> visible) noexcept;
+
+/**
+ * Same as cull_spheres(centers, radii, frustum, visible), returning a new list from memory,
+ * e.g. a LinearArena (see Memory.h) for the draw list of a frame.
+ */
+GFX_API std::pmr::vector<std::uint32_t> visible_spheres(
+    ConstVector3Span centers,
+    std::span<const Scalar> radii,
+    const Frustum& frustum,
+    std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+/**
+ * Culling of spheres against up to 32 frusta in a single pass over them, e.g. for shadow cascades:
+ * bit f of masks[i] is set if sphere i intersects frusta[f].
+ */
+GFX_API void cull_spheres(
+    ConstVector3Span centers,
+    std::span<const Scalar> radii,
+    std::span<const Frustum> frusta,
+    std::span<std::uint32_t> masks) noexcept;
+
+/**
+ * Culling of spheres against several frusta in a single pass over them,
+ * with an index list per frustum as for a single frustum.
+ *
+ * @param visible One span per frustum, each as large as radii.
+ * @param counts Gets the number of visible spheres of each frustum.
+ */
+GFX_API void cull_spheres(
+    ConstVector3Span centers,
+    std::span<const Scalar> radii,
+    std::span<const Frustum> frusta,
+    std::span<const std::span<std::uint32_t>> visible,
+    std::span<std::size_t> counts) noexcept;
+
+} // namespace gfx
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+
+namespace gfx
+{
+
+/**
+ * IEEE 754 half-precision float, for storage only: it converts implicitly to and from float,
+ * and all the math happens in float. Halves the memory traffic of large buffers,
+ * e.g. point sets stored as Vector3h and converted with cast<Scalar>() when loaded.
+ *
+ * 11 bits of precision (about 3 decimal digits), finite values up to 65504.
+ */
+struct Half
+{
+    std::uint16_t bits;
+
+    constexpr Half() noexcept
+        : bits(0)
+    {
+    }
+
+    constexpr Half(const float f) noexcept
+        : bits(from_float(f))
+    {
+    }
+
+    static constexpr Half from_bits(const std::uint16_t bits) noexcept
+    {
+        Half h;
+        h.bits = bits;
+        return h;
+    }
+
+    constexpr operator float() const noexcept
+    {
+        const std::uint32_t sign = std::uint32_t(bits & 0x8000) << 16;
+        const std::uint32_t exponent = (bits >> 10) & 0x1f;
+        const std::uint32_t mantissa = bits & 0x3ff;
+
+        // Infinity and NaN
+        if (exponent == 0x1f) return std::bit_cast<float>(sign | 0x7f800000 | mantissa << 13);
+
+        // Zero and subnormals are mantissa * 2^-24, exact in float
+        if (exponent == 0) return std::bit_cast<float>(sign | std::bit_cast<std::uint32_t>(float(mantissa) * 0x1p-24f));
+
+        return std::bit_cast<float>(sign | (exponent + 127 - 15) << 23 | mantissa << 13);
+    }
+
+private:
+    /**
+     * Round to nearest even, overflowing to infinity.
+     * Fabian Giesen, 2016, float->half variants
+     * https://gist.github.com/rygorous/2156668
+     */
+    static constexpr std::uint16_t from_float(const float f) noexcept
+    {
+        std::uint32_t x = std::bit_cast<std::uint32_t>(f);
+        const std::uint32_t sign = (x >> 16) & 0x8000;
+        x &= 0x7fffffff;
+
+        std::uint32_t h;
+        if (x >= (127 + 16) << 23)
+        {
+            // Too large (infinity), or NaN (kept quiet)
+            h = x > 0x7f800000 ? 0x7e00 : 0x7c00;
+        }
+        else if (x < (127 - 14) << 23)
+        {
+            // Subnormal or zero: let the float addition round the mantissa into place
+            constexpr std::uint32_t magic = ((127 - 15) + (23 - 10) + 1) << 23;
+            h = std::bit_cast<std::uint32_t>(std::bit_cast<float>(x) + std::bit_cast<float>(magic)) - magic;
+        }
+        else
+        {
+            // Rebias the exponent, then round the 13 dropped bits to nearest even
+            const std::uint32_t odd = (x >> 13) & 1;
+            h = (x + ((15u - 127u) << 23) + 0xfff + odd) >> 13;
+        }
+        return std::uint16_t(sign | h);
+    }
+};
+
+} // namespace gfx
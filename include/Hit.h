@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Scalar.h"
+#include "Vector3.h"
+
+#include <cmath>
+#include <cstdint>
+
+namespace gfx
+{
+
+/** Primitive index of a ray that hits nothing. */
+inline constexpr std::uint32_t no_hit = 0xffffffff;
+
+/**
+ * Closest intersection found by a ray query, with what shading needs.
+ */
+template <typename T>
+struct BasicHit
+{
+    using Scalar = T;
+    using Vector3 = BasicVector3<T>;
+
+    /** Distance along the ray, infinity on a miss. */
+    Scalar t = INFINITY;
+    Vector3 point = Vector3::infinity();
+    /** Unit normal of the surface at point, pointing outwards. */
+    Vector3 normal = Vector3::zero();
+    /** Index of the primitive in the queried array, no_hit on a miss. */
+    std::uint32_t primitive = no_hit;
+
+    constexpr explicit operator bool() const noexcept { return primitive != no_hit; }
+};
+
+using Hit = BasicHit<Scalar>;
+using Hitd = BasicHit<double>;
+
+} // namespace gfx
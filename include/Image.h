@@ -0,0 +1,50 @@
+#pragma once
+
+#include "gfx.h"
+#include "Vector3.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace gfx
+{
+
+/**
+ * Linear RGB float image, stored row by row from the top left corner.
+ */
+class GFX_API Image
+{
+private:
+    unsigned _width;
+    unsigned _height;
+    std::vector<Vector3> _pixels;
+
+public:
+    Image() noexcept;
+    Image(unsigned width, unsigned height);
+
+    unsigned width() const noexcept { return _width; }
+    unsigned height() const noexcept { return _height; }
+
+    Vector3& at(const unsigned x, const unsigned y) noexcept { return _pixels[std::size_t(y) * _width + x]; }
+    const Vector3& at(const unsigned x, const unsigned y) const noexcept { return _pixels[std::size_t(y) * _width + x]; }
+
+    const std::vector<Vector3>& pixels() const noexcept { return _pixels; }
+
+    /**
+     * Binary PPM (P6): 8 bits per channel, clamped to [0, 1] and sRGB encoded.
+     *
+     * @return false if the file could not be written.
+     */
+    bool write_ppm(const std::string& path) const;
+
+    /**
+     * Portable float map (PF): linear 32 bits per channel, little endian.
+     *
+     * @return false if the file could not be written.
+     */
+    bool write_pfm(const std::string& path) const;
+};
+
+} // namespace gfx
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <bit>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <type_traits>
+
+namespace gfx
+{
+
+// Math policies, picked per call site by the functions that take a Math template parameter,
+// e.g. v.normalized<FastMath>() or slerp<FastMath>(a, b, α).
+
+/**
+ * Standard library functions, correctly rounded or nearly so. The default everywhere.
+ */
+struct PreciseMath
+{
+    template <std::floating_point T>
+    static constexpr T sqrt(const T x) noexcept { return std::sqrt(x); }
+
+    template <std::floating_point T>
+    static constexpr T rsqrt(const T x) noexcept { return 1 / std::sqrt(x); }
+
+    template <std::floating_point T>
+    static constexpr T sin(const T x) noexcept { return std::sin(x); }
+
+    template <std::floating_point T>
+    static constexpr T cos(const T x) noexcept { return std::cos(x); }
+
+    template <std::floating_point T>
+    static constexpr T acos(const T x) noexcept { return std::acos(x); }
+};
+
+/**
+ * Polynomial and bit-level approximations, constexpr with any compiler
+ * (unlike <cmath>, which only GCC evaluates at compile time).
+ * They are branch-free, so the compiler can vectorize loops over them.
+ *
+ * The coefficients are fitted for float: double gets the same error bounds.
+ */
+struct FastMath
+{
+    /** Largest relative error of rsqrt and sqrt, for positive normal x. */
+    static constexpr double RSQRT_ERROR = 5e-6;
+    /** Largest absolute error of sin and cos, for |x| up to 8192. */
+    static constexpr double SIN_COS_ERROR = 2e-7;
+    /** Largest error of acos in radians, on [-1, 1]. */
+    static constexpr double ACOS_ERROR = 1e-5;
+
+    /**
+     * 1 / √x from the exponent halved in the integer representation,
+     * refined by two Newton steps.
+     * Chris Lomont, 2003, Fast Inverse Square Root
+     */
+    template <std::floating_point T>
+        requires (sizeof(T) == 4 || sizeof(T) == 8)
+    static constexpr T rsqrt(const T x) noexcept
+    {
+        using Bits = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+        constexpr Bits magic = sizeof(T) == 4 ? Bits(0x5f375a86) : Bits(0x5fe6eb50c7b537a9);
+
+        const T half = x * T(0.5);
+        T y = std::bit_cast<T>(Bits(magic - (std::bit_cast<Bits>(x) >> 1)));
+        y = y * (T(1.5) - half * y * y);
+        y = y * (T(1.5) - half * y * y);
+        return y;
+    }
+
+    /**
+     * √x as x / √x, 0 included.
+     */
+    template <std::floating_point T>
+    static constexpr T sqrt(const T x) noexcept
+    {
+        return x * rsqrt(x);
+    }
+
+    template <std::floating_point T>
+    static constexpr T sin(const T x) noexcept { return sin_cos(x, 0); }
+
+    template <std::floating_point T>
+    static constexpr T cos(const T x) noexcept { return sin_cos(x, 1); }
+
+    /**
+     * Milton Abramowitz and Irene Stegun, 1964, Handbook of Mathematical Functions, 4.4.46,
+     * within 2e-8 before the error of sqrt.
+     */
+    template <std::floating_point T>
+    static constexpr T acos(const T x) noexcept
+    {
+        // acos(-x) = π - acos(x)
+        const T sign = x < 0 ? T(-1) : T(1);
+        const T a = x * sign;
+        T p = T(-0.0012624911);
+        p = p * a + T(0.0066700901);
+        p = p * a + T(-0.0170881256);
+        p = p * a + T(0.0308918810);
+        p = p * a + T(-0.0501743046);
+        p = p * a + T(0.0889789874);
+        p = p * a + T(-0.2145988016);
+        p = p * a + T(1.5707963050);
+        return sign * (sqrt(T(1) - a) * p - T(M_PI / 2)) + T(M_PI / 2);
+    }
+
+private:
+    /**
+     * sin(x + quadrant π/2): x is reduced to r in [-π/4, π/4] by subtracting k π/2,
+     * with π/2 split in three parts so that k π/2 stays exact (Cody and Waite),
+     * then sin(r) or cos(r) get evaluated by minimax polynomials.
+     * Stephen Moshier, Cephes Math Library, sinf.c
+     */
+    template <std::floating_point T>
+        requires (sizeof(T) == 4 || sizeof(T) == 8)
+    static constexpr T sin_cos(const T x, const int quadrant) noexcept
+    {
+        // Adding 1.5 2^mantissa_bits rounds n to an integer, left in the low bits of the mantissa
+        using Bits = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+        constexpr T shifter = sizeof(T) == 4 ? T(0x1.8p23) : T(0x1.8p52);
+        const T shifted = x * T(0.63661977236758134) + shifter;
+        const T kf = shifted - shifter;
+        const T r = ((x - kf * T(1.5703125)) - kf * T(4.837512969970703125e-4)) - kf * T(7.54978995489188216e-8);
+        const T z = r * r;
+
+        const T s = r + r * z * (T(-1.6666654611e-1) + z * (T(8.3321608736e-3) + z * T(-1.9515295891e-4)));
+        const T c = T(1) - T(0.5) * z + z * z * (T(4.166664568298827e-2) + z * (T(-1.388731625493765e-3) + z * T(2.443315711809948e-5)));
+
+        // sin(r + q π/2) is sin r, cos r, -sin r, -cos r for q = 0, 1, 2, 3
+        const Bits q = (std::bit_cast<Bits>(shifted) + Bits(quadrant)) & 3;
+        const T odd = T(q & 1);
+        return (s * (T(1) - odd) + c * odd) * (T(1) - T(q & 2));
+    }
+};
+
+} // namespace gfx
@@ -3,82 +3,289 @@
 #include "Scalar.h"
 #include "Vector3.h"
 
+#include <array>
+#include <cmath>
+#include <type_traits>
+
 namespace gfx
 {
 
-class Matrix3
+template <typename T>
+class BasicMatrix3
 {
+public:
+    using Scalar = T;
+    using Vector3 = BasicVector3<T>;
+
 private:
-    Vector3 _rows[3];
+    // Row-major and tightly packed, so the batch kernels can read it as 9 floats
+    Scalar _m[3][3];
 
 public:
-    constexpr Matrix3() noexcept
-        : _rows {}
+    constexpr BasicMatrix3() noexcept
+        : _m {}
     {
     }
 
-    constexpr Matrix3(
+    constexpr BasicMatrix3(
         const Vector3& row1,
         const Vector3& row2,
         const Vector3& row3) noexcept
-        : _rows { row1, row2, row3 }
+        : _m {
+            { row1.x, row1.y, row1.z },
+            { row2.x, row2.y, row2.z },
+            { row3.x, row3.y, row3.z },
+        }
+    {
+    }
+
+    template <typename U>
+    constexpr BasicMatrix3<U> cast() const noexcept
     {
+        return { row(1).template cast<U>(), row(2).template cast<U>(), row(3).template cast<U>() };
+    }
+
+    static constexpr BasicMatrix3 identity() noexcept
+    {
+        return { Vector3::right(), Vector3::up(), Vector3::forwards() };
+    }
+
+    static constexpr BasicMatrix3 from_columns(const Vector3& col1, const Vector3& col2, const Vector3& col3) noexcept
+    {
+        return BasicMatrix3 { col1, col2, col3 }.transposed();
+    }
+
+    static constexpr BasicMatrix3 from_diagonal(const Vector3& d) noexcept
+    {
+        return { { d.x, 0, 0 }, { 0, d.y, 0 }, { 0, 0, d.z } };
     }
 
     constexpr Vector3 row(const unsigned n) const noexcept
     {
         if (n == 0 || n > 3) return { NAN, NAN, NAN };
 
-        return _rows[n - 1];
+        return { _m[n - 1][0], _m[n - 1][1], _m[n - 1][2] };
     }
 
     constexpr Vector3 col(const unsigned n) const noexcept
     {
         if (n == 0 || n > 3) return { NAN, NAN, NAN };
 
-        return {
-            row(1).element(n),
-            row(2).element(n),
-            row(3).element(n),
-        };
+        return { _m[0][n - 1], _m[1][n - 1], _m[2][n - 1] };
     }
 
+    /**
+     * Math-like accessor, with indices starting from 1.
+     *
+     * @return M_rc, or NaN if an index is out of bounds.
+     */
     constexpr Scalar element(const unsigned r, const unsigned c) const noexcept
     {
-        return row(r).element(c);
+        if (r == 0 || r > 3 || c == 0 || c > 3) return NAN;
+
+        return _m[r - 1][c - 1];
     }
 
-    constexpr Matrix3 operator*(const Scalar k) const noexcept
+    constexpr BasicMatrix3& set(const unsigned r, const unsigned c, const Scalar value) noexcept
+    {
+        if (r != 0 && r <= 3 && c != 0 && c <= 3) _m[r - 1][c - 1] = value;
+        return *this;
+    }
+
+    /**
+     * Unchecked accessor for hot loops, with indices starting from 0 (unlike element).
+     */
+    constexpr Scalar operator()(const unsigned i, const unsigned j) const noexcept { return _m[i][j]; }
+    constexpr Scalar& operator()(const unsigned i, const unsigned j) noexcept { return _m[i][j]; }
+
+    constexpr std::array<Scalar, 9> row_major() const noexcept
     {
         return {
-            k * row(1),
-            k * row(2),
-            k * row(3),
+            _m[0][0], _m[0][1], _m[0][2],
+            _m[1][0], _m[1][1], _m[1][2],
+            _m[2][0], _m[2][1], _m[2][2],
         };
     }
 
-    constexpr Matrix3 operator*(const Matrix3& M) const noexcept
+    constexpr std::array<Scalar, 9> column_major() const noexcept
+    {
+        return transposed().row_major();
+    }
+
+    /**
+     * Columns padded to 4 floats, the layout of a mat3 in std140 uniform buffers.
+     * Padding elements are 0.
+     */
+    constexpr std::array<Scalar, 12> column_major_padded() const noexcept
     {
         return {
-            { row(1).dot(M.col(1)), row(1).dot(M.col(2)), row(1).dot(M.col(3)) },
-            { row(2).dot(M.col(1)), row(2).dot(M.col(2)), row(2).dot(M.col(3)) },
-            { row(3).dot(M.col(1)), row(3).dot(M.col(2)), row(3).dot(M.col(3)) },
+            _m[0][0], _m[1][0], _m[2][0], 0,
+            _m[0][1], _m[1][1], _m[2][1], 0,
+            _m[0][2], _m[1][2], _m[2][2], 0,
         };
     }
 
+
+    constexpr BasicMatrix3 operator*(const Scalar k) const noexcept
+    {
+        BasicMatrix3 M = *this;
+        for (auto& row : M._m)
+        {
+            for (Scalar& e : row) e *= k;
+        }
+        return M;
+    }
+
+    constexpr BasicMatrix3 operator+(const BasicMatrix3& B) const noexcept
+    {
+        BasicMatrix3 M = *this;
+        for (unsigned r = 0; r < 3; ++r)
+        {
+            for (unsigned c = 0; c < 3; ++c) M._m[r][c] += B._m[r][c];
+        }
+        return M;
+    }
+
+    constexpr BasicMatrix3 operator-(const BasicMatrix3& B) const noexcept
+    {
+        return *this + B * -1;
+    }
+
+    constexpr BasicMatrix3 operator*(const BasicMatrix3& B) const noexcept
+    {
+        // Each row of the product is a combination of the rows of B,
+        // independent lanes the compiler can vectorize
+        BasicMatrix3 M;
+        for (unsigned r = 0; r < 3; ++r)
+        {
+            for (unsigned c = 0; c < 3; ++c)
+            {
+                M._m[r][c] = _m[r][0] * B._m[0][c]
+                           + _m[r][1] * B._m[1][c]
+                           + _m[r][2] * B._m[2][c];
+            }
+        }
+        return M;
+    }
+
     constexpr Vector3 operator*(const Vector3& v) const noexcept
     {
         return {
-            row(1).dot(v),
-            row(2).dot(v),
-            row(3).dot(v),
+            _m[0][0] * v.x + _m[0][1] * v.y + _m[0][2] * v.z,
+            _m[1][0] * v.x + _m[1][1] * v.y + _m[1][2] * v.z,
+            _m[2][0] * v.x + _m[2][1] * v.y + _m[2][2] * v.z,
+        };
+    }
+
+    constexpr bool operator==(const BasicMatrix3& B) const noexcept
+    {
+        for (unsigned r = 0; r < 3; ++r)
+        {
+            for (unsigned c = 0; c < 3; ++c)
+            {
+                if (!are_equal(_m[r][c], B._m[r][c])) return false;
+            }
+        }
+        return true;
+    }
+
+    constexpr BasicMatrix3 transposed() const noexcept
+    {
+        return {
+            { _m[0][0], _m[1][0], _m[2][0] },
+            { _m[0][1], _m[1][1], _m[2][1] },
+            { _m[0][2], _m[1][2], _m[2][2] },
         };
     }
+
+    constexpr BasicMatrix3& transpose() noexcept
+    {
+        *this = transposed();
+        return *this;
+    }
+
+    constexpr Scalar trace() const noexcept
+    {
+        return _m[0][0] + _m[1][1] + _m[2][2];
+    }
+
+    constexpr Scalar determinant() const noexcept
+    {
+        // Triple product of the rows
+        return row(1).dot(row(2).cross(row(3)));
+    }
+
+    /**
+     * General inverse, through the adjugate.
+     * Singular matrices give non-finite elements.
+     */
+    constexpr BasicMatrix3 inverse() const noexcept
+    {
+        // The columns of the inverse are the cross products of the rows, over the determinant
+        const Vector3 r1 = row(1);
+        const Vector3 r2 = row(2);
+        const Vector3 r3 = row(3);
+        const Vector3 c1 = r2.cross(r3);
+        const Vector3 c2 = r3.cross(r1);
+        const Vector3 c3 = r1.cross(r2);
+        const Scalar k = 1 / r1.dot(c1);
+        return from_columns(c1 * k, c2 * k, c3 * k);
+    }
+
+    /**
+     * Matrix for normals transformed along with points: the inverse transpose.
+     */
+    constexpr BasicMatrix3 normal_matrix() const noexcept
+    {
+        return inverse().transposed();
+    }
+
+    /**
+     * Rotation matrix close to a slightly drifted one, e.g. after many incremental updates:
+     * the error of the first two rows is spread evenly over both,
+     * then cross products complete them into an orthonormal basis.
+     * William Premerlani and Paul Bizard, 2009, Direction Cosine Matrix IMU: Theory, eq. 19-21
+     */
+    template <typename Math = PreciseMath>
+    constexpr BasicMatrix3 orthonormalized() const noexcept
+    {
+        const Vector3 r1 = row(1);
+        const Vector3 r2 = row(2);
+        const Scalar half_error = r1.dot(r2) / 2;
+        const Vector3 x = (r1 - r2 * half_error).template normalized<Math>();
+        const Vector3 y = r2 - r1 * half_error;
+        const Vector3 z = x.cross(y).template normalized<Math>();
+        return { x, z.cross(x), z };
+    }
+
+    template <typename Math = PreciseMath>
+    constexpr BasicMatrix3& orthonormalize() noexcept
+    {
+        *this = orthonormalized<Math>();
+        return *this;
+    }
 };
 
+template <typename T>
+constexpr bool are_equal(const BasicMatrix3<T>& A, const BasicMatrix3<T>& B, const std::type_identity_t<T> ε) noexcept
+{
+    for (unsigned r = 0; r < 3; ++r)
+    {
+        for (unsigned c = 0; c < 3; ++c)
+        {
+            if (!are_equal(A(r, c), B(r, c), ε)) return false;
+        }
+    }
+    return true;
+}
+
+using Matrix3 = BasicMatrix3<Scalar>;
+using Matrix3d = BasicMatrix3<double>;
+
 } // namespace gfx
 
-constexpr gfx::Matrix3 operator*(const gfx::Scalar k, const gfx::Matrix3& M) noexcept
+template <typename T>
+constexpr gfx::BasicMatrix3<T> operator*(const std::type_identity_t<T> k, const gfx::BasicMatrix3<T>& M) noexcept
 {
     return M * k;
 }
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "gfx.h"
+#include "Matrix3.h"
+#include "Vector3.h"
+#include "Vector3Batch.h"
+
+#include <span>
+
+namespace gfx
+{
+
+// Bulk versions of Matrix3 * Vector3, e.g. to transform a normal buffer
+// by a normal_matrix() every frame.
+//
+// Run on the SIMD kernels picked at runtime (see Simd.h).
+// All the spans of a call must have the same size, out may be the same as points.
+
+GFX_API void multiply(const Matrix3& M, std::span<const Vector3> points, std::span<Vector3> out) noexcept;
+GFX_API void multiply(const Matrix3& M, std::span<Vector3> points) noexcept;
+
+GFX_API void multiply(const Matrix3& M, ConstVector3Span points, Vector3Span out) noexcept;
+GFX_API void multiply(const Matrix3& M, Vector3Span points) noexcept;
+
+} // namespace gfx
@@ -0,0 +1,265 @@
+#pragma once
+
+#include "Matrix3.h"
+#include "Scalar.h"
+#include "Vector3.h"
+
+#include <array>
+#include <cmath>
+
+namespace gfx
+{
+
+/**
+ * 4x4 matrix for homogeneous coordinates,
+ * mainly to hand transforms over to graphics APIs.
+ */
+class Matrix4
+{
+private:
+    // Row-major
+    Scalar _m[4][4];
+
+public:
+    constexpr Matrix4() noexcept
+        : _m {}
+    {
+    }
+
+    static constexpr Matrix4 identity() noexcept
+    {
+        Matrix4 M;
+        for (unsigned i = 0; i < 4; ++i) M._m[i][i] = 1;
+        return M;
+    }
+
+    /**
+     * Affine matrix applying linear, then translating by translation.
+     */
+    static constexpr Matrix4 from_affine(const Matrix3& linear, const Vector3& translation) noexcept
+    {
+        Matrix4 M = identity();
+        for (unsigned r = 0; r < 3; ++r)
+        {
+            for (unsigned c = 0; c < 3; ++c)
+            {
+                M._m[r][c] = linear(r, c);
+            }
+        }
+        M._m[0][3] = translation.x;
+        M._m[1][3] = translation.y;
+        M._m[2][3] = translation.z;
+        return M;
+    }
+
+    static constexpr Matrix4 from_translation(const Vector3& t) noexcept
+    {
+        return from_affine(Matrix3::identity(), t);
+    }
+
+    static constexpr Matrix4 from_scaling(const Vector3& s) noexcept
+    {
+        return from_affine(Matrix3::from_diagonal(s), Vector3::zero());
+    }
+
+    /**
+     * Math-like accessor, with indices starting from 1.
+     *
+     * @return M_rc, or NaN if an index is out of bounds.
+     */
+    constexpr Scalar element(const unsigned r, const unsigned c) const noexcept
+    {
+        if (r == 0 || r > 4 || c == 0 || c > 4) return NAN;
+
+        return _m[r - 1][c - 1];
+    }
+
+    constexpr Matrix4& set(const unsigned r, const unsigned c, const Scalar value) noexcept
+    {
+        if (r != 0 && r <= 4 && c != 0 && c <= 4) _m[r - 1][c - 1] = value;
+        return *this;
+    }
+
+    /**
+     * Upper left 3x3 block: the linear part of an affine matrix.
+     */
+    constexpr Matrix3 linear() const noexcept
+    {
+        return {
+            { _m[0][0], _m[0][1], _m[0][2] },
+            { _m[1][0], _m[1][1], _m[1][2] },
+            { _m[2][0], _m[2][1], _m[2][2] },
+        };
+    }
+
+    constexpr Vector3 translation() const noexcept
+    {
+        return { _m[0][3], _m[1][3], _m[2][3] };
+    }
+
+    /**
+     * Elements column after column, the layout expected by OpenGL, Vulkan and most shaders.
+     */
+    constexpr std::array<Scalar, 16> column_major() const noexcept
+    {
+        std::array<Scalar, 16> a {};
+        for (unsigned c = 0; c < 4; ++c)
+        {
+            for (unsigned r = 0; r < 4; ++r)
+            {
+                a[4 * c + r] = _m[r][c];
+            }
+        }
+        return a;
+    }
+
+    constexpr std::array<Scalar, 16> row_major() const noexcept
+    {
+        return transposed().column_major();
+    }
+
+
+    constexpr Matrix4 operator*(const Scalar k) const noexcept
+    {
+        Matrix4 M = *this;
+        for (auto& row : M._m)
+        {
+            for (Scalar& e : row) e *= k;
+        }
+        return M;
+    }
+
+    constexpr Matrix4 operator*(const Matrix4& B) const noexcept
+    {
+        Matrix4 M;
+        for (unsigned r = 0; r < 4; ++r)
+        {
+            for (unsigned c = 0; c < 4; ++c)
+            {
+                M._m[r][c] = _m[r][0] * B._m[0][c]
+                           + _m[r][1] * B._m[1][c]
+                           + _m[r][2] * B._m[2][c]
+                           + _m[r][3] * B._m[3][c];
+            }
+        }
+        return M;
+    }
+
+    constexpr bool operator==(const Matrix4& B) const noexcept
+    {
+        for (unsigned r = 0; r < 4; ++r)
+        {
+            for (unsigned c = 0; c < 4; ++c)
+            {
+                if (!are_equal(_m[r][c], B._m[r][c])) return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Transform the point (p, 1), dividing by the resulting w.
+     */
+    constexpr Vector3 transform_point(const Vector3& p) const noexcept
+    {
+        const Vector3 q = linear() * p + translation();
+        const Scalar w = _m[3][0] * p.x + _m[3][1] * p.y + _m[3][2] * p.z + _m[3][3];
+        return w == 1 ? q : q * (1 / w);
+    }
+
+    /**
+     * Transform the direction (d, 0): translation does not apply.
+     */
+    constexpr Vector3 transform_direction(const Vector3& d) const noexcept
+    {
+        return linear() * d;
+    }
+
+    constexpr Matrix4 transposed() const noexcept
+    {
+        Matrix4 M;
+        for (unsigned r = 0; r < 4; ++r)
+        {
+            for (unsigned c = 0; c < 4; ++c)
+            {
+                M._m[r][c] = _m[c][r];
+            }
+        }
+        return M;
+    }
+
+    constexpr Scalar determinant() const noexcept
+    {
+        const auto& m = _m;
+
+        // 2x2 minors of the two bottom rows
+        const Scalar s0 = m[2][0] * m[3][1] - m[2][1] * m[3][0];
+        const Scalar s1 = m[2][0] * m[3][2] - m[2][2] * m[3][0];
+        const Scalar s2 = m[2][0] * m[3][3] - m[2][3] * m[3][0];
+        const Scalar s3 = m[2][1] * m[3][2] - m[2][2] * m[3][1];
+        const Scalar s4 = m[2][1] * m[3][3] - m[2][3] * m[3][1];
+        const Scalar s5 = m[2][2] * m[3][3] - m[2][3] * m[3][2];
+
+        return m[0][0] * (m[1][1] * s5 - m[1][2] * s4 + m[1][3] * s3)
+             - m[0][1] * (m[1][0] * s5 - m[1][2] * s2 + m[1][3] * s1)
+             + m[0][2] * (m[1][0] * s4 - m[1][1] * s2 + m[1][3] * s0)
+             - m[0][3] * (m[1][0] * s3 - m[1][1] * s1 + m[1][2] * s0);
+    }
+
+    /**
+     * General inverse, through the adjugate.
+     * Singular matrices give non-finite elements.
+     */
+    constexpr Matrix4 inverse() const noexcept
+    {
+        const auto& m = _m;
+
+        // 2x2 minors of the two top rows (s) and of the two bottom rows (c)
+        const Scalar s0 = m[0][0] * m[1][1] - m[1][0] * m[0][1];
+        const Scalar s1 = m[0][0] * m[1][2] - m[1][0] * m[0][2];
+        const Scalar s2 = m[0][0] * m[1][3] - m[1][0] * m[0][3];
+        const Scalar s3 = m[0][1] * m[1][2] - m[1][1] * m[0][2];
+        const Scalar s4 = m[0][1] * m[1][3] - m[1][1] * m[0][3];
+        const Scalar s5 = m[0][2] * m[1][3] - m[1][2] * m[0][3];
+
+        const Scalar c5 = m[2][2] * m[3][3] - m[3][2] * m[2][3];
+        const Scalar c4 = m[2][1] * m[3][3] - m[3][1] * m[2][3];
+        const Scalar c3 = m[2][1] * m[3][2] - m[3][1] * m[2][2];
+        const Scalar c2 = m[2][0] * m[3][3] - m[3][0] * m[2][3];
+        const Scalar c1 = m[2][0] * m[3][2] - m[3][0] * m[2][2];
+        const Scalar c0 = m[2][0] * m[3][1] - m[3][0] * m[2][1];
+
+        const Scalar det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+        const Scalar k = 1 / det;
+
+        Matrix4 I;
+        auto& r = I._m;
+        r[0][0] = ( m[1][1] * c5 - m[1][2] * c4 + m[1][3] * c3) * k;
+        r[0][1] = (-m[0][1] * c5 + m[0][2] * c4 - m[0][3] * c3) * k;
+        r[0][2] = ( m[3][1] * s5 - m[3][2] * s4 + m[3][3] * s3) * k;
+        r[0][3] = (-m[2][1] * s5 + m[2][2] * s4 - m[2][3] * s3) * k;
+
+        r[1][0] = (-m[1][0] * c5 + m[1][2] * c2 - m[1][3] * c1) * k;
+        r[1][1] = ( m[0][0] * c5 - m[0][2] * c2 + m[0][3] * c1) * k;
+        r[1][2] = (-m[3][0] * s5 + m[3][2] * s2 - m[3][3] * s1) * k;
+        r[1][3] = ( m[2][0] * s5 - m[2][2] * s2 + m[2][3] * s1) * k;
+
+        r[2][0] = ( m[1][0] * c4 - m[1][1] * c2 + m[1][3] * c0) * k;
+        r[2][1] = (-m[0][0] * c4 + m[0][1] * c2 - m[0][3] * c0) * k;
+        r[2][2] = ( m[3][0] * s4 - m[3][1] * s2 + m[3][3] * s0) * k;
+        r[2][3] = (-m[2][0] * s4 + m[2][1] * s2 - m[2][3] * s0) * k;
+
+        r[3][0] = (-m[1][0] * c3 + m[1][1] * c1 - m[1][2] * c0) * k;
+        r[3][1] = ( m[0][0] * c3 - m[0][1] * c1 + m[0][2] * c0) * k;
+        r[3][2] = (-m[3][0] * s3 + m[3][1] * s1 - m[3][2] * s0) * k;
+        r[3][3] = ( m[2][0] * s3 - m[2][1] * s1 + m[2][2] * s0) * k;
+        return I;
+    }
+};
+
+} // namespace gfx
+
+constexpr gfx::Matrix4 operator*(const gfx::Scalar k, const gfx::Matrix4& M) noexcept
+{
+    return M * k;
+}
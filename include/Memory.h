@@ -0,0 +1,154 @@
+#pragma once
+
+#include "gfx.h"
+
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+#include <span>
+
+namespace gfx
+{
+
+/**
+ * Bump allocator for memory that lives until the next reset(), typically a frame of work:
+ * allocating is moving a pointer, deallocating does nothing.
+ *
+ * Allocations that do not fit in the buffer come from upstream, in chunks at least as large as it,
+ * and reset() then replaces the buffer with one as large as everything allocated since the last reset,
+ * so a loop doing the same work every frame stops allocating after its first frame.
+ * Not thread-safe, see LockedResource.
+ */
+class GFX_API LinearArena : public std::pmr::memory_resource
+{
+private:
+    struct Chunk;
+
+    std::pmr::memory_resource* _upstream;
+    // Owned unless given to the constructor
+    std::byte* _buffer;
+    std::size_t _capacity;
+    bool _owned;
+
+    // Where the next allocation goes, in the buffer or in the last chunk
+    std::byte* _next;
+    std::byte* _end;
+    // From upstream since the last reset, most recent first
+    Chunk* _chunks;
+    std::size_t _chunk_bytes;
+
+public:
+    /**
+     * @param capacity Bytes of the first buffer, allocated from upstream.
+     */
+    explicit LinearArena(std::size_t capacity = 0, std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+
+    /**
+     * Allocate from buffer first, which must outlive the arena.
+     */
+    explicit LinearArena(std::span<std::byte> buffer, std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) noexcept;
+
+    ~LinearArena() override;
+
+    LinearArena(const LinearArena&) = delete;
+    LinearArena& operator=(const LinearArena&) = delete;
+
+    /**
+     * Free everything at once: previous allocations must not be used anymore.
+     */
+    void reset();
+
+    /** Bytes of the buffer, chunks aside. */
+    std::size_t capacity() const noexcept { return _capacity; }
+
+    /** Bytes allocated from upstream since the last reset, beyond the buffer. */
+    std::size_t overflow() const noexcept { return _chunk_bytes; }
+
+    std::pmr::memory_resource* upstream() const noexcept { return _upstream; }
+
+private:
+    void release_chunks() noexcept;
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+};
+
+/**
+ * Allocator of blocks of a fixed size, e.g. for nodes or per-query buffers of a known size:
+ * freed blocks go to a free list and are handed out again, so both operations are a few instructions.
+ *
+ * Blocks are carved from chunks of upstream memory, only released with the pool.
+ * Larger or more aligned requests go to upstream directly.
+ * Not thread-safe, see LockedResource.
+ */
+class GFX_API BlockPool : public std::pmr::memory_resource
+{
+private:
+    struct Chunk;
+
+    std::pmr::memory_resource* _upstream;
+    std::size_t _block_size;
+    std::size_t _blocks_per_chunk;
+    void* _free;
+    Chunk* _chunks;
+
+public:
+    /** Alignment of the blocks. */
+    static constexpr std::size_t alignment = alignof(std::max_align_t);
+
+    /**
+     * @param block_size Largest allocation served by the pool, rounded up to a multiple of alignment.
+     */
+    explicit BlockPool(
+        std::size_t block_size,
+        std::size_t blocks_per_chunk = 64,
+        std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+
+    ~BlockPool() override;
+
+    BlockPool(const BlockPool&) = delete;
+    BlockPool& operator=(const BlockPool&) = delete;
+
+    std::size_t block_size() const noexcept { return _block_size; }
+
+    /**
+     * Allocate chunks until at least blocks are free, e.g. before a frame loop.
+     */
+    void reserve(std::size_t blocks);
+
+    std::pmr::memory_resource* upstream() const noexcept { return _upstream; }
+
+private:
+    void add_chunk(std::size_t blocks);
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+};
+
+/**
+ * Serializes the use of another resource with a mutex,
+ * e.g. to share a LinearArena between the threads of a ThreadPool.
+ */
+class GFX_API LockedResource : public std::pmr::memory_resource
+{
+private:
+    std::pmr::memory_resource* _upstream;
+    std::mutex _mutex;
+
+public:
+    explicit LockedResource(std::pmr::memory_resource* upstream) noexcept
+        : _upstream(upstream)
+    {
+    }
+
+    std::pmr::memory_resource* upstream() const noexcept { return _upstream; }
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+};
+
+} // namespace gfx
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Scalar.h"
+#include "Sphere.h"
+#include "Vector3.h"
+
+#include <cmath>
+
+namespace gfx
+{
+
+/**
+ * Points p such that normal · p + distance = 0, the normal pointing to the positive side.
+ * With a unit normal, the signed distance of a point to the plane is normal · p + distance.
+ */
+template <typename T>
+struct BasicPlane
+{
+    using Scalar = T;
+    using Vector3 = BasicVector3<T>;
+    using Sphere = BasicSphere<T>;
+
+    Vector3 normal;
+    Scalar distance;
+
+    /**
+     * Plane through point, facing normal.
+     */
+    static constexpr BasicPlane through(const Vector3& point, const Vector3& normal) noexcept
+    {
+        const Vector3 n = normal.normalized();
+        return { n, -n.dot(point) };
+    }
+
+    template <typename U>
+    constexpr BasicPlane<U> cast() const noexcept
+    {
+        return { normal.template cast<U>(), U(distance) };
+    }
+
+    /**
+     * Same plane with a unit normal.
+     */
+    constexpr BasicPlane normalized() const noexcept
+    {
+        const Scalar k = 1 / normal.norm();
+        return { normal * k, distance * k };
+    }
+
+    constexpr Scalar signed_distance(const Vector3& p) const noexcept
+    {
+        return normal.dot(p) + distance;
+    }
+
+    /**
+     * Whether some of s is on the positive side, with a unit normal.
+     */
+    constexpr bool reaches(const Sphere& s) const noexcept
+    {
+        return signed_distance(s.center) >= -std::abs(s.radius);
+    }
+};
+
+using Plane = BasicPlane<Scalar>;
+using Planed = BasicPlane<double>;
+
+} // namespace gfx
@@ -3,58 +3,71 @@
 #include "Scalar.h"
 #include "Vector3.h"
 
+#include <cmath>
+#include <type_traits>
+
 namespace gfx
 {
 
-struct Quaternion;
-constexpr bool are_equal(const Quaternion& p, const Quaternion& q, const Scalar ε) noexcept;
+/** Largest error of the squared norm that Quaternion::renormalized corrects, leaving less than 1e-6. */
+inline constexpr const Scalar RENORMALIZE_LIMIT = 1e-3f;
 
-struct Quaternion
+template <typename T>
+struct BasicQuaternion
 {
+    using Scalar = T;
+    using Vector3 = BasicVector3<T>;
+
     Vector3 imaginary;
     Scalar real;
 
-    static constexpr Quaternion i() noexcept { return { .imaginary = { .x = 1 } }; }
-    static constexpr Quaternion j() noexcept { return { .imaginary = { .y = 1 } }; }
-    static constexpr Quaternion k() noexcept { return { .imaginary = { .z = 1 } }; }
+    static constexpr BasicQuaternion i() noexcept { return { .imaginary = { .x = 1 } }; }
+    static constexpr BasicQuaternion j() noexcept { return { .imaginary = { .y = 1 } }; }
+    static constexpr BasicQuaternion k() noexcept { return { .imaginary = { .z = 1 } }; }
 
     constexpr Scalar x() const noexcept { return imaginary.x; }
     constexpr Scalar y() const noexcept { return imaginary.y; }
     constexpr Scalar z() const noexcept { return imaginary.z; }
     constexpr Scalar w() const noexcept { return real; }
 
-    constexpr Quaternion with_imaginary(const Vector3& new_imaginary) const noexcept
+    template <typename U>
+    constexpr BasicQuaternion<U> cast() const noexcept
+    {
+        return { imaginary.template cast<U>(), U(real) };
+    }
+
+    constexpr BasicQuaternion with_imaginary(const Vector3& new_imaginary) const noexcept
     {
         return { new_imaginary, real };
     }
 
-    constexpr Quaternion with_real(const Scalar new_real) const noexcept
+    constexpr BasicQuaternion with_real(const Scalar new_real) const noexcept
     {
         return { imaginary, new_real };
     }
 
 
-    constexpr Quaternion operator*(const Scalar k) const noexcept
+    constexpr BasicQuaternion operator*(const Scalar k) const noexcept
     {
         return { imaginary * k, real * k };
     }
 
-    constexpr Quaternion operator-() const noexcept
+    constexpr BasicQuaternion operator-() const noexcept
     {
         return { -imaginary, -real };
     }
 
-    constexpr Quaternion operator+(const Quaternion& q) const noexcept
+    constexpr BasicQuaternion operator+(const BasicQuaternion& q) const noexcept
     {
         return { imaginary + q.imaginary, real + q.real };
     }
 
-    constexpr Quaternion operator-(const Quaternion& q) const noexcept
+    constexpr BasicQuaternion operator-(const BasicQuaternion& q) const noexcept
     {
         return { imaginary - q.imaginary, real - q.real };
     }
 
-    constexpr Quaternion operator*(const Quaternion& q) const noexcept
+    constexpr BasicQuaternion operator*(const BasicQuaternion& q) const noexcept
     {
         const Vector3 v = imaginary;
         const Scalar  d = real;
@@ -68,12 +81,12 @@ struct Quaternion
         };
     }
 
-    constexpr bool operator==(const Quaternion& q) const noexcept
+    constexpr bool operator==(const BasicQuaternion& q) const noexcept
     {
         return are_equal(*this, q);
     }
 
-    constexpr Quaternion& operator*=(const Scalar k) noexcept
+    constexpr BasicQuaternion& operator*=(const Scalar k) noexcept
     {
         imaginary *= k;
         real *= k;
@@ -81,12 +94,12 @@ struct Quaternion
     }
 
 
-    constexpr Scalar dot(const Quaternion& q) const noexcept
+    constexpr Scalar dot(const BasicQuaternion& q) const noexcept
     {
         return imaginary.dot(q.imaginary) + real * q.real;
     }
 
-    constexpr Quaternion conjugated() const noexcept
+    constexpr BasicQuaternion conjugated() const noexcept
     { 
         return with_imaginary(-imaginary);
     }
@@ -96,14 +109,26 @@ struct Quaternion
         return imaginary.squared_norm() + real * real;
     }
 
+    template <typename Math = PreciseMath>
     constexpr Scalar norm() const noexcept
     {
-        return std::sqrt(squared_norm());
+        return Math::sqrt(squared_norm());
+    }
+
+    template <typename Math = PreciseMath>
+    constexpr BasicQuaternion normalized() const noexcept
+    {
+        return *this * Math::rsqrt(squared_norm());
     }
 
-    constexpr Quaternion normalized() const noexcept
+    /**
+     * Nearly unit quaternion, e.g. a product of rotations, brought back to unit length without a square root:
+     * one Newton step of 1 / √x from 1 scales it by (3 - |q|²) / 2,
+     * which turns an error ε of the squared norm into about ¾ ε², see RENORMALIZE_LIMIT.
+     */
+    constexpr BasicQuaternion renormalized() const noexcept
     {
-        return *this * (1 / norm());
+        return *this * ((3 - squared_norm()) / 2);
     }
 
     constexpr bool is_rotation() const noexcept
@@ -111,49 +136,62 @@ struct Quaternion
         return are_equal<Scalar>(squared_norm(), 1);
     }
 
-    constexpr Quaternion inverse() const noexcept
+    constexpr BasicQuaternion inverse() const noexcept
     {
         return conjugated() * (1 / squared_norm());
     }
 
 
-    constexpr Quaternion& conjugate() noexcept
+    constexpr BasicQuaternion& conjugate() noexcept
     {
         imaginary *= -1;
         return *this;
     }
 
-    constexpr Quaternion& normalize() noexcept
+    template <typename Math = PreciseMath>
+    constexpr BasicQuaternion& normalize() noexcept
+    {
+        return *this *= Math::rsqrt(squared_norm());
+    }
+
+    constexpr BasicQuaternion& renormalize() noexcept
     {
-        return *this *= 1 / norm();
+        return *this *= (3 - squared_norm()) / 2;
     }
 
-    constexpr Quaternion& invert() noexcept
+    constexpr BasicQuaternion& invert() noexcept
     {
         return conjugate() *= (1 / squared_norm());
     }
 };
 
-constexpr bool are_equal(const Quaternion& p, const Quaternion& q, const Scalar ε) noexcept
+template <typename T>
+constexpr bool are_equal(const BasicQuaternion<T>& p, const BasicQuaternion<T>& q, const std::type_identity_t<T> ε) noexcept
 {
     return are_equal(p.imaginary, q.imaginary, ε)
         && are_equal(p.real, q.real, ε);
 }
 
-constexpr Scalar dot(const Quaternion& p, const Quaternion& q) noexcept
+template <typename T>
+constexpr T dot(const BasicQuaternion<T>& p, const BasicQuaternion<T>& q) noexcept
 {
     return p.dot(q);
 }
 
-constexpr Scalar distance(const Quaternion& p, const Quaternion& q) noexcept
+template <typename T>
+constexpr T distance(const BasicQuaternion<T>& p, const BasicQuaternion<T>& q) noexcept
 {
     return dot(p, q);
 }
 
+using Quaternion = BasicQuaternion<Scalar>;
+using Quaterniond = BasicQuaternion<double>;
+
 } // namespace gfx
 
 // Scaling commutative closure (k q = q k)
-constexpr gfx::Quaternion operator*(const gfx::Scalar k, const gfx::Quaternion& q) noexcept
+template <typename T>
+constexpr gfx::BasicQuaternion<T> operator*(const std::type_identity_t<T> k, const gfx::BasicQuaternion<T>& q) noexcept
 {
     return q * k;
 }
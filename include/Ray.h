@@ -1,33 +1,54 @@
 #pragma once
 
+#include "Hit.h"
+#include "Scalar.h"
 #include "Sphere.h"
+#include "Triangle.h"
 #include "Vector3.h"
 
+#include <cmath>
+#include <cstdint>
+#include <span>
+
 namespace gfx
 {
 
-class Ray
+template <typename T>
+class BasicRay
 {
+public:
+    using Scalar = T;
+    using Vector3 = BasicVector3<T>;
+    using Sphere = BasicSphere<T>;
+    using Triangle = BasicTriangle<T>;
+    using Hit = BasicHit<T>;
+
 private:
     Vector3 _start;
     Vector3 _dir;
 
 public:
-    constexpr Ray() noexcept
+    constexpr BasicRay() noexcept
         : _start(Vector3::origin())
         , _dir(Vector3::zero())
     {
     }
 
-    constexpr Ray(const Vector3& start, const Vector3& dir) noexcept
+    constexpr BasicRay(const Vector3& start, const Vector3& dir) noexcept
         : _start(start)
         , _dir(dir.normalized())
     {
     }
 
+    template <typename U>
+    constexpr BasicRay<U> cast() const noexcept
+    {
+        return { _start.template cast<U>(), _dir.template cast<U>() };
+    }
+
     constexpr const Vector3& start() const noexcept { return _start; }
     constexpr Vector3& start() noexcept { return _start; }
-    constexpr Ray& start(const Vector3& start) noexcept
+    constexpr BasicRay& start(const Vector3& start) noexcept
     {
         _start = start.normalized();
         return *this;
@@ -35,12 +56,23 @@ public:
 
     constexpr const Vector3& dir() const noexcept { return _dir; }
     constexpr Vector3& dir() noexcept { return _dir; }
-    constexpr Ray& dir(const Vector3& dir) noexcept
+    constexpr BasicRay& dir(const Vector3& dir) noexcept
     {
         _dir = dir.normalized();
         return *this;
     }
 
+    /**
+     * Point at distance t along the ray.
+     */
+    constexpr Vector3 at(const Scalar t) const noexcept
+    {
+        return _start + t * _dir;
+    }
+
+    /**
+     * Near intersection point with s, or Vector3::infinity() if s is missed or behind.
+     */
     constexpr Vector3 intersect(const Sphere& s) const noexcept
     {
         const Vector3 G = _start;
@@ -61,6 +93,179 @@ public:
 
         return G + k * d;
     }
+
+    /**
+     * Distance to the first crossing of the surface of s within [t_min, t_max], or infinity.
+     * That is the far side of s when the near one is before t_min, e.g. for rays starting inside.
+     */
+    constexpr Scalar hit_distance(const Sphere& s, const Scalar t_min = 0, const Scalar t_max = INFINITY) const noexcept
+    {
+        // Same equation as intersect
+        const Vector3 GC = _start - s.center;
+        const Scalar a = _dir.squared_norm();
+        const Scalar b = dot(GC, _dir);
+        const Scalar c = GC.squared_norm() - s.radius * s.radius;
+
+        const Scalar delta = b * b - a * c;
+        if (delta < 0) return INFINITY;
+
+        const Scalar root = std::sqrt(delta);
+        Scalar t = ( -b - root ) / a;
+        if (t < t_min) t = ( -b + root ) / a;
+        return t >= t_min && t <= t_max ? t : INFINITY;
+    }
+
+    /**
+     * Hit record of the first crossing of the surface of s within [t_min, t_max], see hit_distance.
+     * The primitive of a hit is 0.
+     */
+    constexpr Hit closest_hit(const Sphere& s, const Scalar t_min = 0, const Scalar t_max = INFINITY) const noexcept
+    {
+        const Scalar t = hit_distance(s, t_min, t_max);
+        if (std::isinf(t)) return {};
+
+        const Vector3 p = at(t);
+        return { t, p, (p - s.center) * (1 / std::abs(s.radius)), 0 };
+    }
+
+    /**
+     * Closest of the spheres hit within [t_min, t_max], with its index as primitive.
+     */
+    constexpr Hit closest_hit(const std::span<const Sphere> spheres, const Scalar t_min = 0, const Scalar t_max = INFINITY) const noexcept
+    {
+        Scalar closest = t_max;
+        std::uint32_t index = no_hit;
+        for (std::size_t i = 0; i < spheres.size(); ++i)
+        {
+            const Scalar t = hit_distance(spheres[i], t_min, closest);
+            if (!std::isinf(t))
+            {
+                closest = t;
+                index = std::uint32_t(i);
+            }
+        }
+        if (index == no_hit) return {};
+
+        Hit hit = closest_hit(spheres[index], t_min, t_max);
+        hit.primitive = index;
+        return hit;
+    }
+
+    /**
+     * Whether closest_hit would find a hit, e.g. for shadow rays,
+     * without the square root, division and hit point.
+     */
+    constexpr bool any_hit(const Sphere& s, const Scalar t_min = 0, const Scalar t_max = INFINITY) const noexcept
+    {
+        const Vector3 GC = _start - s.center;
+        const Scalar a = _dir.squared_norm();
+        const Scalar b = dot(GC, _dir);
+        const Scalar c = GC.squared_norm() - s.radius * s.radius;
+
+        // Misses the whole line, the common case
+        if (b * b < a * c) return false;
+
+        // f(t) = a t^2 + 2 b t + c is negative inside s: the surface is crossed
+        // if f changes sign over the range, or is positive at both ends with its minimum,
+        // at t = -b / a, in the range
+        const auto f = [&](const Scalar t) { return (a * t + 2 * b) * t + c; };
+        const bool min_inside = f(t_min) <= 0;
+        const bool max_inside = f(t_max) <= 0;
+        const bool dips = !min_inside & (a * t_min < -b) & (-b < a * t_max);
+        return (min_inside != max_inside) | dips;
+    }
+
+    /**
+     * Whether any of the spheres is hit within [t_min, t_max], stopping at the first one found.
+     */
+    constexpr bool any_hit(const std::span<const Sphere> spheres, const Scalar t_min = 0, const Scalar t_max = INFINITY) const noexcept
+    {
+        for (const Sphere& s : spheres)
+        {
+            if (any_hit(s, t_min, t_max)) return true;
+        }
+        return false;
+    }
+
+    /**
+     * Distance to the crossing of either face of triangle within [t_min, t_max], or infinity.
+     * Solves start + t dir = a + u (b - a) + v (c - a) by Cramer's rule,
+     * the determinants being triple products that share their cross products.
+     * Tomas Möller and Ben Trumbore, 1997, Fast, Minimum Storage Ray/Triangle Intersection
+     * https://doi.org/10.1080/10867651.1997.10487468
+     */
+    constexpr Scalar hit_distance(const Triangle& triangle, const Scalar t_min = 0, const Scalar t_max = INFINITY) const noexcept
+    {
+        const Vector3 e1 = triangle.b - triangle.a;
+        const Vector3 e2 = triangle.c - triangle.a;
+        const Vector3 p = _dir.cross(e2);
+        const Scalar det = e1.dot(p);
+        // Parallel to the plane of the triangle, or degenerate triangle
+        if (det == 0) return INFINITY;
+
+        const Scalar inv_det = 1 / det;
+        const Vector3 s = _start - triangle.a;
+        const Scalar u = s.dot(p) * inv_det;
+        if (u < 0 || u > 1) return INFINITY;
+
+        const Vector3 q = s.cross(e1);
+        const Scalar v = _dir.dot(q) * inv_det;
+        if (v < 0 || u + v > 1) return INFINITY;
+
+        const Scalar t = e2.dot(q) * inv_det;
+        return t >= t_min && t <= t_max ? t : INFINITY;
+    }
+
+    /**
+     * Hit record of triangle within [t_min, t_max], see hit_distance.
+     * The normal is the one of the front face, whichever face is hit, and the primitive 0.
+     */
+    constexpr Hit closest_hit(const Triangle& triangle, const Scalar t_min = 0, const Scalar t_max = INFINITY) const noexcept
+    {
+        const Scalar t = hit_distance(triangle, t_min, t_max);
+        if (std::isinf(t)) return {};
+        return { t, at(t), triangle.normal(), 0 };
+    }
+
+    /**
+     * Closest of the triangles hit within [t_min, t_max], with its index as primitive.
+     */
+    constexpr Hit closest_hit(const std::span<const Triangle> triangles, const Scalar t_min = 0, const Scalar t_max = INFINITY) const noexcept
+    {
+        Scalar closest = t_max;
+        std::uint32_t index = no_hit;
+        for (std::size_t i = 0; i < triangles.size(); ++i)
+        {
+            const Scalar t = hit_distance(triangles[i], t_min, closest);
+            if (!std::isinf(t))
+            {
+                closest = t;
+                index = std::uint32_t(i);
+            }
+        }
+        if (index == no_hit) return {};
+        return { closest, at(closest), triangles[index].normal(), index };
+    }
+
+    constexpr bool any_hit(const Triangle& triangle, const Scalar t_min = 0, const Scalar t_max = INFINITY) const noexcept
+    {
+        return !std::isinf(hit_distance(triangle, t_min, t_max));
+    }
+
+    /**
+     * Whether any of the triangles is hit within [t_min, t_max], stopping at the first one found.
+     */
+    constexpr bool any_hit(const std::span<const Triangle> triangles, const Scalar t_min = 0, const Scalar t_max = INFINITY) const noexcept
+    {
+        for (const Triangle& triangle : triangles)
+        {
+            if (any_hit(triangle, t_min, t_max)) return true;
+        }
+        return false;
+    }
 };
 
+using Ray = BasicRay<Scalar>;
+using Rayd = BasicRay<double>;
+
 } // namespace gfx
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "gfx.h"
+#include "Hit.h"
+#include "Ray.h"
+#include "Scalar.h"
+#include "Sphere.h"
+#include "Vector3.h"
+#include "Vector3Batch.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace gfx
+{
+
+/**
+ * Closest hits of a stream of rays against a set of spheres,
+ * solving the same equation as Ray::intersect with the SIMD kernels (see Simd.h).
+ *
+ * @param t      Distance along each ray to its closest hit, infinity on a miss.
+ * @param sphere Index of the sphere hit by each ray, or no_hit.
+ */
+GFX_API void intersect(
+    ConstVector3Span starts,
+    ConstVector3Span dirs,
+    std::span<const Sphere> spheres,
+    std::span<Scalar> t,
+    std::span<std::uint32_t> sphere) noexcept;
+
+
+/**
+ * Per-lane result of a RayPacket query.
+ */
+template <std::size_t N>
+struct PacketHit
+{
+    Scalar t[N];
+    std::uint32_t sphere[N];
+    // Bit i set if lane i hit something
+    std::uint32_t mask;
+
+    constexpr bool hit(const std::size_t lane) const noexcept { return mask >> lane & 1; }
+};
+
+/**
+ * N coherent rays, stored as structure of arrays to be traced together.
+ */
+template <std::size_t N>
+class RayPacket
+{
+    static_assert(N == 4 || N == 8 || N == 16, "Packets hold 4, 8 or 16 rays");
+
+private:
+    alignas(64) Scalar _start[3][N];
+    alignas(64) Scalar _dir[3][N];
+
+public:
+    static constexpr std::size_t size = N;
+
+    constexpr RayPacket() noexcept
+        : _start {}
+        , _dir {}
+    {
+    }
+
+    constexpr explicit RayPacket(const std::span<const Ray, N> rays) noexcept
+        : RayPacket()
+    {
+        for (std::size_t i = 0; i < N; ++i) set(i, rays[i]);
+    }
+
+    constexpr void set(const std::size_t lane, const Ray& ray) noexcept
+    {
+        const Vector3& G = ray.start();
+        const Vector3& d = ray.dir();
+        _start[0][lane] = G.x; _start[1][lane] = G.y; _start[2][lane] = G.z;
+        _dir[0][lane]   = d.x; _dir[1][lane]   = d.y; _dir[2][lane]   = d.z;
+    }
+
+    constexpr Vector3 start(const std::size_t lane) const noexcept
+    {
+        return { _start[0][lane], _start[1][lane], _start[2][lane] };
+    }
+
+    constexpr Vector3 dir(const std::size_t lane) const noexcept
+    {
+        return { _dir[0][lane], _dir[1][lane], _dir[2][lane] };
+    }
+
+    constexpr ConstVector3Span starts() const noexcept { return { _start[0], _start[1], _start[2], N }; }
+    constexpr ConstVector3Span dirs() const noexcept { return { _dir[0], _dir[1], _dir[2], N }; }
+
+    /**
+     * Point at distance t along the ray of a lane.
+     */
+    constexpr Vector3 at(const std::size_t lane, const Scalar t) const noexcept
+    {
+        return start(lane) + t * dir(lane);
+    }
+
+    PacketHit<N> intersect(const std::span<const Sphere> spheres) const noexcept
+    {
+        PacketHit<N> hit;
+        gfx::intersect(starts(), dirs(), spheres, hit.t, hit.sphere);
+
+        hit.mask = 0;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            if (hit.sphere[i] != no_hit) hit.mask |= std::uint32_t(1) << i;
+        }
+        return hit;
+    }
+
+    PacketHit<N> intersect(const Sphere& s) const noexcept
+    {
+        return intersect(std::span<const Sphere>(&s, 1));
+    }
+};
+
+using RayPacket4 = RayPacket<4>;
+using RayPacket8 = RayPacket<8>;
+using RayPacket16 = RayPacket<16>;
+
+} // namespace gfx
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "gfx.h"
+#include "Bvh.h"
+#include "Camera.h"
+#include "Image.h"
+#include "Sphere.h"
+#include "ThreadPool.h"
+#include "Vector3.h"
+
+#include <vector>
+
+namespace gfx
+{
+
+/**
+ * Spheres to render, together with the hierarchy used to trace them.
+ */
+struct Scene
+{
+    std::vector<Sphere> spheres;
+    Bvh bvh;
+
+    Scene() = default;
+    explicit Scene(std::vector<Sphere> spheres);
+};
+
+struct RenderOptions
+{
+    unsigned width = 640;
+    unsigned height = 480;
+    // Side of the square tiles scheduled on the thread pool
+    unsigned tile_size = 32;
+    // Towards the light, does not need to be normalized
+    Vector3 light = { -0.4f, 0.8f, -0.45f };
+    Vector3 background = { 0.05f, 0.06f, 0.09f };
+    Scalar ambient = 0.15f;
+    bool shadows = true;
+};
+
+/**
+ * Ray cast the scene: one primary ray per pixel, shaded with a directional light
+ * and, optionally, one shadow ray per hit.
+ * Tiles are spread over the pool workers, which steal from each other when they run out.
+ */
+GFX_API Image render(
+    const Camera& camera,
+    const Scene& scene,
+    const RenderOptions& options = {},
+    ThreadPool& pool = ThreadPool::shared());
+
+} // namespace gfx
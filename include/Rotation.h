@@ -1,78 +1,297 @@
 #pragma once
 
+#include "EulerOrder.h"
+#include "MathPolicy.h"
 #include "Matrix3.h"
 #include "Quaternion.h"
 #include "Scalar.h"
 #include "Vector3.h"
 
 #include <cmath>
+#include <type_traits>
 
 namespace gfx
 {
 
-class Rotation
+/** Largest angle in radians between Rotation::fast_slerp and Rotation::slerp, for α in [0, 1]. */
+inline constexpr const Scalar FAST_SLERP_ERROR = 1e-3f;
+
+template <typename T>
+class BasicRotation
 {
+public:
+    using Scalar = T;
+    using Vector3 = BasicVector3<T>;
+    using Quaternion = BasicQuaternion<T>;
+    using Matrix3 = BasicMatrix3<T>;
+
 private:
+    template <typename U>
+    friend class BasicRotation;
+
     Quaternion _q;
 
-    constexpr Rotation(const Quaternion& q) noexcept
+    constexpr BasicRotation(const Quaternion& q) noexcept
         : _q(q)
     {
     }
 
 public:
-    constexpr Rotation() noexcept
+    constexpr BasicRotation() noexcept
         // Null rotation (around the null axis)
         : _q { Vector3::zero(), 1 }
     {
     }
 
-    static constexpr Rotation from_quaternion(const Quaternion& q) noexcept
+    template <typename Math = PreciseMath>
+    static constexpr BasicRotation from_quaternion(const Quaternion& q) noexcept
+    {
+        return q.template normalized<Math>();
+    }
+
+    /**
+     * From a quaternion that drifted from unit length by rounding, e.g. a long product of rotations:
+     * corrected without a square root by Quaternion::renormalized within RENORMALIZE_LIMIT,
+     * else normalized like from_quaternion.
+     */
+    template <typename Math = PreciseMath>
+    static constexpr BasicRotation from_drifted_quaternion(const Quaternion& q) noexcept
     {
-        return q.normalized();
+        const Scalar s = q.squared_norm();
+        return q * (std::abs(s - 1) <= RENORMALIZE_LIMIT ? (3 - s) / 2 : Math::rsqrt(s));
     }
 
-    static constexpr Rotation from_axis_angle(const Vector3& â, const Scalar α) noexcept
+    template <typename Math = PreciseMath>
+    static constexpr BasicRotation from_axis_angle(const Vector3& â, const Scalar α) noexcept
     {
-        return {{ â.normalized() * std::sin(α / 2), std::cos(α / 2) }};
+        return {{ â.template normalized<Math>() * Math::sin(α / 2), Math::cos(α / 2) }};
     }
 
-    static constexpr Rotation from_axis_angle_degrees(const Vector3& â, const Scalar α) noexcept
+    template <typename Math = PreciseMath>
+    static constexpr BasicRotation from_axis_angle_degrees(const Vector3& â, const Scalar α) noexcept
+    {
+        return from_axis_angle<Math>(â, radians<Scalar>(α));
+    }
+
+    /**
+     * Exponential of the pure quaternion (v, 0): the rotation around v by twice its norm, the inverse of log.
+     */
+    template <typename Math = PreciseMath>
+    static constexpr BasicRotation from_log(const Vector3& v) noexcept
     {
-        const Scalar α_radians = radians(α);
-        return {{ â.normalized() * std::sin(α_radians / 2), std::cos(α_radians / 2) }};
+        const Scalar θ = v.template norm<Math>();
+        if (θ == 0) return {};
+        return {{ v * (Math::sin(θ) / θ), Math::cos(θ) }};
     }
 
     /**
      * Construct rotation from a triple (x, y, z) of Euler angles.
      * Follow Unity's roll, pitch, yaw order (z, x, y).
      */
-    static constexpr Rotation from_euler(const Vector3& angles) noexcept
+    template <typename Math = PreciseMath>
+    static constexpr BasicRotation from_euler(const Vector3& angles) noexcept
     {
-        const Scalar α = angles.x;
-        const Scalar β = angles.y;
-        const Scalar γ = angles.z;
+        return from_euler<EulerOrder::zxy, Math>(angles);
+    }
 
-        const Rotation roll  = from_axis_angle(Vector3::forwards(), γ);
-        const Rotation pitch = from_axis_angle(Vector3::right(),    α);
-        const Rotation yaw   = from_axis_angle(Vector3::up(),       β);
+    /**
+     * Construct rotation from Euler angles in any order, see EulerOrder for the conventions.
+     * Evaluates the closed form of the product of the three rotations (see euler_product),
+     * instead of multiplying quaternions.
+     */
+    template <EulerOrder order, typename Math = PreciseMath>
+    static constexpr BasicRotation from_euler(const Vector3& angles) noexcept
+    {
+        constexpr const std::array<unsigned, 3>& components = EULER_ANGLE_COMPONENTS<order>;
+        constexpr const EulerProduct& product = EULER_PRODUCT<order>;
+
+        const Scalar half1 = angles.element(components[0] + 1) / 2;
+        const Scalar half2 = angles.element(components[1] + 1) / 2;
+        const Scalar half3 = angles.element(components[2] + 1) / 2;
+        const Scalar c1 = Math::cos(half1);
+        const Scalar s1 = Math::sin(half1);
+        const Scalar c2 = Math::cos(half2);
+        const Scalar s2 = Math::sin(half2);
+        const Scalar c3 = Math::cos(half3);
+        const Scalar s3 = Math::sin(half3);
+
+        // Indexed like EulerProduct::Term::sines
+        const Scalar products[8] = {
+            c1 * c2 * c3, s1 * c2 * c3, c1 * s2 * c3, s1 * s2 * c3,
+            c1 * c2 * s3, s1 * c2 * s3, c1 * s2 * s3, s1 * s2 * s3,
+        };
+        const auto component = [&](const unsigned i) {
+            const EulerProduct::Term& a = product.terms[i][0];
+            const EulerProduct::Term& b = product.terms[i][1];
+            return (a.sign > 0 ? products[a.sines] : -products[a.sines])
+                 + (b.sign > 0 ? products[b.sines] : -products[b.sines]);
+        };
+        return {{ { component(0), component(1), component(2) }, component(3) }};
+    }
 
-        return roll.then(pitch).then(yaw);
+    template <typename Math = PreciseMath>
+    static constexpr BasicRotation from_euler_degrees(const Vector3& angles) noexcept
+    {
+        return from_euler_degrees<EulerOrder::zxy, Math>(angles);
     }
 
-    static constexpr Rotation from_euler_degrees(const Vector3& angles) noexcept
+    template <EulerOrder order, typename Math = PreciseMath>
+    static constexpr BasicRotation from_euler_degrees(const Vector3& angles) noexcept
     {
         const Vector3 angles_radians = {
-            radians(angles.x),
-            radians(angles.y),
-            radians(angles.z),
+            radians<Scalar>(angles.x),
+            radians<Scalar>(angles.y),
+            radians<Scalar>(angles.z),
         };
-        return from_euler(angles_radians);
+        return from_euler<order, Math>(angles_radians);
     }
 
+    /**
+     * Rotation of an orthonormal matrix with determinant 1, e.g. from as_matrix3.
+     * Drifted matrices should be orthonormalized first, see Matrix3::orthonormalized.
+     *
+     * Picks the largest of 4w², 4x², 4y², 4z² from the trace and the diagonal,
+     * then the other components from the off-diagonal sums and differences,
+     * so that nothing gets divided by a small number.
+     * Stanley W. Shepperd, 1978, Quaternion from Rotation Matrix,
+     * Journal of Guidance and Control 1(3)
+     */
+    template <typename Math = PreciseMath>
+    static constexpr BasicRotation from_matrix3(const Matrix3& M) noexcept
+    {
+        const Scalar m11 = M(0, 0);
+        const Scalar m22 = M(1, 1);
+        const Scalar m33 = M(2, 2);
+
+        // 4w², 4x², 4y², 4z²
+        const Scalar w4 = 1 + m11 + m22 + m33;
+        const Scalar x4 = 1 + m11 - m22 - m33;
+        const Scalar y4 = 1 - m11 + m22 - m33;
+        const Scalar z4 = 1 - m11 - m22 + m33;
+
+        // 4 times the quaternion, times its largest component,
+        // normalized at the end instead of dividing by that component
+        Quaternion q;
+        if (w4 >= x4 && w4 >= y4 && w4 >= z4)
+        {
+            q = { { M(2, 1) - M(1, 2), M(0, 2) - M(2, 0), M(1, 0) - M(0, 1) }, w4 };
+        }
+        else if (x4 >= y4 && x4 >= z4)
+        {
+            q = { { x4, M(0, 1) + M(1, 0), M(0, 2) + M(2, 0) }, M(2, 1) - M(1, 2) };
+        }
+        else if (y4 >= z4)
+        {
+            q = { { M(0, 1) + M(1, 0), y4, M(1, 2) + M(2, 1) }, M(0, 2) - M(2, 0) };
+        }
+        else
+        {
+            q = { { M(0, 2) + M(2, 0), M(1, 2) + M(2, 1), z4 }, M(1, 0) - M(0, 1) };
+        }
+        return from_quaternion<Math>(q);
+    }
+
+
+    /**
+     * Same rotation in another precision.
+     */
+    template <typename U>
+    constexpr BasicRotation<U> cast() const noexcept
+    {
+        return { _q.template cast<U>() };
+    }
 
     constexpr const Quaternion& as_quaternion() const noexcept { return _q; }
 
+    /**
+     * Logarithm of the quaternion: the axis times half the angle, a norm in [0, π] (see from_log).
+     * Splines of rotations (see RotationSpline.h) work on the logarithms of the steps between keys.
+     */
+    constexpr Vector3 log() const noexcept
+    {
+        // atan2 rather than acos, which loses the small angles to the rounding of the real part
+        const Scalar s = _q.imaginary.norm();
+        if (s == 0) return Vector3::zero();
+        return _q.imaginary * (std::atan2(s, _q.real) / s);
+    }
+
+    /**
+     * Euler angles of the rotation, so that from_euler<order> gives it back (see EulerOrder).
+     * Angles are in [-π, π], the middle one in [-π/2, π/2] for Tait-Bryan orders
+     * and in [0, π] for proper Euler orders.
+     *
+     * In gimbal lock, when the middle angle makes the first and last axes line up,
+     * only their sum (or difference) is defined: the last angle is then 0.
+     *
+     * Evgeni Bernardes and Stéphane Viollet, 2022, Quaternion to Euler angles conversion:
+     * A direct, general and computationally efficient method
+     * https://doi.org/10.1371/journal.pone.0276302
+     */
+    template <EulerOrder order = EulerOrder::zxy>
+    constexpr Vector3 to_euler() const noexcept
+    {
+        constexpr std::array<unsigned, 3> axes = euler_axes(order);
+        constexpr bool proper = is_proper_euler(order);
+        constexpr unsigned i = axes[0];
+        constexpr unsigned j = axes[1];
+        // Third axis of Tait-Bryan orders, from the angles of the proper Euler order (i, j, i)
+        constexpr unsigned k = proper ? 3 - i - j : axes[2];
+        // +1 if (i, j, k) is an even permutation of (x, y, z), -1 otherwise
+        constexpr int sign = (int(i) - int(j)) * (int(j) - int(k)) * (int(k) - int(i)) / 2;
+
+        const Scalar q[4] = { _q.x(), _q.y(), _q.z(), _q.w() };
+        const Scalar a = proper ? q[3] : q[3] - q[j];
+        const Scalar b = proper ? q[i] : q[i] + q[k] * sign;
+        const Scalar c = proper ? q[j] : q[j] + q[3];
+        const Scalar d = proper ? q[k] * sign : q[k] * sign - q[i];
+
+        Scalar θ2 = 2 * std::atan2(std::sqrt(c * c + d * d), std::sqrt(a * a + b * b));
+        const Scalar half_sum = std::atan2(b, a);
+        const Scalar half_difference = std::atan2(d, c);
+
+        Scalar θ1;
+        Scalar θ3;
+        if (is_zero(θ2))
+        {
+            θ1 = 2 * half_sum;
+            θ3 = 0;
+        }
+        else if (is_zero(θ2 - Scalar(M_PI)))
+        {
+            θ1 = -2 * half_difference;
+            θ3 = 0;
+        }
+        else
+        {
+            θ1 = half_sum - half_difference;
+            θ3 = half_sum + half_difference;
+        }
+
+        if constexpr (!proper)
+        {
+            θ3 *= sign;
+            θ2 -= Scalar(M_PI / 2);
+        }
+
+        const auto wrap = [](const Scalar θ) {
+            return θ > Scalar(M_PI) ? θ - Scalar(2 * M_PI) : θ < -Scalar(M_PI) ? θ + Scalar(2 * M_PI) : θ;
+        };
+        const Scalar θ[3] = { wrap(θ1), wrap(θ2), wrap(θ3) };
+
+        // Back from the order of the rotations to the order of the angles
+        constexpr std::array<unsigned, 3> components = euler_angle_components(order);
+        Scalar angles[3] = {};
+        for (unsigned n = 0; n < 3; ++n) angles[components[n]] = θ[n];
+        return { angles[0], angles[1], angles[2] };
+    }
+
+    template <EulerOrder order = EulerOrder::zxy>
+    constexpr Vector3 to_euler_degrees() const noexcept
+    {
+        const Vector3 angles = to_euler<order>();
+        return { degrees<Scalar>(angles.x), degrees<Scalar>(angles.y), degrees<Scalar>(angles.z) };
+    }
+
     constexpr Matrix3 as_matrix3() const noexcept
     {
         const Scalar w = _q.w();
@@ -104,7 +323,8 @@ public:
     }
 
 
-    constexpr Rotation nlerp(const Rotation& rotation, const Scalar α) const noexcept
+    template <typename Math = PreciseMath>
+    constexpr BasicRotation nlerp(const BasicRotation& rotation, const Scalar α) const noexcept
     {
         const Quaternion& p = _q;
         Quaternion q = rotation._q;
@@ -112,24 +332,25 @@ public:
         // Take shortest path
         q = p.dot(q) < 0 ? -q : q;
 
-        return lerp(p, q, α).normalized();
+        return lerp(p, q, α).template normalized<Math>();
     }
 
-    constexpr Rotation slerp(const Rotation& rotation, const Scalar α) const noexcept
+    template <typename Math = PreciseMath>
+    constexpr BasicRotation slerp(const BasicRotation& rotation, const Scalar α) const noexcept
     {
         const Quaternion& q1 = _q;
         Quaternion q2 = rotation._q;
         const Scalar u = α;
 
         // Take shortest path
-        const Scalar dot = q1.dot(q2);
-        q2 = dot < 0 ? -q2 : q2;
+        const Scalar dot = std::abs(q1.dot(q2));
+        q2 = q1.dot(q2) < 0 ? -q2 : q2;
 
         // Use nlerp if rotations are too close, to minimize error
-        if (is_zero(dot)) return lerp(q1, q2, u).normalized();
+        if (are_equal(dot, Scalar(1))) return lerp(q1, q2, u).template normalized<Math>();
 
         // q1 dot q2 = cos θ, since q1 and q2 are rotations, having norm = 1
-        const Scalar θ = std::acos(dot);
+        const Scalar θ = Math::acos(dot);
 
         // Two distinct ways to compute Slerp, according to:
         // Ken Shoemake, 1985, Animating Rotation with Quaternion Curves, Section 3.3
@@ -146,16 +367,34 @@ public:
         //     +--------------------------------------------------+
         //
         // I choose option (2) to avoid defining the power of a quaternion.
-        const Scalar sin_θ = std::sin(θ);
+        const Scalar sin_θ = Math::sin(θ);
+
+        return Math::sin((1 - u) * θ) / sin_θ * q1
+             + Math::sin(u * θ)       / sin_θ * q2;
+    }
 
-        return std::sin((1 - u) * θ) / sin_θ * q1
-             + std::sin(u * θ)       / sin_θ * q2;
+    /**
+     * Approximation of slerp, at the cost of an nlerp: the parameter gets corrected
+     * by a polynomial fitted on cos θ, so the angular speed is nearly constant.
+     * Arseny Kapoulkine, 2015, Approximating slerp
+     * https://zeux.io/2015/07/23/approximating-slerp/
+     *
+     * The result is within FAST_SLERP_ERROR radians of slerp.
+     */
+    template <typename Math = PreciseMath>
+    constexpr BasicRotation fast_slerp(const BasicRotation& rotation, const Scalar α) const noexcept
+    {
+        const Scalar d = std::abs(_q.dot(rotation._q));
+        const Scalar A = 1.0904f + d * (-3.2452f + d * (3.55645f - d * 1.43519f));
+        const Scalar B = 0.848013f + d * (-1.06021f + d * 0.215638f);
+        const Scalar k = A * (α - 0.5f) * (α - 0.5f) + B;
+        return nlerp<Math>(rotation, α + α * (α - 0.5f) * (α - 1) * k);
     }
 
     /**
      * Combine with rotation, applying the current rotation first.
      */
-    constexpr Rotation then(const Rotation& rotation) const noexcept
+    constexpr BasicRotation then(const BasicRotation& rotation) const noexcept
     {
         return rotation._q * _q;
     }
@@ -180,39 +419,52 @@ public:
         return a * a * v + 2 * a * w.cross(v) + w.dot(v) * w - w.cross(v).cross(w);
     }
 
-    constexpr Rotation inverse() const noexcept
+    constexpr BasicRotation inverse() const noexcept
     {
         return _q.conjugated();
     }
 
 
-    constexpr Rotation& invert() noexcept
+    constexpr BasicRotation& invert() noexcept
     {
         _q.conjugate();
         return *this;
     }
 };
 
-constexpr bool are_equivalent(const Rotation& a, const Rotation& b, const Scalar ε) noexcept
+template <typename T>
+constexpr bool are_equivalent(const BasicRotation<T>& a, const BasicRotation<T>& b, const std::type_identity_t<T> ε) noexcept
 {
-    const Quaternion& qa = a.as_quaternion();
-    const Quaternion& qb = b.as_quaternion();
+    const BasicQuaternion<T>& qa = a.as_quaternion();
+    const BasicQuaternion<T>& qb = b.as_quaternion();
     return are_equal(qa, qb, ε) || are_equal(qa, -qb, ε);
 }
 
-constexpr bool are_equivalent(const Rotation& a, const Rotation& b) noexcept
+template <typename T>
+constexpr bool are_equivalent(const BasicRotation<T>& a, const BasicRotation<T>& b) noexcept
 {
-    return are_equivalent(a, b, EPSILON);
+    return are_equivalent(a, b, epsilon<T>);
 }
 
-constexpr Rotation nlerp(const Rotation& a, const Rotation& b, const Scalar α) noexcept
+template <typename Math = PreciseMath, typename T>
+constexpr BasicRotation<T> nlerp(const BasicRotation<T>& a, const BasicRotation<T>& b, const std::type_identity_t<T> α) noexcept
 {
-    return a.nlerp(b, α);
+    return a.template nlerp<Math>(b, α);
 }
 
-constexpr Rotation slerp(const Rotation& a, const Rotation& b, const Scalar α) noexcept
+template <typename Math = PreciseMath, typename T>
+constexpr BasicRotation<T> slerp(const BasicRotation<T>& a, const BasicRotation<T>& b, const std::type_identity_t<T> α) noexcept
 {
-    return a.slerp(b, α);
+    return a.template slerp<Math>(b, α);
 }
 
+template <typename Math = PreciseMath, typename T>
+constexpr BasicRotation<T> fast_slerp(const BasicRotation<T>& a, const BasicRotation<T>& b, const std::type_identity_t<T> α) noexcept
+{
+    return a.template fast_slerp<Math>(b, α);
+}
+
+using Rotation = BasicRotation<Scalar>;
+using Rotationd = BasicRotation<double>;
+
 } // namespace gfx
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "MathPolicy.h"
+#include "Quaternion.h"
+#include "Rotation.h"
+#include "Scalar.h"
+#include "Vector3.h"
+
+#include <cmath>
+#include <limits>
+
+namespace gfx
+{
+
+/**
+ * Running product of rotations, e.g. the orientation of a body over a simulation, normalized lazily.
+ *
+ * Products of unit quaternions only drift from unit length by rounding, a few ulps at a time:
+ * instead of normalizing after each of them, the accumulator adds up a bound of that drift,
+ * and only measures the norm once the bound crosses its tolerance.
+ * The quaternion then gets corrected without a square root (see Quaternion::renormalized)
+ * when within RENORMALIZE_LIMIT of unit length, else normalized.
+ */
+template <typename T>
+class BasicRotationAccumulator
+{
+public:
+    using Scalar = T;
+    using Vector3 = BasicVector3<T>;
+    using Quaternion = BasicQuaternion<T>;
+    using Rotation = BasicRotation<T>;
+
+    /** Bound of the drift of the squared norm added by one product of unit quaternions. */
+    static constexpr Scalar PRODUCT_DRIFT = 8 * std::numeric_limits<T>::epsilon();
+
+private:
+    Quaternion _q;
+    // Bound of ||_q|² - 1|
+    Scalar _drift;
+    Scalar _tolerance;
+
+public:
+    /**
+     * @param tolerance Largest drift of the squared norm to let through,
+     *                  epsilon by default, so that Quaternion::is_rotation holds.
+     */
+    constexpr explicit BasicRotationAccumulator(const Rotation& rotation = {}, const Scalar tolerance = epsilon<T>) noexcept
+        : _q(rotation.as_quaternion())
+        , _drift(PRODUCT_DRIFT)
+        , _tolerance(tolerance)
+    {
+    }
+
+    constexpr const Quaternion& as_quaternion() const noexcept { return _q; }
+
+    /**
+     * Within tolerance of unit length, and corrected to within RENORMALIZE_LIMIT of it.
+     */
+    constexpr Rotation rotation() const noexcept { return Rotation::from_drifted_quaternion(_q); }
+
+    /** Bound of the error of the squared norm, at most tolerance(). */
+    constexpr Scalar drift() const noexcept { return _drift; }
+    constexpr Scalar tolerance() const noexcept { return _tolerance; }
+
+    /**
+     * Combine with rotation, applying the accumulated rotation first, like Rotation::then.
+     */
+    constexpr BasicRotationAccumulator& then(const Rotation& rotation) noexcept
+    {
+        _q = rotation.as_quaternion() * _q;
+        return add_drift(PRODUCT_DRIFT);
+    }
+
+    /**
+     * Turn at angular velocity ω (radians per second, around world axes) for dt seconds, to first order:
+     * q += dt / 2 (ω, 0) q, which grows the squared norm by (|ω| dt / 2)², the square of half the angle of the step.
+     * Steps small enough for that to stay within the tolerance pay no normalization at all.
+     */
+    constexpr BasicRotationAccumulator& integrate(const Vector3& ω, const Scalar dt) noexcept
+    {
+        const Vector3 h = ω * (dt / 2);
+        _q = _q + Quaternion { h, 0 } * _q;
+        return add_drift(h.squared_norm() + PRODUCT_DRIFT);
+    }
+
+    /**
+     * Measure the norm and correct it, whatever the bound.
+     */
+    template <typename Math = PreciseMath>
+    constexpr BasicRotationAccumulator& renormalize() noexcept
+    {
+        const Scalar s = _q.squared_norm();
+        const Scalar error = std::abs(s - 1);
+        if (error <= RENORMALIZE_LIMIT)
+        {
+            _q *= (3 - s) / 2;
+            _drift = Scalar(0.75) * error * error + PRODUCT_DRIFT;
+        }
+        else
+        {
+            _q *= Math::rsqrt(s);
+            _drift = PRODUCT_DRIFT;
+        }
+        return *this;
+    }
+
+private:
+    constexpr BasicRotationAccumulator& add_drift(const Scalar drift) noexcept
+    {
+        _drift += drift;
+        if (_drift <= _tolerance) return *this;
+
+        // The bound assumes the worst rounding at every step, the norm is often still fine
+        const Scalar error = std::abs(_q.squared_norm() - 1);
+        if (error <= _tolerance / 2) _drift = error;
+        else renormalize();
+        return *this;
+    }
+};
+
+using RotationAccumulator = BasicRotationAccumulator<Scalar>;
+using RotationAccumulatord = BasicRotationAccumulator<double>;
+
+} // namespace gfx
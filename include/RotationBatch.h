@@ -0,0 +1,106 @@
+#pragma once
+
+#include "gfx.h"
+#include "EulerOrder.h"
+#include "Matrix3.h"
+#include "Rotation.h"
+#include "ThreadPool.h"
+#include "Vector3.h"
+#include "Vector3Batch.h"
+
+#include <cstddef>
+#include <span>
+
+namespace gfx
+{
+
+// Bulk versions of Rotation::rotate.
+//
+// A single rotation is turned into its matrix form once per call,
+// then applied with the SIMD kernels picked at runtime (see Simd.h).
+// All the spans of a call must have the same size, out may be the same as points.
+
+GFX_API void rotate(const Rotation& rotation, std::span<const Vector3> points, std::span<Vector3> out) noexcept;
+GFX_API void rotate(const Rotation& rotation, std::span<Vector3> points) noexcept;
+
+GFX_API void rotate(const Rotation& rotation, ConstVector3Span points, Vector3Span out) noexcept;
+GFX_API void rotate(const Rotation& rotation, Vector3Span points) noexcept;
+
+/**
+ * Rotate each point by its own rotation: out[i] = rotations[i].rotate(points[i]).
+ */
+GFX_API void rotate(std::span<const Rotation> rotations, std::span<const Vector3> points, std::span<Vector3> out) noexcept;
+
+/**
+ * Whether rotations_from_matrices orthonormalizes the matrices first,
+ * as Matrix3::orthonormalized, e.g. for matrices accumulated over many frames.
+ */
+enum class Orthonormalize
+{
+    no,
+    yes,
+};
+
+/**
+ * Rotations of many rotation matrices: out[i] = Rotation::from_matrix3(matrices[i]).
+ */
+GFX_API void rotations_from_matrices(
+    std::span<const Matrix3> matrices,
+    std::span<Rotation> out,
+    Orthonormalize orthonormalize = Orthonormalize::no) noexcept;
+
+/**
+ * Rotations of many triples of Euler angles in radians: out[i] = Rotation::from_euler<order>(angles[i]).
+ */
+GFX_API void rotations_from_euler(
+    std::span<const Vector3> angles,
+    std::span<Rotation> out,
+    EulerOrder order = EulerOrder::zxy) noexcept;
+
+/**
+ * Cumulative rotations of a chain, e.g. the world rotations of its segments from their local ones:
+ * out[0] = rotations[0], then out[i] = rotations[i].then(out[i - 1]).
+ *
+ * Computed as a scan, since the products are associative: each SIMD lane composes its own run
+ * of the chain, then every run is rotated by the end of the previous one.
+ * Rounding errors grow with the length of the chain, renormalize_interval bounds them
+ * by normalizing the running products every that many rotations (0 for never).
+ * out may be the same as rotations.
+ */
+GFX_API void cumulative_rotations(
+    std::span<const Rotation> rotations,
+    std::span<Rotation> out,
+    std::size_t renormalize_interval = 0) noexcept;
+
+/**
+ * Same as cumulative_rotations, with long chains split in blocks over pool:
+ * the blocks are composed in parallel, then each one is rotated by the end of the previous one.
+ */
+GFX_API void cumulative_rotations(
+    std::span<const Rotation> rotations,
+    std::span<Rotation> out,
+    ThreadPool& pool,
+    std::size_t renormalize_interval = 0);
+
+/**
+ * One step of the orientations of many bodies, turning at angular velocities in radians per second
+ * around world axes for dt seconds, like RotationAccumulator::integrate:
+ * q += dt / 2 (ω, 0) q, then renormalized without a square root (see Rotation::from_drifted_quaternion)
+ * unless |ω| dt is larger than about 0.06, so that the error the step adds stays below 1e-6.
+ */
+GFX_API void integrate_angular_velocities(
+    std::span<Rotation> orientations,
+    std::span<const Vector3> angular_velocities,
+    Scalar dt) noexcept;
+
+/**
+ * Same as integrate_angular_velocities, spreading chunks of grain bodies over pool.
+ */
+GFX_API void integrate_angular_velocities(
+    std::span<Rotation> orientations,
+    std::span<const Vector3> angular_velocities,
+    Scalar dt,
+    ThreadPool& pool,
+    std::size_t grain = 4096);
+
+} // namespace gfx
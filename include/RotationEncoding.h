@@ -0,0 +1,81 @@
+#pragma once
+
+#include "gfx.h"
+#include "Rotation.h"
+#include "Scalar.h"
+
+#include <cstddef>
+#include <span>
+
+namespace gfx
+{
+
+/**
+ * Packed rotation formats, for storing and streaming many rotations.
+ *
+ * All of them are "smallest three": q and -q being the same rotation, the largest component
+ * of the quaternion is made positive and dropped, then rebuilt from the unit norm.
+ * The three others lie in [-1/√2, 1/√2] and get quantized uniformly.
+ * Codes are little endian, with the index of the dropped component in the top 2 bits,
+ * followed by the other components in x, y, z, w order.
+ */
+enum class RotationEncoding
+{
+    /** 4 bytes, 10 bits per component, within 0.28 degrees. */
+    smallest_three_32,
+    /** 6 bytes, 15 bits per component (1 bit unused), within 0.009 degrees. */
+    smallest_three_48,
+    /** 8 bytes, 20 bits per component (2 bits unused), within 0.0004 degrees. */
+    smallest_three_64,
+};
+
+constexpr std::size_t bytes_per_rotation(const RotationEncoding encoding) noexcept
+{
+    switch (encoding)
+    {
+        case RotationEncoding::smallest_three_32: return 4;
+        case RotationEncoding::smallest_three_48: return 6;
+        case RotationEncoding::smallest_three_64: return 8;
+    }
+    return 0;
+}
+
+/**
+ * Largest angle in radians between a rotation and its decoded version.
+ * About 2√3 quantization steps, reached when all four components are ±1/2.
+ */
+constexpr Scalar max_angular_error(const RotationEncoding encoding) noexcept
+{
+    switch (encoding)
+    {
+        case RotationEncoding::smallest_three_32: return 4.8e-3f;
+        case RotationEncoding::smallest_three_48: return 1.5e-4f;
+        // Float rounding adds to the quantization error
+        case RotationEncoding::smallest_three_64: return 6e-6f;
+    }
+    return 0;
+}
+
+/**
+ * Pack rotations, one code of bytes_per_rotation(encoding) bytes after the other.
+ * Runs on the SIMD kernels picked at runtime (see Simd.h) and never allocates.
+ *
+ * @param out At least rotations.size() * bytes_per_rotation(encoding) bytes.
+ */
+GFX_API void encode_rotations(
+    std::span<const Rotation> rotations,
+    std::span<std::byte> out,
+    RotationEncoding encoding) noexcept;
+
+/**
+ * Unpack rotations written by encode_rotations.
+ * Any input decodes to a unit quaternion, so the result is always a valid Rotation.
+ *
+ * @param packed At least out.size() * bytes_per_rotation(encoding) bytes.
+ */
+GFX_API void decode_rotations(
+    std::span<const std::byte> packed,
+    std::span<Rotation> out,
+    RotationEncoding encoding) noexcept;
+
+} // namespace gfx
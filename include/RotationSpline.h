@@ -0,0 +1,111 @@
+#pragma once
+
+#include "gfx.h"
+#include "Rotation.h"
+#include "Scalar.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace gfx
+{
+
+enum class RotationSplineType
+{
+    /**
+     * Passes through the keys with a continuous angular velocity (C1), Shoemake's squad,
+     * the tangent at each key weighing the steps on both sides by the durations of the segments,
+     * so that uneven keys do not make the angular speed jump.
+     * Ken Shoemake, 1987, Quaternion Calculus and Fast Animation, SIGGRAPH course notes
+     */
+    squad,
+    /**
+     * Cumulative cubic B-spline: also continuous in angular acceleration (C2),
+     * but only passes through the first and last keys, smoothing out the others.
+     * Its knots are uniform: with uneven key times, the angular velocity jumps at each key
+     * by the ratio of the durations of the segments around it.
+     * Myoung-Jun Kim, Myung-Soo Kim and Sung Yong Shin, 1995,
+     * A General Construction Scheme for Unit Quaternion Curves with Simple High Order Derivatives
+     * https://doi.org/10.1145/218380.218486
+     */
+    b_spline,
+};
+
+/**
+ * Smooth curve of rotations through keys at increasing times, unlike the slerp of AnimationTrack
+ * whose angular velocity jumps at every key.
+ * Sampling before the first key or after the last one holds them.
+ *
+ * The control quaternions of each segment only depend on the keys around it:
+ * they are computed once, when constructing the spline, so sampling costs a few slerps (squad)
+ * or three exponentials (B-spline) and never a logarithm.
+ */
+class GFX_API RotationSpline
+{
+private:
+    friend class RotationSplineSampler;
+
+    std::vector<Scalar> _times;
+    // Floats read by the kernels (see simd/Kernels.h), per key for squad, per key and one more for B-splines
+    std::vector<Scalar> _controls;
+    RotationSplineType _type = RotationSplineType::squad;
+
+public:
+    RotationSpline() noexcept = default;
+    RotationSpline(std::vector<Scalar> times, std::span<const Rotation> keys, RotationSplineType type = RotationSplineType::squad);
+
+    RotationSplineType type() const noexcept { return _type; }
+    std::span<const Scalar> times() const noexcept { return _times; }
+    std::size_t size() const noexcept { return _times.size(); }
+    bool empty() const noexcept { return _times.empty(); }
+    Scalar duration() const noexcept { return empty() ? 0 : _times.back() - _times.front(); }
+
+    /**
+     * Index of the last key not after time, or 0 before the first one.
+     */
+    std::size_t segment(Scalar time) const noexcept;
+
+    Rotation sample(Scalar time) const noexcept;
+
+private:
+    /**
+     * Controls of the segment around time for the kernels, from the last key k not after it.
+     */
+    void controls(std::size_t k, Scalar time, const Scalar*& from, const Scalar*& to, Scalar& u) const noexcept;
+};
+
+/**
+ * Samples many splines at once, e.g. all the bones of a crowd, like AnimationSampler:
+ * remembers the segment of each spline between calls, so playing forwards
+ * finds the keys in constant time, then evaluates all the splines with the SIMD kernels
+ * picked at runtime (see Simd.h). Sampling never allocates.
+ */
+class GFX_API RotationSplineSampler
+{
+private:
+    std::span<const RotationSpline> _splines;
+    RotationSplineType _type;
+    std::vector<std::uint32_t> _segments;
+
+    // Per spline controls and parameters of the current call
+    std::vector<const Scalar*> _from;
+    std::vector<const Scalar*> _to;
+    std::vector<Scalar> _u;
+
+public:
+    /**
+     * @param splines All of the same type (or empty), must outlive the sampler.
+     */
+    explicit RotationSplineSampler(std::span<const RotationSpline> splines);
+
+    std::size_t size() const noexcept { return _splines.size(); }
+
+    /**
+     * out[i] = splines[i].sample(time).
+     */
+    void sample(Scalar time, std::span<Rotation> out) noexcept;
+};
+
+} // namespace gfx
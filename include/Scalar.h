@@ -1,32 +1,75 @@
 #pragma once
 
 #include <cmath>
+#include <concepts>
+#include <type_traits>
 
 namespace gfx
 {
 
+/**
+ * Default precision of the library. The math types are templates on their scalar type
+ * (e.g. BasicVector3<T>), and their plain names (Vector3, Rotation...) are aliases for this one.
+ */
 typedef float Scalar;
 
-constexpr bool is_zero(const Scalar k, const Scalar ε) noexcept { return std::abs(k) < ε; }
-constexpr bool are_equal(const Scalar a, const Scalar b, const Scalar ε) noexcept
+/**
+ * Tolerance of the approximate comparisons, for each precision.
+ */
+template <std::floating_point T>
+inline constexpr T epsilon = T(1e-5);
+
+template <>
+inline constexpr double epsilon<double> = 1e-9;
+
+inline constexpr const Scalar EPSILON = epsilon<Scalar>;
+
+/**
+ * Scalar type of T: T itself for numbers, T::Scalar for the math types.
+ */
+template <typename T>
+struct scalar_of
+{
+    using type = T;
+};
+
+template <typename T>
+    requires requires { typename T::Scalar; }
+struct scalar_of<T>
+{
+    using type = typename T::Scalar;
+};
+
+template <typename T>
+using scalar_t = typename scalar_of<T>::type;
+
+
+template <std::floating_point T>
+constexpr bool is_zero(const T k, const std::type_identity_t<T> ε) noexcept { return std::abs(k) < ε; }
+
+template <std::floating_point T>
+constexpr bool are_equal(const T a, const T b, const std::type_identity_t<T> ε) noexcept
 {
     return is_zero(a - b, ε);
 }
 
-inline constexpr const Scalar EPSILON = 1e-5f;
-
-constexpr bool is_zero(const Scalar k) noexcept { return std::abs(k) < EPSILON; }
+template <std::floating_point T>
+constexpr bool is_zero(const T k) noexcept { return is_zero(k, epsilon<T>); }
 
 template <typename T>
-constexpr bool are_equal(const T& a, const T& b) noexcept { return are_equal(a, b, EPSILON); }
+constexpr bool are_equal(const T& a, const T& b) noexcept { return are_equal(a, b, epsilon<scalar_t<T>>); }
 
 
 template <typename T>
-constexpr T lerp(const T& a, const T& b, const Scalar α) noexcept
+constexpr T lerp(const T& a, const T& b, const std::type_identity_t<scalar_t<T>> α) noexcept
 {
     return b * α + a * (1 - α);
 }
 
-constexpr Scalar radians(const Scalar degrees) noexcept { return degrees * M_PI / 180.0; }
+template <std::floating_point T = Scalar>
+constexpr T radians(const std::type_identity_t<T> degrees) noexcept { return T(degrees * M_PI / 180.0); }
+
+template <std::floating_point T = Scalar>
+constexpr T degrees(const std::type_identity_t<T> radians) noexcept { return T(radians * 180.0 / M_PI); }
 
 } // namespace gfx
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "gfx.h"
+
+namespace gfx
+{
+
+/**
+ * Instruction sets the batch kernels are compiled for.
+ * Ordered from the narrowest to the widest.
+ */
+enum class SimdIsa
+{
+    scalar,
+    sse,
+    avx2,
+    avx512,
+};
+
+/**
+ * Instruction set currently used by the batch kernels.
+ * Unless overridden, the widest one supported by the running CPU.
+ */
+GFX_API SimdIsa simd_isa() noexcept;
+
+GFX_API bool simd_isa_supported(SimdIsa isa) noexcept;
+
+/**
+ * Force batch kernels onto a specific instruction set,
+ * e.g. to test or benchmark the narrower code paths.
+ *
+ * @return false, leaving the current one in place, if the CPU does not support it.
+ */
+GFX_API bool set_simd_isa(SimdIsa isa) noexcept;
+
+GFX_API const char* name(SimdIsa isa) noexcept;
+
+} // namespace gfx
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "gfx.h"
+#include "DualQuaternion.h"
+#include "Scalar.h"
+#include "ThreadPool.h"
+#include "Vector3Batch.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace gfx
+{
+
+/** Most bones influencing a vertex. */
+inline constexpr std::size_t MAX_BONE_INFLUENCES = 8;
+
+/**
+ * Bones influencing each vertex, count per vertex, interleaved:
+ * influence k of vertex v is bone bones[v * count + k] with weight weights[v * count + k].
+ * The weights of a vertex sum to 1, unused influences have a weight of 0 (and any valid bone).
+ */
+struct SkinInfluences
+{
+    std::span<const std::uint16_t> bones;
+    std::span<const Scalar> weights;
+    std::size_t count = 4;
+
+    constexpr std::size_t vertex_count() const noexcept { return count == 0 ? 0 : weights.size() / count; }
+
+    constexpr SkinInfluences subspan(const std::size_t vertex, const std::size_t vertices) const noexcept
+    {
+        return { bones.subspan(vertex * count, vertices * count), weights.subspan(vertex * count, vertices * count), count };
+    }
+};
+
+/**
+ * Linear blend skinning: each vertex is transformed by the weighted sum of the matrices of its bones,
+ * and its normal by the same matrix, then normalized (exact without non-uniform scale).
+ * Runs on the SIMD kernels picked at runtime (see Simd.h) and never allocates.
+ *
+ * @param matrices Column-major 3x4 matrices of the bones, 12 floats each (see write_matrices),
+ *                 usually the product of their pose and their inverse bind pose.
+ * @param normals, out_normals Both empty to only skin the positions.
+ */
+GFX_API void skin_linear(
+    const SkinInfluences& influences,
+    std::span<const float> matrices,
+    ConstVector3Span positions,
+    ConstVector3Span normals,
+    Vector3Span out_positions,
+    Vector3Span out_normals) noexcept;
+
+/**
+ * Same as skin_linear, spreading chunks of grain vertices over pool.
+ */
+GFX_API void skin_linear(
+    const SkinInfluences& influences,
+    std::span<const float> matrices,
+    ConstVector3Span positions,
+    ConstVector3Span normals,
+    Vector3Span out_positions,
+    Vector3Span out_normals,
+    ThreadPool& pool,
+    std::size_t grain = 4096);
+
+/**
+ * Dual quaternion skinning: each vertex is transformed by the normalized weighted sum
+ * of the dual quaternions of its bones, flipped to the side of the first one,
+ * which keeps twisted joints from collapsing like with linear blending (the candy wrapper effect).
+ * Bones can only rotate and translate.
+ *
+ * @param bones Unit dual quaternions of the bones.
+ */
+GFX_API void skin_dual_quaternion(
+    const SkinInfluences& influences,
+    std::span<const DualQuaternion> bones,
+    ConstVector3Span positions,
+    ConstVector3Span normals,
+    Vector3Span out_positions,
+    Vector3Span out_normals) noexcept;
+
+/**
+ * Same as skin_dual_quaternion, spreading chunks of grain vertices over pool.
+ */
+GFX_API void skin_dual_quaternion(
+    const SkinInfluences& influences,
+    std::span<const DualQuaternion> bones,
+    ConstVector3Span positions,
+    ConstVector3Span normals,
+    Vector3Span out_positions,
+    Vector3Span out_normals,
+    ThreadPool& pool,
+    std::size_t grain = 4096);
+
+} // namespace gfx
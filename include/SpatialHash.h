@@ -0,0 +1,113 @@
+#pragma once
+
+#include "gfx.h"
+#include "Scalar.h"
+#include "Sphere.h"
+#include "ThreadPool.h"
+#include "Vector3.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace gfx
+{
+
+/**
+ * Broadphase for spheres: a uniform grid of cubic cells, hashed into a table of buckets
+ * so that it needs no bounds and its memory only depends on the number of spheres.
+ * Matthias Teschner et al., 2003, Optimized Spatial Hashing for Collision Detection of Deformable Objects
+ *
+ * Each sphere is stored in the cell of its center, cells being at least as large as the largest diameter,
+ * so overlapping spheres are always in neighbouring cells.
+ * Spheres are copied sorted by bucket, so a bucket is a contiguous range, and only rows of cells
+ * along x are hashed: the cells of a row get consecutive buckets, keeping its spheres close in memory.
+ *
+ * The table lives in the memory resource given at construction, and the temporary memory of builds
+ * and queries comes from a scratch resource, e.g. a LinearArena (see Memory.h).
+ */
+class GFX_API SpatialHash
+{
+public:
+    /** Indices of two overlapping spheres in the array the hash was built from, first < second. */
+    using Pair = std::pair<std::uint32_t, std::uint32_t>;
+
+private:
+    Scalar _cell_size = 0;
+    Scalar _max_radius = 0;
+    std::uint32_t _mask = 0;
+
+    // Bucket b holds the sorted entries [_start[b], _start[b + 1])
+    std::pmr::vector<std::uint32_t> _start;
+
+    // Sorted by bucket
+    std::pmr::vector<std::uint32_t> _keys;
+    std::pmr::vector<std::uint32_t> _indices;
+    std::pmr::vector<Sphere> _spheres;
+
+    // Scratch space of update(), kept to avoid allocating every frame
+    std::pmr::vector<std::pair<std::uint32_t, std::uint32_t>> _moved;
+
+public:
+    SpatialHash() noexcept = default;
+    explicit SpatialHash(std::pmr::memory_resource* memory) noexcept;
+
+    /**
+     * @param cell_size Edge of the cells, 0 for the largest diameter (1 if all radii are 0).
+     *                  Smaller than that, the largest diameter is used instead.
+     */
+    explicit SpatialHash(
+        std::span<const Sphere> spheres,
+        Scalar cell_size = 0,
+        std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+    /**
+     * @param scratch Temporary memory of the build, free again when it returns.
+     */
+    void build(
+        std::span<const Sphere> spheres,
+        Scalar cell_size = 0,
+        std::pmr::memory_resource* scratch = std::pmr::get_default_resource());
+
+    /**
+     * Move the spheres of the last build() to new positions and radii:
+     * only the ones that left their bucket get sorted again, so small steps cost little more than a copy.
+     * Rebuilds with larger cells if a sphere got larger than them, using scratch like build().
+     */
+    void update(std::span<const Sphere> spheres, std::pmr::memory_resource* scratch = std::pmr::get_default_resource());
+
+    std::size_t size() const noexcept { return _spheres.size(); }
+    bool empty() const noexcept { return _spheres.empty(); }
+    Scalar cell_size() const noexcept { return _cell_size; }
+
+    /**
+     * Replace pairs with every pair of overlapping spheres,
+     * ordered by the position of their first sphere in the hash.
+     */
+    void overlapping_pairs(std::pmr::vector<Pair>& pairs) const;
+
+    /**
+     * Same as overlapping_pairs(pairs), spreading chunks of grain spheres over pool.
+     */
+    void overlapping_pairs(std::pmr::vector<Pair>& pairs, ThreadPool& pool, std::size_t grain = 4096) const;
+
+    /**
+     * Append to indices the spheres that overlap sphere, e.g. the neighbours within some radius of a point.
+     *
+     * @param scratch Temporary memory of the query, free again when it returns.
+     */
+    void query(
+        const Sphere& sphere,
+        std::pmr::vector<std::uint32_t>& indices,
+        std::pmr::memory_resource* scratch = std::pmr::get_default_resource()) const;
+
+private:
+    void sort_entries(std::span<const Sphere> spheres, std::pmr::memory_resource* scratch);
+    void count_buckets();
+    void pairs_in_range(std::size_t begin, std::size_t end, std::pmr::vector<Pair>& pairs) const;
+};
+
+} // namespace gfx
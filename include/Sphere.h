@@ -6,10 +6,22 @@
 namespace gfx
 {
 
-struct Sphere
+template <typename T>
+struct BasicSphere
 {
-    Vector3 center;
+    using Scalar = T;
+
+    BasicVector3<T> center;
     Scalar radius;
+
+    template <typename U>
+    constexpr BasicSphere<U> cast() const noexcept
+    {
+        return { center.template cast<U>(), U(radius) };
+    }
 };
 
+using Sphere = BasicSphere<Scalar>;
+using Sphered = BasicSphere<double>;
+
 } // namespace gfx
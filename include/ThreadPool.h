@@ -0,0 +1,57 @@
+#pragma once
+
+#include "gfx.h"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+namespace gfx
+{
+
+/**
+ * Fixed set of worker threads with one task queue each.
+ * Idle workers steal from the back of the other queues,
+ * so uneven tasks (e.g. tiles of a busy region) still keep every core busy.
+ */
+class GFX_API ThreadPool
+{
+private:
+    struct State;
+    std::unique_ptr<State> _state;
+
+public:
+    /**
+     * @param threads Worker threads, 0 for std::thread::hardware_concurrency().
+     */
+    explicit ThreadPool(unsigned threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned size() const noexcept;
+
+    /**
+     * Run task(0), ..., task(count - 1) on the pool and wait for all of them.
+     * Consecutive indices start on the same worker.
+     * The calling thread helps while it waits, so tasks may call parallel_for themselves.
+     * If tasks throw, the ones not started yet are skipped,
+     * and the first exception is rethrown once all the others have returned.
+     */
+    void parallel_for(std::size_t count, const std::function<void(std::size_t)>& task);
+
+    /**
+     * Split [0, count) into chunks of at least grain elements
+     * and run task(begin, end) on each of them.
+     */
+    void parallel_for(std::size_t count, std::size_t grain, const std::function<void(std::size_t, std::size_t)>& task);
+
+    /**
+     * Pool shared by the library functions that do not take one explicitly,
+     * created on first use with one thread per core.
+     */
+    static ThreadPool& shared();
+};
+
+} // namespace gfx
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Matrix3.h"
+#include "Matrix4.h"
+#include "Rotation.h"
+#include "Scalar.h"
+#include "Vector3.h"
+
+namespace gfx
+{
+
+/**
+ * Translation, rotation and scale of an object, applied in reverse order:
+ * p' = translation + rotation(scale * p).
+ */
+struct Transform
+{
+    Vector3 translation;
+    Rotation rotation;
+    Vector3 scale = Vector3::one();
+
+    constexpr Vector3 transform_point(const Vector3& p) const noexcept
+    {
+        return translation + rotation.rotate(p.scaled(scale));
+    }
+
+    constexpr Vector3 transform_direction(const Vector3& d) const noexcept
+    {
+        return rotation.rotate(d.scaled(scale));
+    }
+
+    /**
+     * Combine with transform, applying the current transform first (e.g. child.then(parent)).
+     * Exact when the scale of transform is uniform: otherwise the product would shear,
+     * which only the matrix form can represent.
+     */
+    constexpr Transform then(const Transform& transform) const noexcept
+    {
+        return {
+            transform.transform_point(translation),
+            rotation.then(transform.rotation),
+            scale.scaled(transform.scale),
+        };
+    }
+
+    /**
+     * Exact when the scale is uniform, like then().
+     */
+    constexpr Transform inverse() const noexcept
+    {
+        const Vector3 inv_scale = { 1 / scale.x, 1 / scale.y, 1 / scale.z };
+        const Rotation inv_rotation = rotation.inverse();
+        return {
+            -inv_rotation.rotate(translation).scaled(inv_scale),
+            inv_rotation,
+            inv_scale,
+        };
+    }
+
+    constexpr Matrix4 as_matrix4() const noexcept
+    {
+        return Matrix4::from_affine(rotation.as_matrix3() * Matrix3::from_diagonal(scale), translation);
+    }
+};
+
+constexpr bool are_equivalent(const Transform& a, const Transform& b, const Scalar ε) noexcept
+{
+    return are_equal(a.translation, b.translation, ε)
+        && are_equivalent(a.rotation, b.rotation, ε)
+        && are_equal(a.scale, b.scale, ε);
+}
+
+constexpr bool are_equivalent(const Transform& a, const Transform& b) noexcept
+{
+    return are_equivalent(a, b, EPSILON);
+}
+
+} // namespace gfx
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "gfx.h"
+#include "Transform.h"
+
+#include <cstddef>
+#include <span>
+
+namespace gfx
+{
+
+/**
+ * Packed float matrix layouts, as uploaded to instance or uniform buffers.
+ */
+enum class MatrixLayout
+{
+    /** 16 floats, column after column. */
+    column_major_4x4,
+    /** 12 floats: the three basis columns, then the translation (the last row is implicitly 0 0 0 1). */
+    column_major_3x4,
+};
+
+constexpr std::size_t floats_per_matrix(const MatrixLayout layout) noexcept
+{
+    return layout == MatrixLayout::column_major_4x4 ? 16 : 12;
+}
+
+/**
+ * Write transforms[i].as_matrix4() to out, one tightly packed matrix after the other.
+ * Runs on the SIMD kernels picked at runtime (see Simd.h) and never allocates.
+ *
+ * @param out At least transforms.size() * floats_per_matrix(layout) floats.
+ */
+GFX_API void write_matrices(
+    std::span<const Transform> transforms,
+    std::span<float> out,
+    MatrixLayout layout = MatrixLayout::column_major_4x4) noexcept;
+
+} // namespace gfx
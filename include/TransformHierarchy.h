@@ -0,0 +1,99 @@
+#pragma once
+
+#include "gfx.h"
+#include "ThreadPool.h"
+#include "Transform.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace gfx
+{
+
+/**
+ * Tree of local transforms, caching the world transform of every node.
+ *
+ * Nodes are stored depth-first in flat arrays, so every subtree is a contiguous range
+ * that follows its root. Changing a local transform only marks the node dirty:
+ * update() then recomputes the dirty subtrees in a single forward sweep each,
+ * so its cost depends on how many nodes moved rather than on the size of the tree.
+ */
+class GFX_API TransformHierarchy
+{
+public:
+    /** Stable handle of a node, valid for the lifetime of the hierarchy. */
+    using Node = std::uint32_t;
+
+    static constexpr Node no_parent = 0xffffffff;
+
+private:
+    // Depth-first order
+    std::vector<Transform> _local;
+    std::vector<Transform> _world;
+    std::vector<std::uint32_t> _parent;
+    std::vector<std::uint32_t> _size;
+    std::vector<Node> _node;
+
+    // By node
+    std::vector<std::uint32_t> _index;
+    std::vector<std::uint8_t> _dirty;
+    std::vector<Node> _dirty_nodes;
+
+    // Scratch space of update(), kept to avoid allocating every frame
+    struct Range
+    {
+        std::uint32_t begin;
+        std::uint32_t end;
+    };
+    std::vector<Range> _ranges;
+    std::vector<Range> _tasks;
+
+public:
+    /**
+     * Add a node below parent, or as a new root.
+     * Adding in depth-first order (below the last added node or one of its ancestors)
+     * takes O(depth); anything else moves the nodes stored after the new one.
+     */
+    Node add(const Transform& local, Node parent = no_parent);
+
+    std::size_t size() const noexcept { return _local.size(); }
+    bool empty() const noexcept { return _local.empty(); }
+
+    Node parent(Node node) const noexcept;
+    const Transform& local(Node node) const noexcept { return _local[_index[node]]; }
+
+    /** World transform as of the last update(). */
+    const Transform& world(Node node) const noexcept { return _world[_index[node]]; }
+
+    bool is_dirty(Node node) const noexcept { return _dirty[node]; }
+
+    void set_local(Node node, const Transform& local) noexcept;
+
+    /**
+     * Recompute the world transforms of the dirty nodes and their descendants.
+     *
+     * @return Number of world transforms recomputed.
+     */
+    std::size_t update();
+
+    /**
+     * Same as update(), spreading independent subtrees of at least grain nodes over pool.
+     */
+    std::size_t update(ThreadPool& pool, std::size_t grain = 4096);
+
+    /**
+     * World transforms in depth-first order, e.g. for write_matrices().
+     * index() maps nodes to positions in this array.
+     */
+    std::span<const Transform> world_transforms() const noexcept { return _world; }
+    std::size_t index(Node node) const noexcept { return _index[node]; }
+
+private:
+    void collect_dirty_ranges();
+    void update_range(Range range) noexcept;
+    void split_ranges(std::size_t grain);
+};
+
+} // namespace gfx
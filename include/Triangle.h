@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Scalar.h"
+#include "Vector3.h"
+
+namespace gfx
+{
+
+/**
+ * Triangle of vertices a, b, c, its front face being the one they turn counterclockwise around.
+ */
+template <typename T>
+struct BasicTriangle
+{
+    using Scalar = T;
+    using Vector3 = BasicVector3<T>;
+
+    Vector3 a;
+    Vector3 b;
+    Vector3 c;
+
+    /**
+     * Unit normal of the front face, null for degenerate triangles.
+     */
+    constexpr Vector3 normal() const noexcept
+    {
+        const Vector3 n = (b - a).cross(c - a);
+        const Scalar s = n.squared_norm();
+        return s == 0 ? Vector3::zero() : n.normalized();
+    }
+
+    template <typename U>
+    constexpr BasicTriangle<U> cast() const noexcept
+    {
+        return { a.template cast<U>(), b.template cast<U>(), c.template cast<U>() };
+    }
+};
+
+using Triangle = BasicTriangle<Scalar>;
+using Triangled = BasicTriangle<double>;
+
+} // namespace gfx
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "gfx.h"
+#include "Hit.h"
+#include "Ray.h"
+#include "Scalar.h"
+#include "Triangle.h"
+#include "Vector3.h"
+#include "Vector3Batch.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+namespace gfx
+{
+
+/**
+ * Indexed triangle mesh: vertices shared between triangles, and 3 indices per triangle,
+ * counterclockwise around the front face.
+ *
+ * Ray queries test the triangles a SIMD register at a time (see Simd.h),
+ * with the same test as Ray::hit_distance, gathering their vertices through the indices.
+ * For meshes queried many times, TriangleBatch trades memory for speed.
+ */
+class GFX_API TriangleMesh
+{
+private:
+    // Followed by an unused vertex, so that the kernels can load every vertex as 4 floats
+    std::vector<Vector3> _vertices;
+    std::vector<std::uint32_t> _indices;
+
+public:
+    TriangleMesh() noexcept = default;
+
+    /**
+     * @param indices 3 per triangle, each less than the number of vertices.
+     */
+    TriangleMesh(std::vector<Vector3> vertices, std::vector<std::uint32_t> indices);
+
+    std::span<const Vector3> vertices() const noexcept { return { _vertices.data(), _vertices.empty() ? 0 : _vertices.size() - 1 }; }
+    std::span<const std::uint32_t> indices() const noexcept { return _indices; }
+    std::size_t size() const noexcept { return _indices.size() / 3; }
+    bool empty() const noexcept { return _indices.empty(); }
+
+    Triangle triangle(const std::size_t i) const noexcept
+    {
+        return { _vertices[_indices[3 * i]], _vertices[_indices[3 * i + 1]], _vertices[_indices[3 * i + 2]] };
+    }
+
+    /**
+     * Closest triangle hit within [t_min, t_max], with its index as primitive,
+     * the normal being the one of its front face, like Ray::closest_hit.
+     */
+    Hit closest_hit(const Ray& ray, Scalar t_min = 0, Scalar t_max = INFINITY) const noexcept;
+
+    /**
+     * Whether the ray hits any triangle within [t_min, t_max], stopping at the first one found, e.g. for shadow rays.
+     */
+    bool any_hit(const Ray& ray, Scalar t_min = 0, Scalar t_max = INFINITY) const noexcept;
+};
+
+/**
+ * Triangles laid out for ray queries: first vertex, edges and unit normal, as structures of arrays.
+ * 48 bytes per triangle instead of the 12 bytes of indices and the shared vertices of a TriangleMesh,
+ * but the queries load the triangles of each SIMD register directly, without gathering or subtracting vertices.
+ */
+class GFX_API TriangleBatch
+{
+private:
+    // Vertex a, edges b - a and c - a of each triangle
+    Vector3Batch _a;
+    Vector3Batch _e1;
+    Vector3Batch _e2;
+    Vector3Batch _normals;
+
+public:
+    explicit TriangleBatch(std::pmr::memory_resource* memory = std::pmr::get_default_resource()) noexcept;
+    explicit TriangleBatch(const TriangleMesh& mesh, std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+    explicit TriangleBatch(std::span<const Triangle> triangles, std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+    std::size_t size() const noexcept { return _a.size(); }
+    bool empty() const noexcept { return size() == 0; }
+
+    Triangle triangle(const std::size_t i) const noexcept
+    {
+        const Vector3 a = _a[i];
+        return { a, a + _e1[i], a + _e2[i] };
+    }
+
+    /** Unit normal of the front face of each triangle, null for degenerate ones. */
+    ConstVector3Span normals() const noexcept { return _normals; }
+
+    /**
+     * Same as TriangleMesh::closest_hit.
+     */
+    Hit closest_hit(const Ray& ray, Scalar t_min = 0, Scalar t_max = INFINITY) const noexcept;
+
+    /**
+     * Same as TriangleMesh::any_hit.
+     */
+    bool any_hit(const Ray& ray, Scalar t_min = 0, Scalar t_max = INFINITY) const noexcept;
+
+private:
+    void set(std::size_t i, const Triangle& triangle) noexcept;
+};
+
+} // namespace gfx
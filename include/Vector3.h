@@ -1,34 +1,37 @@
 #pragma once
 
 #include "gfx.h"
+#include "Half.h"
+#include "MathPolicy.h"
 #include "Scalar.h"
 
 #include <cmath>
 #include <format>
 #include <ostream>
+#include <type_traits>
 
 namespace gfx
 {
 
-struct Vector3;
-constexpr bool are_equal(const Vector3& v, const Vector3& w, const Scalar ε) noexcept;
-
-struct Vector3
+template <typename T>
+struct BasicVector3
 {
+    using Scalar = T;
+
     Scalar x;
     Scalar y;
     Scalar z;
 
-    static constexpr Vector3 origin()    noexcept { return {}; }
-    static constexpr Vector3 zero()      noexcept { return {}; }
-    static constexpr Vector3 one()       noexcept { return { 1, 1, 1 }; }
-    static constexpr Vector3 infinity()  noexcept { return { INFINITY, INFINITY, INFINITY }; }
-    static constexpr Vector3 right()     noexcept { return { .x = +1 }; }
-    static constexpr Vector3 left()      noexcept { return { .x = -1 }; }
-    static constexpr Vector3 up()        noexcept { return { .y = +1 }; }
-    static constexpr Vector3 down()      noexcept { return { .y = -1 }; }
-    static constexpr Vector3 forwards()  noexcept { return { .z = +1 }; }
-    static constexpr Vector3 backwards() noexcept { return { .z = -1 }; }
+    static constexpr BasicVector3 origin()    noexcept { return {}; }
+    static constexpr BasicVector3 zero()      noexcept { return {}; }
+    static constexpr BasicVector3 one()       noexcept { return { 1, 1, 1 }; }
+    static constexpr BasicVector3 infinity()  noexcept { return { INFINITY, INFINITY, INFINITY }; }
+    static constexpr BasicVector3 right()     noexcept { return { .x = +1 }; }
+    static constexpr BasicVector3 left()      noexcept { return { .x = -1 }; }
+    static constexpr BasicVector3 up()        noexcept { return { .y = +1 }; }
+    static constexpr BasicVector3 down()      noexcept { return { .y = -1 }; }
+    static constexpr BasicVector3 forwards()  noexcept { return { .z = +1 }; }
+    static constexpr BasicVector3 backwards() noexcept { return { .z = -1 }; }
 
     /**
      * Subscript, math-like accessor.
@@ -48,11 +51,32 @@ struct Vector3
         }
     }
 
-    constexpr Vector3 with_x(const Scalar other_x) const noexcept { return { other_x, y, z }; }
-    constexpr Vector3 with_y(const Scalar other_y) const noexcept { return { x, other_y, z }; }
-    constexpr Vector3 with_z(const Scalar other_z) const noexcept { return { x, y, other_z }; }
+    /**
+     * Same vector in another precision, e.g. to accumulate in double or store as Half.
+     */
+    template <typename U>
+    constexpr BasicVector3<U> cast() const noexcept
+    {
+        return { U(x), U(y), U(z) };
+    }
+
+    constexpr BasicVector3 with_x(const Scalar other_x) const noexcept { return { other_x, y, z }; }
+    constexpr BasicVector3 with_y(const Scalar other_y) const noexcept { return { x, other_y, z }; }
+    constexpr BasicVector3 with_z(const Scalar other_z) const noexcept { return { x, y, other_z }; }
 
-    constexpr Vector3 operator*(const Scalar k) const noexcept
+    /**
+     * Component-wise product, e.g. for non-uniform scaling.
+     */
+    constexpr BasicVector3 scaled(const BasicVector3& k) const noexcept
+    {
+        return {
+            x * k.x,
+            y * k.y,
+            z * k.z,
+        };
+    }
+
+    constexpr BasicVector3 operator*(const Scalar k) const noexcept
     {
         return {
             x * k,
@@ -61,12 +85,12 @@ struct Vector3
         };
     }
 
-    constexpr Vector3 operator-() const noexcept
+    constexpr BasicVector3 operator-() const noexcept
     {
         return { -x, -y, -z };
     }
 
-    constexpr Vector3 operator+(const Vector3& v) const noexcept
+    constexpr BasicVector3 operator+(const BasicVector3& v) const noexcept
     {
         return {
             x + v.x,
@@ -75,7 +99,7 @@ struct Vector3
         };
     }
 
-    constexpr Vector3 operator-(const Vector3& v) const noexcept
+    constexpr BasicVector3 operator-(const BasicVector3& v) const noexcept
     {
         return {
             x - v.x,
@@ -84,12 +108,12 @@ struct Vector3
         };
     }
 
-    constexpr bool operator==(const Vector3& v) const noexcept
+    constexpr bool operator==(const BasicVector3& v) const noexcept
     {
         return are_equal(*this, v);
     }
 
-    constexpr Vector3& operator*=(const Scalar k) noexcept
+    constexpr BasicVector3& operator*=(const Scalar k) noexcept
     {
         x *= k;
         y *= k;
@@ -97,7 +121,7 @@ struct Vector3
         return *this;
     }
 
-    constexpr Vector3& operator+=(const Vector3& v) noexcept
+    constexpr BasicVector3& operator+=(const BasicVector3& v) noexcept
     {
         x += v.x;
         y += v.y;
@@ -106,14 +130,14 @@ struct Vector3
     }
 
 
-    constexpr Scalar dot(const Vector3& v) const noexcept
+    constexpr Scalar dot(const BasicVector3& v) const noexcept
     {
         return x * v.x
             + y * v.y
             + z * v.z;
     }
 
-    constexpr Vector3 cross(const Vector3& v) const noexcept
+    constexpr BasicVector3 cross(const BasicVector3& v) const noexcept
     {
         return {
             y * v.z - z * v.y,
@@ -125,69 +149,83 @@ struct Vector3
 
     constexpr Scalar squared_norm() const noexcept
     {
-        const Vector3 v = *this;
+        const BasicVector3 v = *this;
         return v.dot(v);
     }
 
+    template <typename Math = PreciseMath>
     constexpr Scalar norm() const noexcept
     {
-        return std::sqrt(squared_norm());
+        return Math::sqrt(squared_norm());
     }
 
-    constexpr Vector3 normalized() const noexcept
+    template <typename Math = PreciseMath>
+    constexpr BasicVector3 normalized() const noexcept
     {
-        return *this * (1 / norm());
+        return *this * Math::rsqrt(squared_norm());
     }
 
-    constexpr Vector3& normalize() noexcept
+    template <typename Math = PreciseMath>
+    constexpr BasicVector3& normalize() noexcept
     {
-        return *this *= 1 / norm();
+        return *this *= Math::rsqrt(squared_norm());
     }
 };
 
-constexpr bool are_equal(const Vector3& v, const Vector3& w, const Scalar ε) noexcept
+template <typename T>
+constexpr bool are_equal(const BasicVector3<T>& v, const BasicVector3<T>& w, const std::type_identity_t<T> ε) noexcept
 {
     return are_equal(v.x, w.x, ε)
         && are_equal(v.y, w.y, ε)
         && are_equal(v.z, w.z, ε);
 }
 
-constexpr Scalar dot(const Vector3& v, const Vector3& w) noexcept
+template <typename T>
+constexpr T dot(const BasicVector3<T>& v, const BasicVector3<T>& w) noexcept
 {
     return v.dot(w);
 }
 
-constexpr Vector3 cross(const Vector3& v, const Vector3& w) noexcept
+template <typename T>
+constexpr BasicVector3<T> cross(const BasicVector3<T>& v, const BasicVector3<T>& w) noexcept
 {
     return v.cross(w);
 }
 
-constexpr Scalar distance(const Vector3& a, const Vector3& b) noexcept
+template <typename T>
+constexpr T distance(const BasicVector3<T>& a, const BasicVector3<T>& b) noexcept
 {
     return (b - a).norm();
 }
 
+using Vector3 = BasicVector3<Scalar>;
+using Vector3d = BasicVector3<double>;
+/** Storage only, see Half. */
+using Vector3h = BasicVector3<Half>;
+
 } // namespace gfx
 
 // Scaling commutative closure (k v = v k)
-constexpr gfx::Vector3 operator*(const gfx::Scalar k, const gfx::Vector3& v) noexcept
+template <typename T>
+constexpr gfx::BasicVector3<T> operator*(const std::type_identity_t<T> k, const gfx::BasicVector3<T>& v) noexcept
 {
     return v * k;
 }
 
 GFX_API std::ostream& operator<<(std::ostream& os, const gfx::Vector3& v);
+GFX_API std::ostream& operator<<(std::ostream& os, const gfx::Vector3d& v);
 
 
 namespace std
 {
 
-template <>
-struct formatter<gfx::Vector3>
+template <typename T>
+struct formatter<gfx::BasicVector3<T>>
 {
     constexpr auto parse(std::format_parse_context& ctx) { return ctx.begin(); }
 
     template <typename FormatContext>
-    auto format(const gfx::Vector3& v, FormatContext& ctx) const
+    auto format(const gfx::BasicVector3<T>& v, FormatContext& ctx) const
     {
         return std::format_to(ctx.out(), "({}, {}, {})", v.x, v.y, v.z);
     }
@@ -0,0 +1,173 @@
+#pragma once
+
+#include "gfx.h"
+#include "Scalar.h"
+#include "Vector3.h"
+
+#include <cstddef>
+#include <memory_resource>
+#include <span>
+#include <type_traits>
+
+namespace gfx
+{
+
+/**
+ * Non-owning structure-of-arrays view over n vectors:
+ * the i-th vector is (x[i], y[i], z[i]).
+ *
+ * @tparam S Scalar for a mutable view, const Scalar for a read-only one.
+ */
+template <typename S>
+class BasicVector3Span
+{
+private:
+    S* _x;
+    S* _y;
+    S* _z;
+    std::size_t _size;
+
+public:
+    constexpr BasicVector3Span() noexcept
+        : _x(nullptr)
+        , _y(nullptr)
+        , _z(nullptr)
+        , _size(0)
+    {
+    }
+
+    constexpr BasicVector3Span(S* x, S* y, S* z, const std::size_t size) noexcept
+        : _x(x)
+        , _y(y)
+        , _z(z)
+        , _size(size)
+    {
+    }
+
+    // Mutable views convert to read-only ones
+    template <typename T>
+        requires (std::is_const_v<S> && std::is_same_v<T, std::remove_const_t<S>>)
+    constexpr BasicVector3Span(const BasicVector3Span<T>& other) noexcept
+        : BasicVector3Span(other.x(), other.y(), other.z(), other.size())
+    {
+    }
+
+    constexpr S* x() const noexcept { return _x; }
+    constexpr S* y() const noexcept { return _y; }
+    constexpr S* z() const noexcept { return _z; }
+
+    constexpr std::size_t size() const noexcept { return _size; }
+    constexpr bool empty() const noexcept { return _size == 0; }
+
+    constexpr Vector3 operator[](const std::size_t i) const noexcept
+    {
+        return { _x[i], _y[i], _z[i] };
+    }
+
+    constexpr void set(const std::size_t i, const Vector3& v) const noexcept
+        requires (!std::is_const_v<S>)
+    {
+        _x[i] = v.x;
+        _y[i] = v.y;
+        _z[i] = v.z;
+    }
+
+    constexpr BasicVector3Span subspan(const std::size_t offset, const std::size_t count) const noexcept
+    {
+        return { _x + offset, _y + offset, _z + offset, count };
+    }
+};
+
+using Vector3Span = BasicVector3Span<Scalar>;
+using ConstVector3Span = BasicVector3Span<const Scalar>;
+
+
+/**
+ * Owning structure-of-arrays container of vectors.
+ *
+ * Each coordinate array starts on a 64 bytes boundary (a full AVX-512 register),
+ * so the batch functions below can stream through it at full width.
+ * Memory comes from a memory resource, e.g. a LinearArena (see Memory.h) for a batch of rays
+ * that only lives for a frame. Copies are made in the default resource (or in the one of the batch assigned to),
+ * and moves take the resource with the data.
+ */
+class GFX_API Vector3Batch
+{
+private:
+    Scalar* _data;
+    std::size_t _size;
+    std::size_t _capacity;
+    std::pmr::memory_resource* _memory;
+
+public:
+    static constexpr std::size_t alignment = 64;
+
+    Vector3Batch() noexcept;
+    explicit Vector3Batch(std::pmr::memory_resource* memory) noexcept;
+    explicit Vector3Batch(std::size_t size, std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+    explicit Vector3Batch(std::span<const Vector3> vectors, std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+    Vector3Batch(const Vector3Batch& other);
+    Vector3Batch(Vector3Batch&& other) noexcept;
+    Vector3Batch& operator=(const Vector3Batch& other);
+    Vector3Batch& operator=(Vector3Batch&& other) noexcept;
+    ~Vector3Batch();
+
+    std::size_t size() const noexcept { return _size; }
+    std::size_t capacity() const noexcept { return _capacity; }
+    bool empty() const noexcept { return _size == 0; }
+    std::pmr::memory_resource* memory() const noexcept { return _memory; }
+
+    Scalar* x() noexcept { return _data; }
+    Scalar* y() noexcept { return _data + _capacity; }
+    Scalar* z() noexcept { return _data + 2 * _capacity; }
+    const Scalar* x() const noexcept { return _data; }
+    const Scalar* y() const noexcept { return _data + _capacity; }
+    const Scalar* z() const noexcept { return _data + 2 * _capacity; }
+
+    Vector3 operator[](const std::size_t i) const noexcept { return { x()[i], y()[i], z()[i] }; }
+    void set(const std::size_t i, const Vector3& v) noexcept { span().set(i, v); }
+
+    Vector3Span span() noexcept { return { x(), y(), z(), _size }; }
+    ConstVector3Span span() const noexcept { return { x(), y(), z(), _size }; }
+    operator Vector3Span() noexcept { return span(); }
+    operator ConstVector3Span() const noexcept { return span(); }
+
+    void reserve(std::size_t capacity);
+
+    /**
+     * New elements are zero vectors.
+     */
+    void resize(std::size_t size);
+    void clear() noexcept { _size = 0; }
+    void push_back(const Vector3& v);
+
+    /**
+     * Replace the content with vectors, scattering them into the coordinate arrays.
+     */
+    void assign(std::span<const Vector3> vectors);
+
+    /**
+     * Gather the content back into an array of structures.
+     *
+     * @param out Must hold at least size() vectors.
+     */
+    void copy_to(std::span<Vector3> out) const noexcept;
+};
+
+
+// Bulk versions of the Vector3 operations.
+//
+// All the spans of a call must have the same size.
+// Outputs may alias inputs of the same shape (e.g. normalize(v, v)).
+// Kernels are picked at runtime for the instruction set reported by simd_isa().
+
+GFX_API void dot(ConstVector3Span a, ConstVector3Span b, std::span<Scalar> out) noexcept;
+GFX_API void cross(ConstVector3Span a, ConstVector3Span b, Vector3Span out) noexcept;
+GFX_API void squared_norm(ConstVector3Span v, std::span<Scalar> out) noexcept;
+GFX_API void normalize(ConstVector3Span v, Vector3Span out) noexcept;
+GFX_API void normalize(Vector3Span v) noexcept;
+GFX_API void lerp(ConstVector3Span a, ConstVector3Span b, Scalar α, Vector3Span out) noexcept;
+GFX_API void distance(ConstVector3Span a, ConstVector3Span b, std::span<Scalar> out) noexcept;
+
+} // namespace gfx
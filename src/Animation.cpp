@@ -0,0 +1,119 @@
+#include "Animation.h"
+#include "simd/Kernels.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace gfx
+{
+
+// Kernels read transforms as 10 interleaved floats, like TransformBatch
+static_assert(sizeof(Transform) == 10 * sizeof(Scalar));
+
+namespace
+{
+
+// Tracks without keys hold the identity
+const Transform identity {};
+
+// Keys skipped forwards before falling back to a binary search
+constexpr std::uint32_t max_forward_steps = 4;
+
+const Scalar* floats(const Transform& t) noexcept { return reinterpret_cast<const Scalar*>(&t); }
+
+} // namespace
+
+
+AnimationTrack::AnimationTrack(std::vector<Scalar> times, std::vector<Transform> keys)
+    : _times(std::move(times))
+    , _keys(std::move(keys))
+{
+    assert(_times.size() == _keys.size());
+    assert(std::is_sorted(_times.begin(), _times.end()));
+}
+
+void AnimationTrack::add(const Scalar time, const Transform& key)
+{
+    assert(_times.empty() || time >= _times.back());
+    _times.push_back(time);
+    _keys.push_back(key);
+}
+
+std::size_t AnimationTrack::segment(const Scalar time) const noexcept
+{
+    const auto next = std::upper_bound(_times.begin(), _times.end(), time);
+    return next == _times.begin() ? 0 : std::size_t(next - _times.begin()) - 1;
+}
+
+Transform AnimationTrack::sample(const Scalar time, const Interpolation interpolation) const noexcept
+{
+    if (empty()) return identity;
+
+    const std::size_t k = segment(time);
+    if (k + 1 == size()) return _keys[k];
+
+    const Scalar α = std::clamp((time - _times[k]) / (_times[k + 1] - _times[k]), Scalar(0), Scalar(1));
+    return interpolate(_keys[k], _keys[k + 1], α, interpolation);
+}
+
+
+AnimationSampler::AnimationSampler(const std::span<const AnimationTrack> tracks)
+    : _tracks(tracks)
+    , _segments(tracks.size(), 0)
+    , _from(tracks.size())
+    , _to(tracks.size())
+    , _α(tracks.size())
+{
+}
+
+void AnimationSampler::sample(const Scalar time, const std::span<Transform> out, const Interpolation interpolation) noexcept
+{
+    assert(out.size() == _tracks.size());
+
+    for (std::size_t i = 0; i < _tracks.size(); ++i)
+    {
+        const AnimationTrack& track = _tracks[i];
+        if (track.empty())
+        {
+            _from[i] = _to[i] = floats(identity);
+            _α[i] = 0;
+            continue;
+        }
+
+        const auto times = track.times();
+        std::uint32_t k = std::min(_segments[i], std::uint32_t(times.size() - 1));
+        if (times[k] > time)
+        {
+            k = std::uint32_t(track.segment(time));
+        }
+        else
+        {
+            std::uint32_t steps = 0;
+            while (k + 1 < times.size() && times[k + 1] <= time)
+            {
+                if (++steps > max_forward_steps)
+                {
+                    k = std::uint32_t(track.segment(time));
+                    break;
+                }
+                ++k;
+            }
+        }
+        _segments[i] = k;
+
+        const auto keys = track.keys();
+        const std::uint32_t next = std::min(k + 1, std::uint32_t(keys.size() - 1));
+        _from[i] = floats(keys[k]);
+        _to[i] = floats(keys[next]);
+        _α[i] = next == k ? 0 : std::clamp((time - times[k]) / (times[next] - times[k]), Scalar(0), Scalar(1));
+    }
+
+    const auto& kernels = simd::kernels();
+    const auto blend =
+        interpolation == Interpolation::nlerp ? kernels.nlerp_transforms :
+        interpolation == Interpolation::slerp ? kernels.slerp_transforms :
+                                                kernels.fast_slerp_transforms;
+    blend(_from.data(), _to.data(), _α.data(), reinterpret_cast<Scalar*>(out.data()), out.size());
+}
+
+} // namespace gfx
@@ -0,0 +1,314 @@
+#include "Archive.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace gfx
+{
+
+static_assert(sizeof(ArchiveEntry) == 64);
+static_assert(std::numeric_limits<Scalar>::is_iec559 && std::numeric_limits<double>::is_iec559);
+
+namespace
+{
+
+struct ArchiveHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    // Reads back as another value on a machine with the other byte order
+    std::uint32_t byte_order;
+    std::uint64_t directory_offset;
+    std::uint64_t entry_count;
+    // Of the header, with this field zero, followed by the directory
+    std::uint64_t checksum;
+    std::uint8_t reserved[24];
+};
+
+static_assert(sizeof(ArchiveHeader) == ARCHIVE_ALIGNMENT);
+
+constexpr char magic[8] = { 'G', 'F', 'X', 'A', 'R', 'C', 'H', '\0' };
+constexpr std::uint32_t byte_order = 0x01020304;
+
+// Zeros between arrays
+constexpr char padding[ARCHIVE_ALIGNMENT] = {};
+
+constexpr std::uint64_t fnv_offset = 0xcbf29ce484222325;
+constexpr std::uint64_t fnv_prime = 0x100000001b3;
+
+/**
+ * Fowler, Noll and Vo, 1991, FNV-1a hash, continued from hash over bytes.
+ */
+std::uint64_t fnv1a(std::uint64_t hash, const void* data, const std::size_t bytes) noexcept
+{
+    const auto* p = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i < bytes; ++i)
+    {
+        hash = (hash ^ p[i]) * fnv_prime;
+    }
+    return hash;
+}
+
+std::uint64_t header_checksum(ArchiveHeader header, const ArchiveEntry* entries) noexcept
+{
+    header.checksum = 0;
+    const std::uint64_t hash = fnv1a(fnv_offset, &header, sizeof(header));
+    return fnv1a(hash, entries, header.entry_count * sizeof(ArchiveEntry));
+}
+
+constexpr std::uint32_t element_size(const ArchiveType type) noexcept
+{
+    switch (type)
+    {
+        case ArchiveType::vector3:     return sizeof(Vector3);
+        case ArchiveType::vector3d:    return sizeof(Vector3d);
+        case ArchiveType::quaternion:  return sizeof(Quaternion);
+        case ArchiveType::quaterniond: return sizeof(Quaterniond);
+        case ArchiveType::rotation:    return sizeof(Rotation);
+        case ArchiveType::rotationd:   return sizeof(Rotationd);
+        case ArchiveType::sphere:      return sizeof(Sphere);
+        case ArchiveType::sphered:     return sizeof(Sphered);
+        case ArchiveType::matrix3:     return sizeof(Matrix3);
+        case ArchiveType::matrix3d:    return sizeof(Matrix3d);
+        case ArchiveType::transform:   return sizeof(Transform);
+        default:                       return 0;
+    }
+}
+
+constexpr std::uint64_t align(const std::uint64_t offset) noexcept
+{
+    return (offset + ARCHIVE_ALIGNMENT - 1) / ARCHIVE_ALIGNMENT * ARCHIVE_ALIGNMENT;
+}
+
+bool is_valid(const std::byte* data, const std::size_t size) noexcept
+{
+    if (size < sizeof(ArchiveHeader)) return false;
+
+    ArchiveHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, magic, sizeof(magic)) != 0) return false;
+    if (header.version != ARCHIVE_VERSION || header.byte_order != byte_order) return false;
+
+    const std::uint64_t directory = header.directory_offset;
+    if (directory % ARCHIVE_ALIGNMENT != 0 || directory > size) return false;
+    if (header.entry_count > (size - directory) / sizeof(ArchiveEntry)) return false;
+
+    const auto* entries = reinterpret_cast<const ArchiveEntry*>(data + directory);
+    if (header_checksum(header, entries) != header.checksum) return false;
+
+    for (std::uint64_t i = 0; i < header.entry_count; ++i)
+    {
+        const ArchiveEntry& entry = entries[i];
+        if (std::memchr(entry.name, '\0', sizeof(entry.name)) == nullptr) return false;
+        // Written by a build with another Scalar or layout
+        if (entry.element_size == 0 || entry.element_size != element_size(entry.type)) return false;
+        if (entry.offset % ARCHIVE_ALIGNMENT != 0 || entry.offset > directory) return false;
+        if (entry.count > (directory - entry.offset) / entry.element_size) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+
+ArchiveWriter::ArchiveWriter(const std::string& path)
+    : _file(path, std::ios::binary)
+    , _offset(sizeof(ArchiveHeader))
+    , _finished(false)
+{
+    // Placeholder, rewritten by finish
+    const ArchiveHeader header {};
+    _file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+ArchiveWriter::~ArchiveWriter()
+{
+    if (!_finished) finish();
+}
+
+void ArchiveWriter::begin(const std::string_view name, const ArchiveType type, const std::uint32_t element_size)
+{
+    assert(!_finished);
+    assert(name.size() < sizeof(ArchiveEntry::name));
+    assert(std::none_of(_entries.begin(), _entries.end(), [&](const ArchiveEntry& e) { return e.name_view() == name; }));
+
+    const std::uint64_t offset = align(_offset);
+    _file.write(padding, std::streamsize(offset - _offset));
+    _offset = offset;
+
+    ArchiveEntry entry {};
+    name.copy(entry.name, name.size());
+    entry.type = type;
+    entry.element_size = element_size;
+    entry.offset = offset;
+    entry.checksum = fnv_offset;
+    _entries.push_back(entry);
+}
+
+void ArchiveWriter::append([[maybe_unused]] const ArchiveType type, const void* data, const std::size_t bytes)
+{
+    assert(!_finished && !_entries.empty());
+    ArchiveEntry& entry = _entries.back();
+    assert(entry.type == type);
+
+    _file.write(static_cast<const char*>(data), std::streamsize(bytes));
+    _offset += bytes;
+    entry.count += bytes / entry.element_size;
+    entry.checksum = fnv1a(entry.checksum, data, bytes);
+}
+
+bool ArchiveWriter::finish()
+{
+    assert(!_finished);
+    _finished = true;
+
+    const std::uint64_t directory = align(_offset);
+    _file.write(padding, std::streamsize(directory - _offset));
+    _file.write(reinterpret_cast<const char*>(_entries.data()), std::streamsize(_entries.size() * sizeof(ArchiveEntry)));
+
+    ArchiveHeader header {};
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = ARCHIVE_VERSION;
+    header.byte_order = byte_order;
+    header.directory_offset = directory;
+    header.entry_count = _entries.size();
+    header.checksum = header_checksum(header, _entries.data());
+
+    _file.seekp(0);
+    _file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    _file.close();
+    return !_file.fail();
+}
+
+
+MappedArchive::MappedArchive() noexcept
+    : _data(nullptr)
+    , _size(0)
+{
+}
+
+MappedArchive::MappedArchive(const std::string& path)
+    : MappedArchive()
+{
+    open(path);
+}
+
+MappedArchive::~MappedArchive()
+{
+    close();
+}
+
+MappedArchive::MappedArchive(MappedArchive&& archive) noexcept
+    : _data(std::exchange(archive._data, nullptr))
+    , _size(std::exchange(archive._size, 0))
+    , _entries(std::exchange(archive._entries, {}))
+{
+}
+
+MappedArchive& MappedArchive::operator=(MappedArchive&& archive) noexcept
+{
+    if (this != &archive)
+    {
+        close();
+        _data = std::exchange(archive._data, nullptr);
+        _size = std::exchange(archive._size, 0);
+        _entries = std::exchange(archive._entries, {});
+    }
+    return *this;
+}
+
+bool MappedArchive::open(const std::string& path)
+{
+    close();
+
+    // The mapping outlives the file handles
+#ifdef _WIN32
+    const HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size;
+    const HANDLE mapping = GetFileSizeEx(file, &size) && size.QuadPart > 0
+        ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr)
+        : nullptr;
+    CloseHandle(file);
+    if (mapping == nullptr) return false;
+
+    const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (data == nullptr) return false;
+
+    _data = static_cast<const std::byte*>(data);
+    _size = std::size_t(size.QuadPart);
+#else
+    const int file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0) return false;
+
+    struct stat status;
+    void* data = fstat(file, &status) == 0 && status.st_size > 0
+        ? mmap(nullptr, std::size_t(status.st_size), PROT_READ, MAP_SHARED, file, 0)
+        : MAP_FAILED;
+    ::close(file);
+    if (data == MAP_FAILED) return false;
+
+    _data = static_cast<const std::byte*>(data);
+    _size = std::size_t(status.st_size);
+#endif
+
+    if (!is_valid(_data, _size))
+    {
+        close();
+        return false;
+    }
+
+    ArchiveHeader header;
+    std::memcpy(&header, _data, sizeof(header));
+    _entries = { reinterpret_cast<const ArchiveEntry*>(_data + header.directory_offset), std::size_t(header.entry_count) };
+    return true;
+}
+
+void MappedArchive::close() noexcept
+{
+    if (_data == nullptr) return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(_data);
+#else
+    munmap(const_cast<std::byte*>(_data), _size);
+#endif
+    _data = nullptr;
+    _size = 0;
+    _entries = {};
+}
+
+const ArchiveEntry* MappedArchive::find(const std::string_view name) const noexcept
+{
+    const auto it = std::find_if(_entries.begin(), _entries.end(), [&](const ArchiveEntry& e) { return e.name_view() == name; });
+    return it == _entries.end() ? nullptr : &*it;
+}
+
+bool MappedArchive::verify() const noexcept
+{
+    return std::all_of(_entries.begin(), _entries.end(), [&](const ArchiveEntry& e) {
+        return fnv1a(fnv_offset, _data + e.offset, e.count * e.element_size) == e.checksum;
+    });
+}
+
+} // namespace gfx
@@ -0,0 +1,385 @@
+#include "Bvh.h"
+#include "Memory.h"
+
+#include <algorithm>
+#include <bit>
+#include <future>
+#include <thread>
+#include <utility>
+
+namespace gfx
+{
+
+static_assert(sizeof(Bvh::Node) == 32);
+
+namespace
+{
+
+struct Primitive
+{
+    BoundingBox bounds;
+    Vector3 centroid;
+    std::uint32_t index;
+};
+
+struct Bin
+{
+    BoundingBox bounds;
+    std::size_t count = 0;
+};
+
+constexpr Scalar component(const Vector3& v, const unsigned axis) noexcept
+{
+    return axis == 0 ? v.x : axis == 1 ? v.y : v.z;
+}
+
+// Cost of visiting an inner node, relative to intersecting one sphere
+constexpr Scalar traversal_cost = 1;
+
+// Leaves never grow past this, even when the heuristic does not find a better split
+constexpr std::size_t max_forced_leaf_size = 32;
+
+// Past this depth only balanced splits are made, which bounds the depth of
+// any tree built from 32-bit indices to max_sah_depth + 32
+constexpr unsigned max_sah_depth = 64;
+
+// Bins live on the stack, so splits do not allocate
+constexpr unsigned max_bins = 64;
+
+class Builder
+{
+private:
+    const BvhOptions& _options;
+    std::pmr::vector<Primitive>& _primitives;
+    // For the nodes of subtrees built on other threads
+    std::pmr::memory_resource* _scratch;
+
+public:
+    Builder(const BvhOptions& options, std::pmr::vector<Primitive>& primitives, std::pmr::memory_resource* const scratch) noexcept
+        : _options(options)
+        , _primitives(primitives)
+        , _scratch(scratch)
+    {
+    }
+
+    /**
+     * Append the subtree over primitives [begin, end) to nodes, depth-first.
+     * Inner nodes offsets are relative to the start of nodes.
+     *
+     * @param parallel_depth Levels that can still fork a thread for their second child.
+     */
+    void build(
+        std::pmr::vector<Bvh::Node>& nodes,
+        const std::size_t begin,
+        const std::size_t end,
+        const unsigned depth,
+        const unsigned parallel_depth)
+    {
+        BoundingBox bounds;
+        BoundingBox centroids;
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            bounds.expand(_primitives[i].bounds);
+            centroids.expand(_primitives[i].centroid);
+        }
+
+        const std::size_t node = nodes.size();
+        nodes.push_back({ bounds, std::uint32_t(begin), std::uint32_t(end - begin) });
+
+        const std::size_t count = end - begin;
+        if (count <= _options.max_leaf_size) return;
+
+        const std::size_t middle = depth < max_sah_depth
+            ? split(begin, end, bounds, centroids)
+            : median_split(begin, end, centroids.largest_axis());
+        if (middle == begin) return;
+
+        nodes[node].count = 0;
+        if (parallel_depth > 0 && count >= _options.parallel_threshold)
+        {
+            // Build the second child on another thread, then splice it in
+            std::pmr::vector<Bvh::Node> right(_scratch);
+            auto task = std::async(std::launch::async, [&] {
+                build(right, middle, end, depth + 1, parallel_depth - 1);
+            });
+            build(nodes, begin, middle, depth + 1, parallel_depth - 1);
+            task.get();
+
+            const std::size_t base = nodes.size();
+            nodes[node].offset = std::uint32_t(base);
+            for (Bvh::Node n : right)
+            {
+                if (!n.is_leaf()) n.offset += std::uint32_t(base);
+                nodes.push_back(n);
+            }
+        }
+        else
+        {
+            build(nodes, begin, middle, depth + 1, 0);
+            nodes[node].offset = std::uint32_t(nodes.size());
+            build(nodes, middle, end, depth + 1, 0);
+        }
+    }
+
+private:
+    std::size_t median_split(const std::size_t begin, const std::size_t end, const unsigned axis)
+    {
+        const auto first = _primitives.begin() + begin;
+        const auto middle = first + (end - begin) / 2;
+        std::nth_element(first, middle, _primitives.begin() + end, [&](const Primitive& a, const Primitive& b) {
+            return component(a.centroid, axis) < component(b.centroid, axis);
+        });
+        return std::size_t(middle - _primitives.begin());
+    }
+
+    /**
+     * Partition [begin, end) along the cheapest split plane.
+     *
+     * @return Start of the second half, or begin if a leaf is cheaper.
+     */
+    std::size_t split(const std::size_t begin, const std::size_t end, const BoundingBox& bounds, const BoundingBox& centroids)
+    {
+        const std::size_t count = end - begin;
+        const unsigned axis = centroids.largest_axis();
+        const Scalar low = component(centroids.min, axis);
+        const Scalar extent = component(centroids.max, axis) - low;
+
+        // All centroids in the same spot: no plane separates them
+        if (extent <= 0) return count > max_forced_leaf_size ? median_split(begin, end, axis) : begin;
+
+        const unsigned n_bins = std::clamp(_options.bins, 2u, max_bins);
+        const Scalar scale = n_bins / extent;
+        const auto bin_of = [&](const Primitive& p) {
+            const auto b = unsigned((component(p.centroid, axis) - low) * scale);
+            return std::min(b, n_bins - 1);
+        };
+
+        Bin bins[max_bins];
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            Bin& bin = bins[bin_of(_primitives[i])];
+            bin.bounds.expand(_primitives[i].bounds);
+            ++bin.count;
+        }
+
+        // Sweep from the right to get the cost of every right half, then from the left
+        Scalar right_cost[max_bins] = {};
+        BoundingBox right;
+        std::size_t right_count = 0;
+        for (unsigned b = n_bins - 1; b > 0; --b)
+        {
+            right.expand(bins[b].bounds);
+            right_count += bins[b].count;
+            right_cost[b] = right.surface_area() * right_count;
+        }
+
+        unsigned best_bin = 0;
+        Scalar best_cost = INFINITY;
+        BoundingBox left;
+        std::size_t left_count = 0;
+        for (unsigned b = 1; b < n_bins; ++b)
+        {
+            left.expand(bins[b - 1].bounds);
+            left_count += bins[b - 1].count;
+            const Scalar cost = left.surface_area() * left_count + right_cost[b];
+            if (left_count > 0 && left_count < count && cost < best_cost)
+            {
+                best_cost = cost;
+                best_bin = b;
+            }
+        }
+
+        const Scalar leaf_cost = count;
+        const Scalar split_cost = traversal_cost + best_cost / bounds.surface_area();
+        if (split_cost >= leaf_cost && count <= max_forced_leaf_size) return begin;
+
+        // Every centroid fell in the same bin
+        if (best_bin == 0) return median_split(begin, end, axis);
+
+        const auto first = _primitives.begin() + begin;
+        const auto middle = std::partition(first, _primitives.begin() + end, [&](const Primitive& p) {
+            return bin_of(p) < best_bin;
+        });
+        return std::size_t(middle - _primitives.begin());
+    }
+};
+
+struct Traversal
+{
+    Vector3 origin;
+    Vector3 dir;
+    Vector3 inv_dir;
+
+    explicit Traversal(const Ray& ray) noexcept
+        : origin(ray.start())
+        , dir(ray.dir())
+        , inv_dir { 1 / dir.x, 1 / dir.y, 1 / dir.z }
+    {
+    }
+
+    /**
+     * Slab test: distance at which the ray enters box, or infinity if it misses it within [t_min, t_max].
+     */
+    Scalar enter(const BoundingBox& box, const Scalar t_min, const Scalar t_max) const noexcept
+    {
+        const Vector3 t1 = { (box.min.x - origin.x) * inv_dir.x, (box.min.y - origin.y) * inv_dir.y, (box.min.z - origin.z) * inv_dir.z };
+        const Vector3 t2 = { (box.max.x - origin.x) * inv_dir.x, (box.max.y - origin.y) * inv_dir.y, (box.max.z - origin.z) * inv_dir.z };
+
+        const Scalar t_near = std::max({ std::min(t1.x, t2.x), std::min(t1.y, t2.y), std::min(t1.z, t2.z), t_min });
+        const Scalar t_far  = std::min({ std::max(t1.x, t2.x), std::max(t1.y, t2.y), std::max(t1.z, t2.z), t_max });
+        return t_near <= t_far ? t_near : INFINITY;
+    }
+};
+
+// Deep enough for any tree the builder makes
+constexpr std::size_t stack_size = max_sah_depth + 32;
+
+} // namespace
+
+
+Bvh::Bvh(std::pmr::memory_resource* const memory) noexcept
+    : _nodes(memory)
+    , _spheres(memory)
+    , _indices(memory)
+{
+}
+
+Bvh::Bvh(const std::span<const Sphere> spheres, const BvhOptions& options, std::pmr::memory_resource* const memory)
+    : Bvh(memory)
+{
+    build(spheres, options);
+}
+
+void Bvh::build(const std::span<const Sphere> spheres, const BvhOptions& options, std::pmr::memory_resource* const scratch)
+{
+    _nodes.clear();
+    _spheres.clear();
+    _indices.clear();
+    if (spheres.empty()) return;
+
+    std::pmr::vector<Primitive> primitives(spheres.size(), scratch);
+    for (std::size_t i = 0; i < spheres.size(); ++i)
+    {
+        primitives[i] = { BoundingBox::of(spheres[i]), spheres[i].center, std::uint32_t(i) };
+    }
+
+    const unsigned threads = options.threads ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    // Forking at the top log2(threads) levels keeps every thread busy
+    const unsigned parallel_depth = std::bit_width(threads - 1);
+
+    const bool parallel = parallel_depth > 0 && spheres.size() >= options.parallel_threshold;
+    LockedResource locked(scratch);
+
+    _nodes.reserve(2 * spheres.size() / std::max(1u, options.max_leaf_size) + 1);
+    Builder(options, primitives, parallel ? &locked : scratch).build(_nodes, 0, primitives.size(), 0, parallel_depth);
+
+    _spheres.reserve(spheres.size());
+    _indices.reserve(spheres.size());
+    for (const Primitive& p : primitives)
+    {
+        _spheres.push_back(spheres[p.index]);
+        _indices.push_back(p.index);
+    }
+}
+
+Hit Bvh::closest_hit(const Ray& ray, const Scalar t_min, const Scalar t_max) const noexcept
+{
+    if (_nodes.empty()) return {};
+
+    const Traversal r(ray);
+    Scalar closest = t_max;
+    std::size_t closest_sphere = _spheres.size();
+
+    if (std::isinf(r.enter(_nodes[0].bounds, t_min, closest))) return {};
+
+    std::uint32_t stack[stack_size];
+    std::size_t top = 0;
+    std::uint32_t node = 0;
+    while (true)
+    {
+        const Node& n = _nodes[node];
+        if (n.is_leaf())
+        {
+            for (std::uint32_t i = n.offset; i < n.offset + n.count; ++i)
+            {
+                const Scalar t = ray.hit_distance(_spheres[i], t_min, closest);
+                if (t < closest)
+                {
+                    closest = t;
+                    closest_sphere = i;
+                }
+            }
+        }
+        else
+        {
+            // Visit the nearest child first, so that hits in it prune the other one
+            std::uint32_t near = node + 1;
+            std::uint32_t far = n.offset;
+            Scalar t_near = r.enter(_nodes[near].bounds, t_min, closest);
+            Scalar t_far = r.enter(_nodes[far].bounds, t_min, closest);
+            if (t_far < t_near)
+            {
+                std::swap(near, far);
+                std::swap(t_near, t_far);
+            }
+
+            if (!std::isinf(t_near))
+            {
+                if (!std::isinf(t_far)) stack[top++] = far;
+                node = near;
+                continue;
+            }
+        }
+
+        if (top == 0) break;
+        node = stack[--top];
+    }
+
+    if (closest_sphere == _spheres.size()) return {};
+
+    // Hit point and normal only for the closest sphere
+    Hit hit = ray.closest_hit(_spheres[closest_sphere], t_min, t_max);
+    hit.primitive = _indices[closest_sphere];
+    return hit;
+}
+
+bool Bvh::any_hit(const Ray& ray, const Scalar t_min, const Scalar t_max) const noexcept
+{
+    if (_nodes.empty()) return false;
+
+    const Traversal r(ray);
+    if (std::isinf(r.enter(_nodes[0].bounds, t_min, t_max))) return false;
+
+    std::uint32_t stack[stack_size];
+    std::size_t top = 0;
+    std::uint32_t node = 0;
+    while (true)
+    {
+        const Node& n = _nodes[node];
+        if (n.is_leaf())
+        {
+            for (std::uint32_t i = n.offset; i < n.offset + n.count; ++i)
+            {
+                if (ray.any_hit(_spheres[i], t_min, t_max)) return true;
+            }
+        }
+        else
+        {
+            // Order does not matter, any hit ends the query
+            const bool left = !std::isinf(r.enter(_nodes[node + 1].bounds, t_min, t_max));
+            const bool right = !std::isinf(r.enter(_nodes[n.offset].bounds, t_min, t_max));
+            if (left || right)
+            {
+                if (left && right) stack[top++] = n.offset;
+                node = left ? node + 1 : n.offset;
+                continue;
+            }
+        }
+
+        if (top == 0) break;
+        node = stack[--top];
+    }
+    return false;
+}
+
+} // namespace gfx
@@ -0,0 +1,81 @@
+#include "Frustum.h"
+#include "simd/Kernels.h"
+
+#include <cassert>
+
+namespace gfx
+{
+
+// Kernels read frusta as 6 interleaved (normal x, y, z, distance) planes
+static_assert(sizeof(Frustum) == 24 * sizeof(Scalar));
+
+namespace
+{
+
+// Kernels store the masks of 32 frusta at most
+constexpr std::size_t max_frusta = 32;
+
+simd::ConstSoA soa(const ConstVector3Span v) noexcept { return { v.x(), v.y(), v.z() }; }
+
+const Scalar* planes(const std::span<const Frustum> frusta) noexcept
+{
+    return reinterpret_cast<const Scalar*>(frusta.data());
+}
+
+} // namespace
+
+
+std::size_t cull_spheres(
+    const ConstVector3Span centers,
+    const std::span<const Scalar> radii,
+    const Frustum& frustum,
+    const std::span<std::uint32_t> visible) noexcept
+{
+    std::size_t count;
+    cull_spheres(centers, radii, { &frustum, 1 }, { &visible, 1 }, { &count, 1 });
+    return count;
+}
+
+std::pmr::vector<std::uint32_t> visible_spheres(
+    const ConstVector3Span centers,
+    const std::span<const Scalar> radii,
+    const Frustum& frustum,
+    std::pmr::memory_resource* const memory)
+{
+    std::pmr::vector<std::uint32_t> visible(radii.size(), memory);
+    visible.resize(cull_spheres(centers, radii, frustum, std::span(visible)));
+    return visible;
+}
+
+void cull_spheres(
+    const ConstVector3Span centers,
+    const std::span<const Scalar> radii,
+    const std::span<const Frustum> frusta,
+    const std::span<std::uint32_t> masks) noexcept
+{
+    assert(centers.size() == radii.size() && radii.size() == masks.size());
+    assert(frusta.size() <= max_frusta);
+    simd::kernels().cull_spheres(soa(centers), radii.data(), radii.size(), planes(frusta), frusta.size(), masks.data(), nullptr, nullptr);
+}
+
+void cull_spheres(
+    const ConstVector3Span centers,
+    const std::span<const Scalar> radii,
+    const std::span<const Frustum> frusta,
+    const std::span<const std::span<std::uint32_t>> visible,
+    const std::span<std::size_t> counts) noexcept
+{
+    assert(centers.size() == radii.size());
+    assert(frusta.size() == visible.size() && visible.size() == counts.size());
+    assert(frusta.size() <= max_frusta);
+
+    std::uint32_t* lists[max_frusta];
+    for (std::size_t f = 0; f < frusta.size(); ++f)
+    {
+        assert(visible[f].size() >= radii.size());
+        lists[f] = visible[f].data();
+    }
+    simd::kernels().cull_spheres(soa(centers), radii.data(), radii.size(), planes(frusta), frusta.size(), nullptr, lists, counts.data());
+}
+
+} // namespace gfx
@@ -0,0 +1,86 @@
+#include "Image.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+
+namespace gfx
+{
+
+namespace
+{
+
+std::uint8_t srgb(const Scalar linear) noexcept
+{
+    const Scalar c = std::clamp<Scalar>(linear, 0, 1);
+    const Scalar encoded = c <= 0.0031308f ? 12.92f * c : 1.055f * std::pow(c, 1 / 2.4f) - 0.055f;
+    return std::uint8_t(std::lround(encoded * 255));
+}
+
+} // namespace
+
+
+Image::Image() noexcept
+    : _width(0)
+    , _height(0)
+{
+}
+
+Image::Image(const unsigned width, const unsigned height)
+    : _width(width)
+    , _height(height)
+    , _pixels(std::size_t(width) * height, Vector3::zero())
+{
+}
+
+bool Image::write_ppm(const std::string& path) const
+{
+    std::ofstream file(path, std::ios::binary);
+    file << "P6\n" << _width << " " << _height << "\n255\n";
+
+    std::vector<std::uint8_t> row(3 * std::size_t(_width));
+    for (unsigned y = 0; y < _height; ++y)
+    {
+        for (unsigned x = 0; x < _width; ++x)
+        {
+            const Vector3& c = at(x, y);
+            row[3 * x + 0] = srgb(c.x);
+            row[3 * x + 1] = srgb(c.y);
+            row[3 * x + 2] = srgb(c.z);
+        }
+        file.write(reinterpret_cast<const char*>(row.data()), std::streamsize(row.size()));
+    }
+    return bool(file);
+}
+
+bool Image::write_pfm(const std::string& path) const
+{
+    std::ofstream file(path, std::ios::binary);
+    // Negative scale means little endian
+    file << "PF\n" << _width << " " << _height << "\n-1.0\n";
+
+    // Rows go from the bottom to the top
+    std::vector<std::uint8_t> row(12 * std::size_t(_width));
+    for (unsigned y = _height; y-- > 0;)
+    {
+        for (unsigned x = 0; x < _width; ++x)
+        {
+            const Vector3& c = at(x, y);
+            const float rgb[3] = { c.x, c.y, c.z };
+            for (unsigned k = 0; k < 3; ++k)
+            {
+                const auto bits = std::bit_cast<std::uint32_t>(rgb[k]);
+                for (unsigned byte = 0; byte < 4; ++byte)
+                {
+                    row[12 * x + 4 * k + byte] = std::uint8_t(bits >> (8 * byte));
+                }
+            }
+        }
+        file.write(reinterpret_cast<const char*>(row.data()), std::streamsize(row.size()));
+    }
+    return bool(file);
+}
+
+} // namespace gfx
@@ -0,0 +1,43 @@
+#include "Matrix3Batch.h"
+#include "simd/Kernels.h"
+
+#include <cassert>
+
+namespace gfx
+{
+
+// Kernels read matrices as 9 row-major floats, and vectors as interleaved floats
+static_assert(sizeof(Matrix3) == 9 * sizeof(Scalar));
+static_assert(sizeof(Vector3) == 3 * sizeof(Scalar));
+
+void multiply(const Matrix3& M, const std::span<const Vector3> points, const std::span<Vector3> out) noexcept
+{
+    assert(points.size() == out.size());
+    simd::kernels().rotate_xyz(
+        M.row_major().data(),
+        reinterpret_cast<const Scalar*>(points.data()),
+        reinterpret_cast<Scalar*>(out.data()),
+        out.size());
+}
+
+void multiply(const Matrix3& M, const std::span<Vector3> points) noexcept
+{
+    multiply(M, points, points);
+}
+
+void multiply(const Matrix3& M, const ConstVector3Span points, const Vector3Span out) noexcept
+{
+    assert(points.size() == out.size());
+    simd::kernels().rotate(
+        M.row_major().data(),
+        { points.x(), points.y(), points.z() },
+        { out.x(), out.y(), out.z() },
+        out.size());
+}
+
+void multiply(const Matrix3& M, const Vector3Span points) noexcept
+{
+    multiply(M, points, points);
+}
+
+} // namespace gfx
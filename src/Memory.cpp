@@ -0,0 +1,213 @@
+#include "Memory.h"
+
+#include <algorithm>
+#include <memory>
+
+namespace gfx
+{
+
+namespace
+{
+
+constexpr std::size_t chunk_alignment = alignof(std::max_align_t);
+constexpr std::size_t min_chunk_size = 4096;
+
+constexpr std::size_t round_up(const std::size_t bytes, const std::size_t alignment) noexcept
+{
+    return (bytes + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+
+struct LinearArena::Chunk
+{
+    Chunk* next;
+    std::size_t bytes;
+    std::size_t alignment;
+};
+
+LinearArena::LinearArena(const std::size_t capacity, std::pmr::memory_resource* const upstream)
+    : _upstream(upstream)
+    , _buffer(capacity == 0 ? nullptr : static_cast<std::byte*>(upstream->allocate(capacity, chunk_alignment)))
+    , _capacity(capacity)
+    , _owned(true)
+    , _next(_buffer)
+    , _end(_buffer + capacity)
+    , _chunks(nullptr)
+    , _chunk_bytes(0)
+{
+}
+
+LinearArena::LinearArena(const std::span<std::byte> buffer, std::pmr::memory_resource* const upstream) noexcept
+    : _upstream(upstream)
+    , _buffer(buffer.data())
+    , _capacity(buffer.size())
+    , _owned(false)
+    , _next(_buffer)
+    , _end(_buffer + buffer.size())
+    , _chunks(nullptr)
+    , _chunk_bytes(0)
+{
+}
+
+LinearArena::~LinearArena()
+{
+    release_chunks();
+    if (_owned && _buffer) _upstream->deallocate(_buffer, _capacity, chunk_alignment);
+}
+
+void LinearArena::release_chunks() noexcept
+{
+    while (_chunks)
+    {
+        Chunk* const next = _chunks->next;
+        _upstream->deallocate(_chunks, _chunks->bytes, _chunks->alignment);
+        _chunks = next;
+    }
+    _chunk_bytes = 0;
+}
+
+void LinearArena::reset()
+{
+    if (_chunks)
+    {
+        // The next frame fits in one buffer if it allocates no more than this one
+        const std::size_t capacity = _capacity + _chunk_bytes;
+        release_chunks();
+        if (_owned && _buffer) _upstream->deallocate(_buffer, _capacity, chunk_alignment);
+        // Left empty if allocating throws
+        _buffer = nullptr;
+        _capacity = 0;
+        _owned = true;
+        _buffer = static_cast<std::byte*>(_upstream->allocate(capacity, chunk_alignment));
+        _capacity = capacity;
+    }
+    _next = _buffer;
+    _end = _buffer + _capacity;
+}
+
+void* LinearArena::do_allocate(const std::size_t bytes, const std::size_t alignment)
+{
+    void* p = _next;
+    std::size_t space = static_cast<std::size_t>(_end - _next);
+    if (!std::align(alignment, bytes, p, space))
+    {
+        // Doubling the space at each chunk, the chunk header before the data
+        const std::size_t align = std::max(alignment, chunk_alignment);
+        const std::size_t header = round_up(sizeof(Chunk), align);
+        const std::size_t size = std::max({ header + bytes, _capacity + _chunk_bytes, min_chunk_size });
+        auto* const chunk = static_cast<Chunk*>(_upstream->allocate(size, align));
+        *chunk = { _chunks, size, align };
+        _chunks = chunk;
+        _chunk_bytes += size;
+
+        p = reinterpret_cast<std::byte*>(chunk) + header;
+        _end = reinterpret_cast<std::byte*>(chunk) + size;
+    }
+    _next = static_cast<std::byte*>(p) + bytes;
+    return p;
+}
+
+void LinearArena::do_deallocate(void*, std::size_t, std::size_t)
+{
+}
+
+bool LinearArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+
+struct BlockPool::Chunk
+{
+    Chunk* next;
+    std::size_t bytes;
+};
+
+BlockPool::BlockPool(const std::size_t block_size, const std::size_t blocks_per_chunk, std::pmr::memory_resource* const upstream)
+    : _upstream(upstream)
+    , _block_size(round_up(std::max(block_size, sizeof(void*)), alignment))
+    , _blocks_per_chunk(std::max<std::size_t>(blocks_per_chunk, 1))
+    , _free(nullptr)
+    , _chunks(nullptr)
+{
+}
+
+BlockPool::~BlockPool()
+{
+    while (_chunks)
+    {
+        Chunk* const next = _chunks->next;
+        _upstream->deallocate(_chunks, _chunks->bytes, alignment);
+        _chunks = next;
+    }
+}
+
+void BlockPool::add_chunk(const std::size_t blocks)
+{
+    const std::size_t header = round_up(sizeof(Chunk), alignment);
+    const std::size_t size = header + blocks * _block_size;
+    auto* const chunk = static_cast<Chunk*>(_upstream->allocate(size, alignment));
+    *chunk = { _chunks, size };
+    _chunks = chunk;
+
+    // Threading the free list through the new blocks, the first one ending up at its head
+    std::byte* const first = reinterpret_cast<std::byte*>(chunk) + header;
+    for (std::size_t k = blocks; k-- > 0;)
+    {
+        void* const block = first + k * _block_size;
+        *static_cast<void**>(block) = _free;
+        _free = block;
+    }
+}
+
+void BlockPool::reserve(const std::size_t blocks)
+{
+    std::size_t available = 0;
+    for (void* block = _free; block && available < blocks; block = *static_cast<void**>(block)) ++available;
+    if (available < blocks) add_chunk(std::max(blocks - available, _blocks_per_chunk));
+}
+
+void* BlockPool::do_allocate(const std::size_t bytes, const std::size_t alignment)
+{
+    if (bytes > _block_size || alignment > BlockPool::alignment) return _upstream->allocate(bytes, alignment);
+
+    if (!_free) add_chunk(_blocks_per_chunk);
+    void* const block = _free;
+    _free = *static_cast<void**>(block);
+    return block;
+}
+
+void BlockPool::do_deallocate(void* const p, const std::size_t bytes, const std::size_t alignment)
+{
+    if (bytes > _block_size || alignment > BlockPool::alignment) return _upstream->deallocate(p, bytes, alignment);
+
+    *static_cast<void**>(p) = _free;
+    _free = p;
+}
+
+bool BlockPool::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+
+void* LockedResource::do_allocate(const std::size_t bytes, const std::size_t alignment)
+{
+    const std::lock_guard lock(_mutex);
+    return _upstream->allocate(bytes, alignment);
+}
+
+void LockedResource::do_deallocate(void* const p, const std::size_t bytes, const std::size_t alignment)
+{
+    const std::lock_guard lock(_mutex);
+    _upstream->deallocate(p, bytes, alignment);
+}
+
+bool LockedResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+} // namespace gfx
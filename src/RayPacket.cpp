@@ -0,0 +1,31 @@
+#include "RayPacket.h"
+#include "simd/Kernels.h"
+
+#include <cassert>
+
+namespace gfx
+{
+
+// Kernels read spheres as interleaved (x, y, z, radius) floats
+static_assert(sizeof(Sphere) == 4 * sizeof(Scalar));
+static_assert(no_hit == simd::no_hit);
+
+void intersect(
+    const ConstVector3Span starts,
+    const ConstVector3Span dirs,
+    const std::span<const Sphere> spheres,
+    const std::span<Scalar> t,
+    const std::span<std::uint32_t> sphere) noexcept
+{
+    assert(starts.size() == dirs.size() && dirs.size() == t.size() && t.size() == sphere.size());
+    simd::kernels().intersect_spheres(
+        { starts.x(), starts.y(), starts.z() },
+        { dirs.x(), dirs.y(), dirs.z() },
+        t.size(),
+        reinterpret_cast<const Scalar*>(spheres.data()),
+        spheres.size(),
+        t.data(),
+        sphere.data());
+}
+
+} // namespace gfx
@@ -0,0 +1,91 @@
+#include "Renderer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+
+namespace gfx
+{
+
+namespace
+{
+
+// Stable, well spread color for each sphere
+Vector3 albedo(std::uint32_t index) noexcept
+{
+    index = (index ^ 61) ^ (index >> 16);
+    index *= 9;
+    index ^= index >> 4;
+    index *= 0x27d4eb2d;
+    index ^= index >> 15;
+
+    const auto channel = [&](const unsigned shift) {
+        return 0.25f + 0.75f * Scalar((index >> shift) & 0xff) / 255;
+    };
+    return { channel(0), channel(8), channel(16) };
+}
+
+Vector3 shade(const Ray& ray, const Scene& scene, const RenderOptions& options, const Vector3& light) noexcept
+{
+    const Hit hit = scene.bvh.closest_hit(ray);
+    if (!hit)
+    {
+        // Slight vertical gradient, to tell the sky from the floor
+        return options.background * (1 + 0.5f * ray.dir().y);
+    }
+
+    const Vector3 n = hit.normal;
+    Scalar diffuse = std::max<Scalar>(0, dot(n, light));
+    if (diffuse > 0 && options.shadows)
+    {
+        // Offset the start to avoid hitting the same surface
+        const Scalar radius = std::abs(scene.spheres[hit.primitive].radius);
+        const Ray shadow = { hit.point + n * (1e-3f * radius), light };
+        if (scene.bvh.any_hit(shadow)) diffuse = 0;
+    }
+
+    return albedo(hit.primitive) * (options.ambient + (1 - options.ambient) * diffuse);
+}
+
+} // namespace
+
+
+Scene::Scene(std::vector<Sphere> spheres)
+    : spheres(std::move(spheres))
+    , bvh(this->spheres)
+{
+}
+
+Image render(const Camera& camera, const Scene& scene, const RenderOptions& options, ThreadPool& pool)
+{
+    Image image(options.width, options.height);
+    if (options.width == 0 || options.height == 0) return image;
+
+    const unsigned tile = std::max(1u, options.tile_size);
+    const unsigned tiles_x = (options.width + tile - 1) / tile;
+    const unsigned tiles_y = (options.height + tile - 1) / tile;
+    const Scalar aspect = Scalar(options.width) / options.height;
+    const Vector3 light = options.light.normalized();
+
+    pool.parallel_for(std::size_t(tiles_x) * tiles_y, [&](const std::size_t t) {
+        const unsigned x0 = unsigned(t % tiles_x) * tile;
+        const unsigned y0 = unsigned(t / tiles_x) * tile;
+        const unsigned x1 = std::min(x0 + tile, options.width);
+        const unsigned y1 = std::min(y0 + tile, options.height);
+
+        for (unsigned y = y0; y < y1; ++y)
+        {
+            for (unsigned x = x0; x < x1; ++x)
+            {
+                const Scalar u = (x + 0.5f) / options.width;
+                const Scalar v = (y + 0.5f) / options.height;
+                image.at(x, y) = shade(camera.ray(u, v, aspect), scene, options, light);
+            }
+        }
+    });
+
+    return image;
+}
+
+} // namespace gfx
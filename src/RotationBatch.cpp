@@ -0,0 +1,179 @@
+#include "RotationBatch.h"
+#include "Matrix3Batch.h"
+#include "simd/Kernels.h"
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+namespace gfx
+{
+
+// Kernels read these as plain interleaved floats
+static_assert(sizeof(Vector3) == 3 * sizeof(Scalar));
+static_assert(sizeof(Rotation) == 4 * sizeof(Scalar));
+static_assert(sizeof(Matrix3) == 9 * sizeof(Scalar));
+static_assert(simd::renormalize_limit == RENORMALIZE_LIMIT);
+
+void rotate(const Rotation& rotation, const std::span<const Vector3> points, const std::span<Vector3> out) noexcept
+{
+    multiply(rotation.as_matrix3(), points, out);
+}
+
+void rotate(const Rotation& rotation, const std::span<Vector3> points) noexcept
+{
+    rotate(rotation, points, points);
+}
+
+void rotate(const Rotation& rotation, const ConstVector3Span points, const Vector3Span out) noexcept
+{
+    multiply(rotation.as_matrix3(), points, out);
+}
+
+void rotate(const Rotation& rotation, const Vector3Span points) noexcept
+{
+    rotate(rotation, points, points);
+}
+
+void rotate(const std::span<const Rotation> rotations, const std::span<const Vector3> points, const std::span<Vector3> out) noexcept
+{
+    assert(rotations.size() == points.size() && points.size() == out.size());
+    simd::kernels().rotate_each_xyz(
+        reinterpret_cast<const Scalar*>(rotations.data()),
+        reinterpret_cast<const Scalar*>(points.data()),
+        reinterpret_cast<Scalar*>(out.data()),
+        out.size());
+}
+
+void rotations_from_matrices(
+    const std::span<const Matrix3> matrices,
+    const std::span<Rotation> out,
+    const Orthonormalize orthonormalize) noexcept
+{
+    assert(matrices.size() == out.size());
+    const auto kernel = orthonormalize == Orthonormalize::yes
+        ? simd::kernels().rotations_from_drifted_matrices
+        : simd::kernels().rotations_from_matrices;
+    kernel(
+        reinterpret_cast<const Scalar*>(matrices.data()),
+        reinterpret_cast<Scalar*>(out.data()),
+        out.size());
+}
+
+namespace
+{
+
+simd::EulerTerms euler_terms(const EulerOrder order) noexcept
+{
+    const std::array<unsigned, 3> components = euler_angle_components(order);
+    const EulerProduct product = euler_product(order);
+
+    simd::EulerTerms terms;
+    for (unsigned k = 0; k < 3; ++k) terms.angle[k] = std::uint8_t(components[k]);
+    for (unsigned i = 0; i < 4; ++i)
+    {
+        for (unsigned t = 0; t < 2; ++t)
+        {
+            terms.sines[i][t] = std::uint8_t(product.terms[i][t].sines);
+            terms.sign[i][t] = float(product.terms[i][t].sign);
+        }
+    }
+    return terms;
+}
+
+} // namespace
+
+void rotations_from_euler(
+    const std::span<const Vector3> angles,
+    const std::span<Rotation> out,
+    const EulerOrder order) noexcept
+{
+    assert(angles.size() == out.size());
+    simd::kernels().rotations_from_euler(
+        reinterpret_cast<const Scalar*>(angles.data()),
+        euler_terms(order),
+        reinterpret_cast<Scalar*>(out.data()),
+        out.size());
+}
+
+void cumulative_rotations(
+    const std::span<const Rotation> rotations,
+    const std::span<Rotation> out,
+    const std::size_t renormalize_interval) noexcept
+{
+    assert(rotations.size() == out.size());
+    simd::kernels().prefix_rotations(
+        reinterpret_cast<const Scalar*>(rotations.data()),
+        reinterpret_cast<Scalar*>(out.data()),
+        out.size(),
+        renormalize_interval);
+}
+
+void cumulative_rotations(
+    const std::span<const Rotation> rotations,
+    const std::span<Rotation> out,
+    ThreadPool& pool,
+    const std::size_t renormalize_interval)
+{
+    assert(rotations.size() == out.size());
+
+    // Blocks long enough to pay for the second pass over them
+    constexpr std::size_t min_block_size = 1 << 14;
+    const std::size_t n = out.size();
+    const std::size_t blocks = std::min<std::size_t>(pool.size(), n / min_block_size);
+    if (blocks <= 1) return cumulative_rotations(rotations, out, renormalize_interval);
+
+    const simd::KernelTable& kernels = simd::kernels();
+    const auto* const q = reinterpret_cast<const Scalar*>(rotations.data());
+    auto* const r = reinterpret_cast<Scalar*>(out.data());
+    const auto begin = [&](const std::size_t block) { return n * block / blocks; };
+
+    pool.parallel_for(blocks, [&](const std::size_t block) {
+        kernels.prefix_rotations(q + 4 * begin(block), r + 4 * begin(block), begin(block + 1) - begin(block), renormalize_interval);
+    });
+
+    // Block b starts from the product of the ends of the blocks before it
+    std::vector<Quaternion> carries(blocks);
+    carries[1] = out[begin(1) - 1].as_quaternion();
+    for (std::size_t block = 2; block < blocks; ++block)
+    {
+        carries[block] = carries[block - 1] * out[begin(block) - 1].as_quaternion();
+        if (renormalize_interval != 0) carries[block].normalize();
+    }
+
+    pool.parallel_for(blocks - 1, [&](const std::size_t i) {
+        const std::size_t block = i + 1;
+        kernels.premultiply_rotations(
+            reinterpret_cast<const Scalar*>(&carries[block]),
+            r + 4 * begin(block),
+            begin(block + 1) - begin(block));
+    });
+}
+
+void integrate_angular_velocities(
+    const std::span<Rotation> orientations,
+    const std::span<const Vector3> angular_velocities,
+    const Scalar dt) noexcept
+{
+    assert(orientations.size() == angular_velocities.size());
+    simd::kernels().integrate_angular_velocities(
+        reinterpret_cast<Scalar*>(orientations.data()),
+        reinterpret_cast<const Scalar*>(angular_velocities.data()),
+        dt,
+        orientations.size());
+}
+
+void integrate_angular_velocities(
+    const std::span<Rotation> orientations,
+    const std::span<const Vector3> angular_velocities,
+    const Scalar dt,
+    ThreadPool& pool,
+    const std::size_t grain)
+{
+    assert(orientations.size() == angular_velocities.size());
+    pool.parallel_for(orientations.size(), grain, [&](const std::size_t begin, const std::size_t end) {
+        integrate_angular_velocities(orientations.subspan(begin, end - begin), angular_velocities.subspan(begin, end - begin), dt);
+    });
+}
+
+} // namespace gfx
@@ -0,0 +1,43 @@
+#include "RotationEncoding.h"
+#include "simd/Kernels.h"
+
+#include <cassert>
+#include <cstdint>
+
+namespace gfx
+{
+
+// Kernels read rotations as (x, y, z, w) quaternions
+static_assert(sizeof(Rotation) == 4 * sizeof(Scalar));
+
+void encode_rotations(const std::span<const Rotation> rotations, const std::span<std::byte> out, const RotationEncoding encoding) noexcept
+{
+    assert(out.size() >= rotations.size() * bytes_per_rotation(encoding));
+
+    const auto& kernels = simd::kernels();
+    const auto encode =
+        encoding == RotationEncoding::smallest_three_32 ? kernels.encode_rotations_32 :
+        encoding == RotationEncoding::smallest_three_48 ? kernels.encode_rotations_48 :
+                                                          kernels.encode_rotations_64;
+    encode(
+        reinterpret_cast<const Scalar*>(rotations.data()),
+        reinterpret_cast<std::uint8_t*>(out.data()),
+        rotations.size());
+}
+
+void decode_rotations(const std::span<const std::byte> packed, const std::span<Rotation> out, const RotationEncoding encoding) noexcept
+{
+    assert(packed.size() >= out.size() * bytes_per_rotation(encoding));
+
+    const auto& kernels = simd::kernels();
+    const auto decode =
+        encoding == RotationEncoding::smallest_three_32 ? kernels.decode_rotations_32 :
+        encoding == RotationEncoding::smallest_three_48 ? kernels.decode_rotations_48 :
+                                                          kernels.decode_rotations_64;
+    decode(
+        reinterpret_cast<const std::uint8_t*>(packed.data()),
+        reinterpret_cast<Scalar*>(out.data()),
+        out.size());
+}
+
+} // namespace gfx
@@ -0,0 +1,248 @@
+#include "RotationSpline.h"
+#include "simd/Kernels.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace gfx
+{
+
+// Kernels read rotations as (x, y, z, w) quaternions
+static_assert(sizeof(Rotation) == 4 * sizeof(Scalar));
+
+namespace
+{
+
+// Controls of empty splines, identities wherever either kernel reads a quaternion, and null logarithms
+const Scalar identity[24] = {
+    0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1,
+    0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1,
+};
+
+// Keys skipped forwards before falling back to a binary search
+constexpr std::uint32_t max_forward_steps = 4;
+
+// Floats per key of the controls
+constexpr std::size_t squad_stride = 12;
+constexpr std::size_t b_spline_stride = 8;
+
+std::size_t stride(const RotationSplineType type) noexcept
+{
+    return type == RotationSplineType::squad ? squad_stride : b_spline_stride;
+}
+
+/**
+ * Logarithm of the step from a to b, relative to a: b = a exp(log_step(a, b)).
+ */
+Vector3 log_step(const Quaternion& a, const Quaternion& b) noexcept
+{
+    return Rotation::from_quaternion(a.conjugated() * b).log();
+}
+
+/**
+ * a exp(v).
+ */
+Quaternion times_exp(const Quaternion& a, const Vector3& v) noexcept
+{
+    return a * Rotation::from_log(v).as_quaternion();
+}
+
+void append(std::vector<Scalar>& controls, const Quaternion& q)
+{
+    controls.insert(controls.end(), { q.imaginary.x, q.imaginary.y, q.imaginary.z, q.real });
+}
+
+void append(std::vector<Scalar>& controls, const Quaternion& q, const Vector3& ω)
+{
+    append(controls, q);
+    controls.insert(controls.end(), { ω.x, ω.y, ω.z, 0 });
+}
+
+void build_squad(std::span<const Scalar> t, std::span<const Quaternion> q, std::vector<Scalar>& controls)
+{
+    const std::size_t n = q.size();
+    controls.reserve(squad_stride * n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        // Logarithms of the steps to the next and previous keys, over the durations of their segments
+        const bool has_after = i + 1 < n && t[i + 1] > t[i];
+        const bool has_before = i > 0 && t[i] > t[i - 1];
+        if (!has_after && !has_before)
+        {
+            append(controls, q[i]);
+            append(controls, q[i]);
+            append(controls, q[i]);
+            continue;
+        }
+        Vector3 after = has_after ? log_step(q[i], q[i + 1]) : Vector3::zero();
+        Vector3 before = has_before ? log_step(q[i], q[i - 1]) : Vector3::zero();
+        Scalar h_after = has_after ? t[i + 1] - t[i] : 0;
+        Scalar h_before = has_before ? t[i] - t[i - 1] : 0;
+
+        // At the ends, the tangent follows the only segment
+        if (!has_before)
+        {
+            before = -after;
+            h_before = h_after;
+        }
+        if (!has_after)
+        {
+            after = -before;
+            h_after = h_before;
+        }
+
+        // Half angular velocity at the key: the velocities of both segments,
+        // each weighted by the duration of the other one, as for the parabola through the three keys
+        const Vector3 ω = (after * (h_before / h_after) - before * (h_after / h_before)) * (1 / (h_before + h_after));
+
+        // Inner controls making the derivatives of squad at the key match ω from both sides,
+        // 2 log(q^-1 s_out) = ω h_after - after, 2 log(q^-1 s_in) = -(ω h_before + before),
+        // Shoemake's -(after + before) / 4 for both with even keys
+        append(controls, q[i]);
+        append(controls, times_exp(q[i], (ω * h_before + before) * Scalar(-0.5)));
+        append(controls, times_exp(q[i], (ω * h_after - after) * Scalar(0.5)));
+    }
+}
+
+void build_b_spline(std::span<const Quaternion> q, std::vector<Scalar>& controls)
+{
+    // Entry k holds q_{k - 1} and ω_k = log_step(q_{k - 1}, q_k) for k in [0, n],
+    // the phantom keys q_{-1} and q_n extending the first and last steps,
+    // so that the curve starts on the first key and ends on the last one
+    const std::size_t n = q.size();
+    const auto ω = [&](std::size_t k) {
+        if (n < 2) return Vector3::zero();
+        k = std::clamp<std::size_t>(k, 1, n - 1);
+        return log_step(q[k - 1], q[k]);
+    };
+
+    // At least the 3 entries of a segment
+    controls.reserve(b_spline_stride * std::max<std::size_t>(n + 1, 3));
+    append(controls, times_exp(q[0], -ω(0)), ω(0));
+    for (std::size_t k = 1; k <= n; ++k) append(controls, q[k - 1], ω(k));
+    if (n == 1) append(controls, q[0], Vector3::zero());
+}
+
+} // namespace
+
+
+RotationSpline::RotationSpline(std::vector<Scalar> times, const std::span<const Rotation> keys, const RotationSplineType type)
+    : _times(std::move(times))
+    , _type(type)
+{
+    assert(_times.size() == keys.size());
+    assert(std::is_sorted(_times.begin(), _times.end()));
+    if (keys.empty()) return;
+
+    // Each key on the side of the previous one, so that every step takes the shortest path
+    std::vector<Quaternion> q(keys.size());
+    q[0] = keys[0].as_quaternion();
+    for (std::size_t k = 1; k < keys.size(); ++k)
+    {
+        const Quaternion& key = keys[k].as_quaternion();
+        q[k] = q[k - 1].dot(key) < 0 ? -key : key;
+    }
+
+    if (type == RotationSplineType::squad) build_squad(_times, q, _controls);
+    else build_b_spline(q, _controls);
+}
+
+std::size_t RotationSpline::segment(const Scalar time) const noexcept
+{
+    const auto next = std::upper_bound(_times.begin(), _times.end(), time);
+    return next == _times.begin() ? 0 : std::size_t(next - _times.begin()) - 1;
+}
+
+void RotationSpline::controls(std::size_t k, const Scalar time, const Scalar*& from, const Scalar*& to, Scalar& u) const noexcept
+{
+    const std::size_t n = size();
+    if (k + 1 < n)
+    {
+        u = std::clamp((time - _times[k]) / (_times[k + 1] - _times[k]), Scalar(0), Scalar(1));
+    }
+    else
+    {
+        // The end of the last segment: the knots of B-splines are not their keys
+        k = n > 1 ? n - 2 : 0;
+        u = n > 1 ? 1 : 0;
+    }
+    const std::size_t s = stride(_type);
+    from = _controls.data() + s * k;
+    to = _controls.data() + s * std::min(k + 1, n - 1);
+}
+
+Rotation RotationSpline::sample(const Scalar time) const noexcept
+{
+    if (empty()) return {};
+
+    const Scalar* from;
+    const Scalar* to;
+    Scalar u;
+    controls(segment(time), time, from, to, u);
+
+    Rotation rotation;
+    const auto& kernels = simd::kernels();
+    Scalar* const out = reinterpret_cast<Scalar*>(&rotation);
+    if (_type == RotationSplineType::squad) kernels.squad_rotations(&from, &to, &u, out, 1);
+    else kernels.b_spline_rotations(&from, &u, out, 1);
+    return rotation;
+}
+
+
+RotationSplineSampler::RotationSplineSampler(const std::span<const RotationSpline> splines)
+    : _splines(splines)
+    , _type(RotationSplineType::squad)
+    , _segments(splines.size(), 0)
+    , _from(splines.size())
+    , _to(splines.size())
+    , _u(splines.size())
+{
+    const auto spline = std::find_if(splines.begin(), splines.end(), [](const RotationSpline& s) { return !s.empty(); });
+    if (spline != splines.end()) _type = spline->type();
+    assert(std::all_of(splines.begin(), splines.end(), [&](const RotationSpline& s) { return s.empty() || s.type() == _type; }));
+}
+
+void RotationSplineSampler::sample(const Scalar time, const std::span<Rotation> out) noexcept
+{
+    assert(out.size() == _splines.size());
+
+    for (std::size_t i = 0; i < _splines.size(); ++i)
+    {
+        const RotationSpline& spline = _splines[i];
+        if (spline.empty())
+        {
+            _from[i] = _to[i] = identity;
+            _u[i] = 0;
+            continue;
+        }
+
+        const auto times = spline.times();
+        std::uint32_t k = std::min(_segments[i], std::uint32_t(times.size() - 1));
+        if (times[k] > time)
+        {
+            k = std::uint32_t(spline.segment(time));
+        }
+        else
+        {
+            std::uint32_t steps = 0;
+            while (k + 1 < times.size() && times[k + 1] <= time)
+            {
+                if (++steps > max_forward_steps)
+                {
+                    k = std::uint32_t(spline.segment(time));
+                    break;
+                }
+                ++k;
+            }
+        }
+        _segments[i] = k;
+        spline.controls(k, time, _from[i], _to[i], _u[i]);
+    }
+
+    const auto& kernels = simd::kernels();
+    Scalar* const rotations = reinterpret_cast<Scalar*>(out.data());
+    if (_type == RotationSplineType::squad) kernels.squad_rotations(_from.data(), _to.data(), _u.data(), rotations, out.size());
+    else kernels.b_spline_rotations(_from.data(), _u.data(), rotations, out.size());
+}
+
+} // namespace gfx
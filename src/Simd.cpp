@@ -0,0 +1,132 @@
+#include "Simd.h"
+#include "simd/Kernels.h"
+
+#include <atomic>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+namespace gfx
+{
+
+namespace
+{
+
+#if defined(_MSC_VER) && defined(_M_X64)
+
+// MSVC has no __builtin_cpu_supports: ask CPUID and check the OS saves the wide registers
+bool msvc_supports(const SimdIsa isa) noexcept
+{
+    int info[4];
+    __cpuid(info, 1);
+    const bool osxsave = info[2] & (1 << 27);
+    const bool avx     = info[2] & (1 << 28);
+    const bool fma     = info[2] & (1 << 12);
+    if (!osxsave || !avx) return false;
+
+    const unsigned long long xcr0 = _xgetbv(0);
+    __cpuidex(info, 7, 0);
+    switch (isa)
+    {
+        case SimdIsa::avx2:   return fma && (info[1] & (1 << 5)) && (xcr0 & 0x06) == 0x06;
+        case SimdIsa::avx512: return fma && (info[1] & (1 << 16)) && (info[1] & (1u << 31)) && (xcr0 & 0xe6) == 0xe6;
+        default: return false;
+    }
+}
+
+#endif
+
+bool cpu_supports(const SimdIsa isa) noexcept
+{
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    switch (isa)
+    {
+        case SimdIsa::scalar: return true;
+        case SimdIsa::sse:    return __builtin_cpu_supports("sse2");
+        case SimdIsa::avx2:   return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+        case SimdIsa::avx512: return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl") && __builtin_cpu_supports("fma");
+    }
+    return false;
+#elif defined(_MSC_VER) && defined(_M_X64)
+    switch (isa)
+    {
+        case SimdIsa::scalar:
+        case SimdIsa::sse:
+            return true;
+        default:
+            return msvc_supports(isa);
+    }
+#else
+    // Kernels are only specialized for x86, elsewhere rely on the compiler
+    return isa == SimdIsa::scalar;
+#endif
+}
+
+SimdIsa widest_supported() noexcept
+{
+    for (const SimdIsa isa : { SimdIsa::avx512, SimdIsa::avx2, SimdIsa::sse })
+    {
+        if (cpu_supports(isa)) return isa;
+    }
+    return SimdIsa::scalar;
+}
+
+std::atomic<SimdIsa>& current_isa() noexcept
+{
+    static std::atomic<SimdIsa> isa = widest_supported();
+    return isa;
+}
+
+} // namespace
+
+
+SimdIsa simd_isa() noexcept
+{
+    return current_isa().load(std::memory_order_relaxed);
+}
+
+bool simd_isa_supported(const SimdIsa isa) noexcept
+{
+    return cpu_supports(isa);
+}
+
+bool set_simd_isa(const SimdIsa isa) noexcept
+{
+    if (!cpu_supports(isa)) return false;
+
+    current_isa().store(isa, std::memory_order_relaxed);
+    return true;
+}
+
+const char* name(const SimdIsa isa) noexcept
+{
+    switch (isa)
+    {
+        case SimdIsa::scalar: return "scalar";
+        case SimdIsa::sse:    return "sse";
+        case SimdIsa::avx2:   return "avx2";
+        case SimdIsa::avx512: return "avx512";
+    }
+    return "unknown";
+}
+
+namespace simd
+{
+
+const KernelTable& kernels() noexcept
+{
+    switch (simd_isa())
+    {
+        case SimdIsa::scalar: return scalar::table;
+        case SimdIsa::sse:    return sse::table;
+        case SimdIsa::avx2:   return avx2::table;
+        case SimdIsa::avx512: return avx512::table;
+    }
+    return scalar::table;
+}
+
+} // namespace simd
+
+} // namespace gfx
@@ -0,0 +1,124 @@
+#include "Skinning.h"
+#include "simd/Kernels.h"
+
+#include <cassert>
+
+namespace gfx
+{
+
+// Kernels read dual quaternions as 8 interleaved floats: real (x, y, z, w), dual (x, y, z, w)
+static_assert(sizeof(DualQuaternion) == 8 * sizeof(Scalar));
+
+namespace
+{
+
+using SkinKernel = void (*)(
+    const simd::Influences&, const float*,
+    simd::ConstSoA, simd::ConstSoA, simd::SoA, simd::SoA, std::size_t) noexcept;
+
+void skin(
+    const SkinKernel kernel,
+    const SkinInfluences& influences,
+    const float* const bones,
+    const ConstVector3Span positions,
+    const ConstVector3Span normals,
+    const Vector3Span out_positions,
+    const Vector3Span out_normals) noexcept
+{
+    assert(influences.count <= MAX_BONE_INFLUENCES);
+    assert(influences.bones.size() == influences.weights.size());
+    assert(influences.vertex_count() == positions.size() && positions.size() == out_positions.size());
+    assert(normals.size() == out_normals.size() && (normals.empty() || normals.size() == positions.size()));
+
+    kernel(
+        { influences.bones.data(), influences.weights.data(), influences.count },
+        bones,
+        { positions.x(), positions.y(), positions.z() },
+        { normals.x(), normals.y(), normals.z() },
+        { out_positions.x(), out_positions.y(), out_positions.z() },
+        { out_normals.x(), out_normals.y(), out_normals.z() },
+        positions.size());
+}
+
+void skin(
+    const SkinKernel kernel,
+    const SkinInfluences& influences,
+    const float* const bones,
+    const ConstVector3Span positions,
+    const ConstVector3Span normals,
+    const Vector3Span out_positions,
+    const Vector3Span out_normals,
+    ThreadPool& pool,
+    const std::size_t grain)
+{
+    pool.parallel_for(positions.size(), grain, [&](const std::size_t begin, const std::size_t end) {
+        const std::size_t count = end - begin;
+        const bool has_normals = !normals.empty();
+        skin(
+            kernel,
+            influences.subspan(begin, count),
+            bones,
+            positions.subspan(begin, count),
+            has_normals ? normals.subspan(begin, count) : normals,
+            out_positions.subspan(begin, count),
+            has_normals ? out_normals.subspan(begin, count) : out_normals);
+    });
+}
+
+const float* as_floats(const std::span<const DualQuaternion> bones) noexcept
+{
+    return reinterpret_cast<const Scalar*>(bones.data());
+}
+
+} // namespace
+
+
+void skin_linear(
+    const SkinInfluences& influences,
+    const std::span<const float> matrices,
+    const ConstVector3Span positions,
+    const ConstVector3Span normals,
+    const Vector3Span out_positions,
+    const Vector3Span out_normals) noexcept
+{
+    skin(simd::kernels().skin_linear, influences, matrices.data(), positions, normals, out_positions, out_normals);
+}
+
+void skin_linear(
+    const SkinInfluences& influences,
+    const std::span<const float> matrices,
+    const ConstVector3Span positions,
+    const ConstVector3Span normals,
+    const Vector3Span out_positions,
+    const Vector3Span out_normals,
+    ThreadPool& pool,
+    const std::size_t grain)
+{
+    skin(simd::kernels().skin_linear, influences, matrices.data(), positions, normals, out_positions, out_normals, pool, grain);
+}
+
+void skin_dual_quaternion(
+    const SkinInfluences& influences,
+    const std::span<const DualQuaternion> bones,
+    const ConstVector3Span positions,
+    const ConstVector3Span normals,
+    const Vector3Span out_positions,
+    const Vector3Span out_normals) noexcept
+{
+    skin(simd::kernels().skin_dual_quaternion, influences, as_floats(bones), positions, normals, out_positions, out_normals);
+}
+
+void skin_dual_quaternion(
+    const SkinInfluences& influences,
+    const std::span<const DualQuaternion> bones,
+    const ConstVector3Span positions,
+    const ConstVector3Span normals,
+    const Vector3Span out_positions,
+    const Vector3Span out_normals,
+    ThreadPool& pool,
+    const std::size_t grain)
+{
+    skin(simd::kernels().skin_dual_quaternion, influences, as_floats(bones), positions, normals, out_positions, out_normals, pool, grain);
+}
+
+} // namespace gfx
@@ -0,0 +1,331 @@
+#include "SpatialHash.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+
+namespace gfx
+{
+
+namespace
+{
+
+struct Cell
+{
+    std::int64_t x;
+    std::int64_t y;
+    std::int64_t z;
+
+    constexpr bool operator==(const Cell&) const noexcept = default;
+};
+
+std::int64_t cell_coordinate(const Scalar x) noexcept
+{
+    // Far away spheres share the cells at the edge of the range instead of overflowing
+    constexpr Scalar limit = 0x1p62f;
+    return std::int64_t(std::clamp(std::floor(x), -limit, limit));
+}
+
+Cell cell_of(const Vector3& p, const Scalar inv_cell_size) noexcept
+{
+    return {
+        cell_coordinate(p.x * inv_cell_size),
+        cell_coordinate(p.y * inv_cell_size),
+        cell_coordinate(p.z * inv_cell_size),
+    };
+}
+
+/**
+ * Teschner et al. hash of the row of cells along x, to which x is then added:
+ * cells next to each other along x get consecutive buckets, so the spheres
+ * of a row are contiguous and a 3x3x3 neighbourhood is 9 ranges of 3 buckets.
+ */
+std::uint32_t row_hash(const std::int64_t y, const std::int64_t z) noexcept
+{
+    return (std::uint32_t(y) * 19349663u) ^ (std::uint32_t(z) * 83492791u);
+}
+
+std::uint32_t bucket_of(const Cell& c, const std::uint32_t mask) noexcept
+{
+    return (row_hash(c.y, c.z) + std::uint32_t(c.x)) & mask;
+}
+
+/** Inclusive range of buckets. */
+struct BucketRange
+{
+    std::uint32_t first;
+    std::uint32_t last;
+};
+
+/**
+ * Buckets of the 27 cells around c, as sorted ranges without overlaps,
+ * so that hash collisions do not visit the same bucket twice.
+ *
+ * @return Number of ranges.
+ */
+std::size_t neighbour_buckets(const Cell& c, const std::uint32_t mask, BucketRange (&ranges)[18]) noexcept
+{
+    std::size_t count = 0;
+    for (std::int64_t dz = -1; dz <= 1; ++dz)
+    {
+        for (std::int64_t dy = -1; dy <= 1; ++dy)
+        {
+            const std::uint32_t first = (row_hash(c.y + dy, c.z + dz) + std::uint32_t(c.x - 1)) & mask;
+            if (first + 2 <= mask)
+            {
+                ranges[count++] = { first, first + 2 };
+            }
+            else
+            {
+                // Wrapping around the end of the table
+                ranges[count++] = { first, mask };
+                ranges[count++] = { 0, (first + 2) & mask };
+            }
+        }
+    }
+
+    std::sort(ranges, ranges + count, [](const BucketRange a, const BucketRange b) { return a.first < b.first; });
+    std::size_t merged = 0;
+    for (std::size_t k = 1; k < count; ++k)
+    {
+        if (ranges[k].first <= ranges[merged].last + 1) ranges[merged].last = std::max(ranges[merged].last, ranges[k].last);
+        else ranges[++merged] = ranges[k];
+    }
+    return merged + 1;
+}
+
+bool overlap(const Sphere& a, const Sphere& b) noexcept
+{
+    const Scalar r = std::abs(a.radius) + std::abs(b.radius);
+    return (b.center - a.center).squared_norm() < r * r;
+}
+
+Scalar max_radius(const std::span<const Sphere> spheres) noexcept
+{
+    Scalar r = 0;
+    for (const Sphere& s : spheres) r = std::max(r, std::abs(s.radius));
+    return r;
+}
+
+} // namespace
+
+
+SpatialHash::SpatialHash(std::pmr::memory_resource* const memory) noexcept
+    : _start(memory)
+    , _keys(memory)
+    , _indices(memory)
+    , _spheres(memory)
+    , _moved(memory)
+{
+}
+
+SpatialHash::SpatialHash(const std::span<const Sphere> spheres, const Scalar cell_size, std::pmr::memory_resource* const memory)
+    : SpatialHash(memory)
+{
+    build(spheres, cell_size);
+}
+
+void SpatialHash::build(const std::span<const Sphere> spheres, const Scalar cell_size, std::pmr::memory_resource* const scratch)
+{
+    assert(spheres.size() < 0xffffffff);
+
+    _max_radius = max_radius(spheres);
+    _cell_size = std::max(cell_size, 2 * _max_radius);
+    if (_cell_size <= 0) _cell_size = 1;
+
+    // About one bucket per sphere
+    _mask = std::uint32_t(std::bit_ceil(std::max<std::size_t>(spheres.size(), 1)) - 1);
+    sort_entries(spheres, scratch);
+}
+
+void SpatialHash::sort_entries(const std::span<const Sphere> spheres, std::pmr::memory_resource* const scratch)
+{
+    const std::size_t n = spheres.size();
+    const Scalar inv_cell_size = 1 / _cell_size;
+
+    std::pmr::vector<std::uint32_t> keys(n, scratch);
+    for (std::size_t i = 0; i < n; ++i) keys[i] = bucket_of(cell_of(spheres[i].center, inv_cell_size), _mask);
+
+    // Counting sort, buckets being small integers
+    _start.assign(std::size_t(_mask) + 2, 0);
+    for (const std::uint32_t key : keys) ++_start[key + 1];
+    for (std::size_t b = 1; b < _start.size(); ++b) _start[b] += _start[b - 1];
+
+    std::pmr::vector<std::uint32_t> next(_start.begin(), _start.end() - 1, scratch);
+    _keys.resize(n);
+    _indices.resize(n);
+    _spheres.resize(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        const std::uint32_t e = next[keys[i]]++;
+        _keys[e] = keys[i];
+        _indices[e] = std::uint32_t(i);
+        _spheres[e] = spheres[i];
+    }
+}
+
+void SpatialHash::count_buckets()
+{
+    std::fill(_start.begin(), _start.end(), 0);
+    for (const std::uint32_t key : _keys) ++_start[key + 1];
+    for (std::size_t b = 1; b < _start.size(); ++b) _start[b] += _start[b - 1];
+}
+
+void SpatialHash::update(const std::span<const Sphere> spheres, std::pmr::memory_resource* const scratch)
+{
+    assert(spheres.size() == size());
+
+    const Scalar radius = max_radius(spheres);
+    if (2 * radius > _cell_size) return build(spheres, _cell_size, scratch);
+    _max_radius = radius;
+
+    // Entries still in their bucket keep their order, the others are sorted apart
+    const std::size_t n = size();
+    const Scalar inv_cell_size = 1 / _cell_size;
+    _moved.clear();
+    std::size_t kept = 0;
+    for (std::size_t e = 0; e < n; ++e)
+    {
+        const std::uint32_t i = _indices[e];
+        const std::uint32_t key = bucket_of(cell_of(spheres[i].center, inv_cell_size), _mask);
+        if (key == _keys[e])
+        {
+            _keys[kept] = key;
+            _indices[kept] = i;
+            _spheres[kept] = spheres[i];
+            ++kept;
+        }
+        else
+        {
+            _moved.push_back({ key, i });
+        }
+    }
+    if (_moved.empty()) return;
+
+    // Then merged back from the end, into the room they left
+    std::sort(_moved.begin(), _moved.end());
+    std::size_t a = kept;
+    std::size_t b = _moved.size();
+    for (std::size_t out = n; b > 0;)
+    {
+        --out;
+        if (a > 0 && _keys[a - 1] > _moved[b - 1].first)
+        {
+            --a;
+            _keys[out] = _keys[a];
+            _indices[out] = _indices[a];
+            _spheres[out] = _spheres[a];
+        }
+        else
+        {
+            --b;
+            _keys[out] = _moved[b].first;
+            _indices[out] = _moved[b].second;
+            _spheres[out] = spheres[_moved[b].second];
+        }
+    }
+    count_buckets();
+}
+
+void SpatialHash::pairs_in_range(const std::size_t begin, const std::size_t end, std::pmr::vector<Pair>& pairs) const
+{
+    const Scalar inv_cell_size = 1 / _cell_size;
+
+    // Around the cell of the last sphere, which the next one often shares
+    BucketRange ranges[18];
+    std::size_t count = 0;
+    Cell last {};
+
+    for (std::size_t a = begin; a < end; ++a)
+    {
+        const Sphere& s = _spheres[a];
+        const Cell c = cell_of(s.center, inv_cell_size);
+        if (count == 0 || c != last)
+        {
+            count = neighbour_buckets(c, _mask, ranges);
+            last = c;
+        }
+
+        // Each pair once, from the sphere stored first
+        for (std::size_t k = 0; k < count; ++k)
+        {
+            const std::size_t stop = _start[ranges[k].last + 1];
+            for (std::size_t e = std::max<std::size_t>(_start[ranges[k].first], a + 1); e < stop; ++e)
+            {
+                if (overlap(s, _spheres[e])) pairs.push_back(std::minmax(_indices[a], _indices[e]));
+            }
+        }
+    }
+}
+
+void SpatialHash::overlapping_pairs(std::pmr::vector<Pair>& pairs) const
+{
+    pairs.clear();
+    pairs_in_range(0, size(), pairs);
+}
+
+void SpatialHash::overlapping_pairs(std::pmr::vector<Pair>& pairs, ThreadPool& pool, const std::size_t grain) const
+{
+    assert(grain > 0);
+    const std::size_t n = size();
+    const std::size_t chunks = (n + grain - 1) / grain;
+    if (chunks <= 1) return overlapping_pairs(pairs);
+
+    std::vector<std::pmr::vector<Pair>> found(chunks);
+    pool.parallel_for(chunks, [&](const std::size_t chunk) {
+        pairs_in_range(chunk * grain, std::min(n, (chunk + 1) * grain), found[chunk]);
+    });
+
+    std::size_t total = 0;
+    for (const std::pmr::vector<Pair>& f : found) total += f.size();
+    pairs.clear();
+    pairs.reserve(total);
+    for (const std::pmr::vector<Pair>& f : found) pairs.insert(pairs.end(), f.begin(), f.end());
+}
+
+void SpatialHash::query(const Sphere& sphere, std::pmr::vector<std::uint32_t>& indices, std::pmr::memory_resource* const scratch) const
+{
+    if (empty()) return;
+
+    const Scalar inv_cell_size = 1 / _cell_size;
+    const Scalar reach = std::abs(sphere.radius) + _max_radius;
+    const Cell low = cell_of(sphere.center - Vector3 { reach, reach, reach }, inv_cell_size);
+    const Cell high = cell_of(sphere.center + Vector3 { reach, reach, reach }, inv_cell_size);
+
+    // Spanning more cells than there are buckets, every bucket gets visited anyway
+    const double cells = double(high.x - low.x + 1) * double(high.y - low.y + 1) * double(high.z - low.z + 1);
+    if (cells > double(_mask) + 1)
+    {
+        for (std::size_t e = 0; e < size(); ++e)
+        {
+            if (overlap(sphere, _spheres[e])) indices.push_back(_indices[e]);
+        }
+        return;
+    }
+
+    std::pmr::vector<std::uint32_t> buckets(scratch);
+    buckets.reserve(std::size_t(cells));
+    for (std::int64_t z = low.z; z <= high.z; ++z)
+    {
+        for (std::int64_t y = low.y; y <= high.y; ++y)
+        {
+            for (std::int64_t x = low.x; x <= high.x; ++x)
+            {
+                buckets.push_back(bucket_of({ x, y, z }, _mask));
+            }
+        }
+    }
+    std::sort(buckets.begin(), buckets.end());
+    buckets.erase(std::unique(buckets.begin(), buckets.end()), buckets.end());
+
+    for (const std::uint32_t b : buckets)
+    {
+        for (std::size_t e = _start[b]; e < _start[b + 1]; ++e)
+        {
+            if (overlap(sphere, _spheres[e])) indices.push_back(_indices[e]);
+        }
+    }
+}
+
+} // namespace gfx
@@ -0,0 +1,220 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gfx
+{
+
+namespace
+{
+
+struct Job
+{
+    const std::function<void(std::size_t)>& task;
+    std::atomic<std::size_t> remaining;
+
+    // First exception thrown by a task, rethrown by parallel_for once no task refers to the job
+    std::mutex mutex;
+    std::exception_ptr exception;
+    std::atomic<bool> failed = false;
+
+    void run(const std::size_t index) noexcept
+    {
+        // After a failure, the remaining tasks are skipped
+        if (failed.load(std::memory_order_relaxed)) return;
+        try
+        {
+            task(index);
+        }
+        catch (...)
+        {
+            std::lock_guard lock(mutex);
+            if (!exception) exception = std::current_exception();
+            failed.store(true, std::memory_order_relaxed);
+        }
+    }
+};
+
+struct Task
+{
+    Job* job;
+    std::size_t index;
+};
+
+struct Queue
+{
+    std::mutex mutex;
+    std::deque<Task> tasks;
+};
+
+// Queue of the current thread, if it is a worker
+thread_local const void* current_pool = nullptr;
+thread_local std::size_t current_queue = 0;
+
+} // namespace
+
+
+struct ThreadPool::State
+{
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> threads;
+
+    // Guards sleeping, queued and stop
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::size_t queued = 0;
+    bool stop = false;
+
+    /**
+     * Run one task: from the front of the home queue if possible, else from the back of another one.
+     */
+    bool try_run(const std::size_t home)
+    {
+        const std::size_t n = queues.size();
+        for (std::size_t k = 0; k < n; ++k)
+        {
+            Queue& queue = *queues[(home + k) % n];
+            Task task;
+            {
+                std::lock_guard lock(queue.mutex);
+                if (queue.tasks.empty()) continue;
+
+                if (k == 0)
+                {
+                    task = queue.tasks.front();
+                    queue.tasks.pop_front();
+                }
+                else
+                {
+                    task = queue.tasks.back();
+                    queue.tasks.pop_back();
+                }
+            }
+            {
+                std::lock_guard lock(mutex);
+                --queued;
+            }
+
+            task.job->run(task.index);
+            if (task.job->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                // Waiters check remaining under the mutex: lock it once so they cannot miss the wake up
+                { std::lock_guard lock(mutex); }
+                wake.notify_all();
+            }
+            return true;
+        }
+        return false;
+    }
+
+    void work(const std::size_t home)
+    {
+        current_queue = home;
+        while (true)
+        {
+            if (try_run(home)) continue;
+
+            std::unique_lock lock(mutex);
+            wake.wait(lock, [&] { return queued > 0 || stop; });
+            if (stop) return;
+        }
+    }
+};
+
+
+ThreadPool::ThreadPool(unsigned threads)
+    : _state(std::make_unique<State>())
+{
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (unsigned i = 0; i < threads; ++i)
+    {
+        _state->queues.push_back(std::make_unique<Queue>());
+    }
+    for (unsigned i = 0; i < threads; ++i)
+    {
+        _state->threads.emplace_back([this, i] {
+            current_pool = this;
+            _state->work(i);
+        });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock(_state->mutex);
+        _state->stop = true;
+    }
+    _state->wake.notify_all();
+    for (std::thread& thread : _state->threads) thread.join();
+}
+
+unsigned ThreadPool::size() const noexcept
+{
+    return unsigned(_state->threads.size());
+}
+
+void ThreadPool::parallel_for(const std::size_t count, const std::function<void(std::size_t)>& task)
+{
+    if (count == 0) return;
+
+    Job job { task, count, {}, {}, false };
+    State& state = *_state;
+
+    // Contiguous ranges per queue, so that neighbouring tasks share caches until stolen
+    const std::size_t n = state.queues.size();
+    for (std::size_t q = 0; q < n; ++q)
+    {
+        Queue& queue = *state.queues[q];
+        std::lock_guard lock(queue.mutex);
+        for (std::size_t i = q * count / n; i < (q + 1) * count / n; ++i)
+        {
+            queue.tasks.push_back({ &job, i });
+        }
+    }
+    {
+        std::lock_guard lock(state.mutex);
+        state.queued += count;
+    }
+    state.wake.notify_all();
+
+    // Help instead of blocking, which also keeps nested calls from a worker deadlock-free
+    const std::size_t home = current_pool == this ? current_queue : 0;
+    while (job.remaining.load(std::memory_order_acquire) > 0)
+    {
+        if (state.try_run(home)) continue;
+
+        std::unique_lock lock(state.mutex);
+        state.wake.wait(lock, [&] {
+            return job.remaining.load(std::memory_order_acquire) == 0 || state.queued > 0;
+        });
+    }
+    if (job.exception) std::rethrow_exception(job.exception);
+}
+
+void ThreadPool::parallel_for(
+    const std::size_t count,
+    const std::size_t grain,
+    const std::function<void(std::size_t, std::size_t)>& task)
+{
+    const std::size_t chunks = std::max<std::size_t>(1, count / std::max<std::size_t>(1, grain));
+    parallel_for(chunks, [&](const std::size_t i) {
+        task(i * count / chunks, (i + 1) * count / chunks);
+    });
+}
+
+ThreadPool& ThreadPool::shared()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+} // namespace gfx
@@ -0,0 +1,22 @@
+#include "TransformBatch.h"
+#include "simd/Kernels.h"
+
+#include <cassert>
+
+namespace gfx
+{
+
+// Kernels read transforms as 10 interleaved floats: translation, rotation (x, y, z, w), scale
+static_assert(sizeof(Transform) == 10 * sizeof(Scalar));
+static_assert(sizeof(Rotation) == 4 * sizeof(Scalar));
+
+void write_matrices(const std::span<const Transform> transforms, const std::span<float> out, const MatrixLayout layout) noexcept
+{
+    assert(out.size() >= transforms.size() * floats_per_matrix(layout));
+
+    const auto& kernels = simd::kernels();
+    const auto write = layout == MatrixLayout::column_major_4x4 ? kernels.transform_to_4x4 : kernels.transform_to_3x4;
+    write(reinterpret_cast<const Scalar*>(transforms.data()), out.data(), transforms.size());
+}
+
+} // namespace gfx
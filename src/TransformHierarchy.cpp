@@ -0,0 +1,159 @@
+#include "TransformHierarchy.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace gfx
+{
+
+TransformHierarchy::Node TransformHierarchy::add(const Transform& local, const Node parent)
+{
+    assert(parent == no_parent || parent < _index.size());
+
+    const Node node = Node(_index.size());
+    const std::uint32_t parent_index = parent == no_parent ? no_parent : _index[parent];
+    // Last position of the parent subtree, or the end for roots
+    const std::uint32_t at = parent == no_parent ? std::uint32_t(size()) : parent_index + _size[parent_index];
+
+    if (at < size())
+    {
+        for (std::uint32_t i = at; i < size(); ++i) ++_index[_node[i]];
+        for (std::uint32_t& p : _parent)
+        {
+            if (p != no_parent && p >= at) ++p;
+        }
+    }
+
+    _local.insert(_local.begin() + at, local);
+    _world.insert(_world.begin() + at, local);
+    _parent.insert(_parent.begin() + at, parent_index);
+    _size.insert(_size.begin() + at, 1);
+    _node.insert(_node.begin() + at, node);
+
+    _index.push_back(at);
+    _dirty.push_back(1);
+    _dirty_nodes.push_back(node);
+
+    for (std::uint32_t p = parent_index; p != no_parent; p = _parent[p]) ++_size[p];
+    return node;
+}
+
+TransformHierarchy::Node TransformHierarchy::parent(const Node node) const noexcept
+{
+    const std::uint32_t p = _parent[_index[node]];
+    return p == no_parent ? no_parent : _node[p];
+}
+
+void TransformHierarchy::set_local(const Node node, const Transform& local) noexcept
+{
+    _local[_index[node]] = local;
+    if (_dirty[node]) return;
+
+    _dirty[node] = 1;
+    _dirty_nodes.push_back(node);
+}
+
+std::size_t TransformHierarchy::update()
+{
+    collect_dirty_ranges();
+
+    std::size_t count = 0;
+    for (const Range range : _ranges)
+    {
+        update_range(range);
+        count += range.end - range.begin;
+    }
+    return count;
+}
+
+std::size_t TransformHierarchy::update(ThreadPool& pool, const std::size_t grain)
+{
+    collect_dirty_ranges();
+
+    std::size_t count = 0;
+    for (const Range range : _ranges) count += range.end - range.begin;
+
+    split_ranges(std::max<std::size_t>(1, grain));
+    if (_tasks.size() == 1)
+    {
+        update_range(_tasks.front());
+    }
+    else if (!_tasks.empty())
+    {
+        pool.parallel_for(_tasks.size(), [&](const std::size_t i) { update_range(_tasks[i]); });
+    }
+    return count;
+}
+
+void TransformHierarchy::collect_dirty_ranges()
+{
+    _ranges.clear();
+    for (const Node node : _dirty_nodes)
+    {
+        const std::uint32_t i = _index[node];
+        _ranges.push_back({ i, i + _size[i] });
+        _dirty[node] = 0;
+    }
+    _dirty_nodes.clear();
+
+    // Subtrees are either nested or disjoint: keep the outermost ones
+    std::sort(_ranges.begin(), _ranges.end(), [](const Range a, const Range b) { return a.begin < b.begin; });
+    std::size_t kept = 0;
+    for (const Range range : _ranges)
+    {
+        if (kept == 0 || range.begin >= _ranges[kept - 1].end) _ranges[kept++] = range;
+    }
+    _ranges.resize(kept);
+}
+
+void TransformHierarchy::update_range(const Range range) noexcept
+{
+    // Parents precede their children, so their world transforms are already up to date
+    for (std::uint32_t i = range.begin; i < range.end; ++i)
+    {
+        const std::uint32_t p = _parent[i];
+        _world[i] = p == no_parent ? _local[i] : _local[i].then(_world[p]);
+    }
+}
+
+void TransformHierarchy::split_ranges(const std::size_t grain)
+{
+    // Consumes _ranges as a stack: large subtrees get their root updated right away,
+    // then their children become independent tasks, with small siblings merged together
+    _tasks.clear();
+    while (!_ranges.empty())
+    {
+        const Range range = _ranges.back();
+        _ranges.pop_back();
+        if (range.end - range.begin <= grain)
+        {
+            _tasks.push_back(range);
+            continue;
+        }
+
+        update_range({ range.begin, range.begin + 1 });
+
+        Range siblings = { range.begin + 1, range.begin + 1 };
+        for (std::uint32_t c = range.begin + 1; c < range.end; c += _size[c])
+        {
+            const Range child = { c, c + _size[c] };
+            if (child.end - child.begin > grain)
+            {
+                if (siblings.begin != siblings.end) _tasks.push_back(siblings);
+                _ranges.push_back(child);
+                siblings = { child.end, child.end };
+                continue;
+            }
+
+            siblings.end = child.end;
+            if (siblings.end - siblings.begin >= grain)
+            {
+                _tasks.push_back(siblings);
+                siblings = { siblings.end, siblings.end };
+            }
+        }
+        if (siblings.begin != siblings.end) _tasks.push_back(siblings);
+    }
+}
+
+} // namespace gfx
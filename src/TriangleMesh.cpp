@@ -0,0 +1,99 @@
+#include "TriangleMesh.h"
+#include "simd/Kernels.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace gfx
+{
+
+// Kernels read rays as (start, dir) and vertices as interleaved (x, y, z) floats
+static_assert(sizeof(Ray) == 6 * sizeof(Scalar));
+static_assert(sizeof(Vector3) == 3 * sizeof(Scalar));
+
+namespace
+{
+
+const Scalar* floats(const Ray& ray) noexcept { return reinterpret_cast<const Scalar*>(&ray); }
+
+simd::ConstSoA soa(const Vector3Batch& batch) noexcept { return { batch.x(), batch.y(), batch.z() }; }
+
+} // namespace
+
+
+TriangleMesh::TriangleMesh(std::vector<Vector3> vertices, std::vector<std::uint32_t> indices)
+    : _vertices(std::move(vertices))
+    , _indices(std::move(indices))
+{
+    assert(_indices.size() % 3 == 0);
+    assert(std::all_of(_indices.begin(), _indices.end(), [&](const std::uint32_t i) { return i < _vertices.size(); }));
+    _vertices.push_back(Vector3::zero());
+}
+
+Hit TriangleMesh::closest_hit(const Ray& ray, const Scalar t_min, const Scalar t_max) const noexcept
+{
+    Scalar t = t_max;
+    std::uint32_t index = no_hit;
+    const bool hit = simd::kernels().closest_indexed_triangle(
+        floats(ray), reinterpret_cast<const Scalar*>(_vertices.data()), _indices.data(), size(), t_min, &t, &index);
+    if (!hit) return {};
+    return { t, ray.at(t), triangle(index).normal(), index };
+}
+
+bool TriangleMesh::any_hit(const Ray& ray, const Scalar t_min, const Scalar t_max) const noexcept
+{
+    return simd::kernels().any_indexed_triangle(
+        floats(ray), reinterpret_cast<const Scalar*>(_vertices.data()), _indices.data(), size(), t_min, t_max);
+}
+
+
+TriangleBatch::TriangleBatch(std::pmr::memory_resource* const memory) noexcept
+    : _a(memory)
+    , _e1(memory)
+    , _e2(memory)
+    , _normals(memory)
+{
+}
+
+TriangleBatch::TriangleBatch(const TriangleMesh& mesh, std::pmr::memory_resource* const memory)
+    : _a(mesh.size(), memory)
+    , _e1(mesh.size(), memory)
+    , _e2(mesh.size(), memory)
+    , _normals(mesh.size(), memory)
+{
+    for (std::size_t i = 0; i < mesh.size(); ++i) set(i, mesh.triangle(i));
+}
+
+TriangleBatch::TriangleBatch(const std::span<const Triangle> triangles, std::pmr::memory_resource* const memory)
+    : _a(triangles.size(), memory)
+    , _e1(triangles.size(), memory)
+    , _e2(triangles.size(), memory)
+    , _normals(triangles.size(), memory)
+{
+    for (std::size_t i = 0; i < triangles.size(); ++i) set(i, triangles[i]);
+}
+
+void TriangleBatch::set(const std::size_t i, const Triangle& triangle) noexcept
+{
+    _a.set(i, triangle.a);
+    _e1.set(i, triangle.b - triangle.a);
+    _e2.set(i, triangle.c - triangle.a);
+    _normals.set(i, triangle.normal());
+}
+
+Hit TriangleBatch::closest_hit(const Ray& ray, const Scalar t_min, const Scalar t_max) const noexcept
+{
+    Scalar t = t_max;
+    std::uint32_t index = no_hit;
+    const bool hit = simd::kernels().closest_precomputed_triangle(
+        floats(ray), soa(_a), soa(_e1), soa(_e2), size(), t_min, &t, &index);
+    if (!hit) return {};
+    return { t, ray.at(t), _normals[index], index };
+}
+
+bool TriangleBatch::any_hit(const Ray& ray, const Scalar t_min, const Scalar t_max) const noexcept
+{
+    return simd::kernels().any_precomputed_triangle(floats(ray), soa(_a), soa(_e1), soa(_e2), size(), t_min, t_max);
+}
+
+} // namespace gfx
@@ -4,3 +4,8 @@ std::ostream& operator<<(std::ostream& os, const gfx::Vector3& v)
 {
     return os << "(" << v.x << ", " << v.y << ", " << v.z << ")";
 }
+
+std::ostream& operator<<(std::ostream& os, const gfx::Vector3d& v)
+{
+    return os << "(" << v.x << ", " << v.y << ", " << v.z << ")";
+}
@@ -0,0 +1,223 @@
+#include "Vector3Batch.h"
+#include "simd/Kernels.h"
+
+#include <algorithm>
+#include <cassert>
+#include <new>
+#include <utility>
+
+namespace gfx
+{
+
+namespace
+{
+
+// Keep every coordinate array on an alignment boundary
+constexpr std::size_t padded(const std::size_t n) noexcept
+{
+    constexpr std::size_t lanes = Vector3Batch::alignment / sizeof(Scalar);
+    return (n + lanes - 1) / lanes * lanes;
+}
+
+Scalar* allocate(std::pmr::memory_resource* const memory, const std::size_t capacity)
+{
+    if (capacity == 0) return nullptr;
+
+    return static_cast<Scalar*>(memory->allocate(3 * capacity * sizeof(Scalar), Vector3Batch::alignment));
+}
+
+void deallocate(std::pmr::memory_resource* const memory, Scalar* const data, const std::size_t capacity) noexcept
+{
+    if (data) memory->deallocate(data, 3 * capacity * sizeof(Scalar), Vector3Batch::alignment);
+}
+
+simd::ConstSoA soa(const ConstVector3Span v) noexcept { return { v.x(), v.y(), v.z() }; }
+simd::SoA soa(const Vector3Span v) noexcept { return { v.x(), v.y(), v.z() }; }
+
+} // namespace
+
+
+Vector3Batch::Vector3Batch() noexcept
+    : Vector3Batch(std::pmr::get_default_resource())
+{
+}
+
+Vector3Batch::Vector3Batch(std::pmr::memory_resource* const memory) noexcept
+    : _data(nullptr)
+    , _size(0)
+    , _capacity(0)
+    , _memory(memory)
+{
+}
+
+Vector3Batch::Vector3Batch(const std::size_t size, std::pmr::memory_resource* const memory)
+    : Vector3Batch(memory)
+{
+    resize(size);
+}
+
+Vector3Batch::Vector3Batch(const std::span<const Vector3> vectors, std::pmr::memory_resource* const memory)
+    : Vector3Batch(memory)
+{
+    assign(vectors);
+}
+
+Vector3Batch::Vector3Batch(const Vector3Batch& other)
+    : Vector3Batch()
+{
+    reserve(other._size);
+    _size = other._size;
+    std::copy_n(other.x(), _size, x());
+    std::copy_n(other.y(), _size, y());
+    std::copy_n(other.z(), _size, z());
+}
+
+Vector3Batch::Vector3Batch(Vector3Batch&& other) noexcept
+    : _data(std::exchange(other._data, nullptr))
+    , _size(std::exchange(other._size, 0))
+    , _capacity(std::exchange(other._capacity, 0))
+    , _memory(other._memory)
+{
+}
+
+Vector3Batch& Vector3Batch::operator=(const Vector3Batch& other)
+{
+    if (this != &other)
+    {
+        // In the memory of this batch, reusing it when large enough
+        _size = 0;
+        reserve(other._size);
+        _size = other._size;
+        std::copy_n(other.x(), _size, x());
+        std::copy_n(other.y(), _size, y());
+        std::copy_n(other.z(), _size, z());
+    }
+    return *this;
+}
+
+Vector3Batch& Vector3Batch::operator=(Vector3Batch&& other) noexcept
+{
+    if (this != &other)
+    {
+        deallocate(_memory, _data, _capacity);
+        _data = std::exchange(other._data, nullptr);
+        _size = std::exchange(other._size, 0);
+        _capacity = std::exchange(other._capacity, 0);
+        _memory = other._memory;
+    }
+    return *this;
+}
+
+Vector3Batch::~Vector3Batch()
+{
+    deallocate(_memory, _data, _capacity);
+}
+
+void Vector3Batch::reserve(const std::size_t capacity)
+{
+    if (capacity <= _capacity) return;
+
+    const std::size_t new_capacity = padded(capacity);
+    Scalar* data = allocate(_memory, new_capacity);
+    std::copy_n(x(), _size, data);
+    std::copy_n(y(), _size, data + new_capacity);
+    std::copy_n(z(), _size, data + 2 * new_capacity);
+
+    deallocate(_memory, _data, _capacity);
+    _data = data;
+    _capacity = new_capacity;
+}
+
+void Vector3Batch::resize(const std::size_t size)
+{
+    reserve(size);
+    if (size > _size)
+    {
+        std::fill(x() + _size, x() + size, 0);
+        std::fill(y() + _size, y() + size, 0);
+        std::fill(z() + _size, z() + size, 0);
+    }
+    _size = size;
+}
+
+void Vector3Batch::push_back(const Vector3& v)
+{
+    // Geometric growth, like std::vector
+    if (_size == _capacity) reserve(std::max<std::size_t>(2 * _capacity, 1));
+    ++_size;
+    set(_size - 1, v);
+}
+
+void Vector3Batch::assign(const std::span<const Vector3> vectors)
+{
+    _size = 0;
+    reserve(vectors.size());
+    _size = vectors.size();
+
+    Scalar* const xs = x();
+    Scalar* const ys = y();
+    Scalar* const zs = z();
+    for (std::size_t i = 0; i < _size; ++i)
+    {
+        xs[i] = vectors[i].x;
+        ys[i] = vectors[i].y;
+        zs[i] = vectors[i].z;
+    }
+}
+
+void Vector3Batch::copy_to(const std::span<Vector3> out) const noexcept
+{
+    assert(out.size() >= _size);
+
+    const Scalar* const xs = x();
+    const Scalar* const ys = y();
+    const Scalar* const zs = z();
+    for (std::size_t i = 0; i < _size; ++i)
+    {
+        out[i] = { xs[i], ys[i], zs[i] };
+    }
+}
+
+
+void dot(const ConstVector3Span a, const ConstVector3Span b, const std::span<Scalar> out) noexcept
+{
+    assert(a.size() == b.size() && a.size() == out.size());
+    simd::kernels().dot(soa(a), soa(b), out.data(), out.size());
+}
+
+void cross(const ConstVector3Span a, const ConstVector3Span b, const Vector3Span out) noexcept
+{
+    assert(a.size() == b.size() && a.size() == out.size());
+    simd::kernels().cross(soa(a), soa(b), soa(out), out.size());
+}
+
+void squared_norm(const ConstVector3Span v, const std::span<Scalar> out) noexcept
+{
+    assert(v.size() == out.size());
+    simd::kernels().squared_norm(soa(v), out.data(), out.size());
+}
+
+void normalize(const ConstVector3Span v, const Vector3Span out) noexcept
+{
+    assert(v.size() == out.size());
+    simd::kernels().normalize(soa(v), soa(out), out.size());
+}
+
+void normalize(const Vector3Span v) noexcept
+{
+    normalize(v, v);
+}
+
+void lerp(const ConstVector3Span a, const ConstVector3Span b, const Scalar α, const Vector3Span out) noexcept
+{
+    assert(a.size() == b.size() && a.size() == out.size());
+    simd::kernels().lerp(soa(a), soa(b), α, soa(out), out.size());
+}
+
+void distance(const ConstVector3Span a, const ConstVector3Span b, const std::span<Scalar> out) noexcept
+{
+    assert(a.size() == b.size() && a.size() == out.size());
+    simd::kernels().distance(soa(a), soa(b), out.data(), out.size());
+}
+
+} // namespace gfx
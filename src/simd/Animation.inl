@@ -0,0 +1,89 @@
+// Kernels behind Animation.h, included by Kernels.inl.
+
+namespace gfx::simd::GFX_SIMD_ISA
+{
+namespace
+{
+
+enum class Blend
+{
+    nlerp,
+    slerp,
+    fast_slerp,
+};
+
+template <typename P>
+inline P dot4(const Vec4<P>& a, const Vec4<P>& b) noexcept
+{
+    return fmadd(a.x, b.x, fmadd(a.y, b.y, fmadd(a.z, b.z, a.w * b.w)));
+}
+
+template <Blend blend>
+void blend_transforms(
+    const float* const* const from,
+    const float* const* const to,
+    const float* const α,
+    float* const out,
+    const std::size_t n) noexcept
+{
+    for_lanes(n, [&]<typename P>(const std::size_t i) {
+        // Same overlapping quadruples as TransformBatch.inl:
+        // (tx ty tz qx), (qx qy qz qw), (qw sx sy sz)
+        const Vec4<P> a = load_transposed<P>(from + i, 0);
+        const Vec4<P> p = load_transposed<P>(from + i, 3);
+        const Vec4<P> r = load_transposed<P>(from + i, 6);
+        const Vec4<P> b = load_transposed<P>(to + i, 0);
+        const Vec4<P> q = load_transposed<P>(to + i, 3);
+        const Vec4<P> s = load_transposed<P>(to + i, 6);
+
+        const P one = P::broadcast(1);
+        const P u = P::load(α + i);
+        const P v = one - u;
+
+        const Vec3<P> translation = a.xyz() * v + b.xyz() * u;
+        const Vec3<P> scale = Vec3<P> { r.y, r.z, r.w } * v + Vec3<P> { s.y, s.z, s.w } * u;
+
+        // Weights of p and q, taking the shortest path
+        const P d = dot4(p, q);
+        const P cos_θ = abs(d);
+        P wp = v;
+        P wq = u;
+        if constexpr (blend == Blend::slerp)
+        {
+            const P θ = acos(cos_θ);
+            const P inv_sin_θ = one / sin_quadrant(θ);
+            // Close rotations keep the nlerp weights, like Rotation::slerp
+            const auto close = cos_θ > P::broadcast(1 - 1e-5f);
+            wp = select(close, v, sin_quadrant(v * θ) * inv_sin_θ);
+            wq = select(close, u, sin_quadrant(u * θ) * inv_sin_θ);
+        }
+        else if constexpr (blend == Blend::fast_slerp)
+        {
+            // Same correction as Rotation::fast_slerp
+            const P A = fmadd(cos_θ, fmadd(cos_θ, fmadd(cos_θ, P::broadcast(-1.43519f), P::broadcast(3.55645f)), P::broadcast(-3.2452f)), P::broadcast(1.0904f));
+            const P B = fmadd(cos_θ, fmadd(cos_θ, P::broadcast(0.215638f), P::broadcast(-1.06021f)), P::broadcast(0.848013f));
+            const P h = u - P::broadcast(0.5f);
+            const P k = fmadd(A * h, h, B);
+            wq = fmadd(u * h * (u - one), k, u);
+            wp = one - wq;
+        }
+        wq = select(d < P::broadcast(0), -wq, wq);
+
+        Vec4<P> rotation = {
+            fmadd(p.x, wp, q.x * wq),
+            fmadd(p.y, wp, q.y * wq),
+            fmadd(p.z, wp, q.z * wq),
+            fmadd(p.w, wp, q.w * wq),
+        };
+        const P k = one / sqrt(dot4(rotation, rotation));
+        rotation = { rotation.x * k, rotation.y * k, rotation.z * k, rotation.w * k };
+
+        float* const t = out + 10 * i;
+        store_transposed<P>(t, 10, { translation.x, translation.y, translation.z, rotation.x });
+        store_transposed<P>(t + 3, 10, rotation);
+        store_transposed<P>(t + 6, 10, { rotation.w, scale.x, scale.y, scale.z });
+    });
+}
+
+} // namespace
+} // namespace gfx::simd::GFX_SIMD_ISA
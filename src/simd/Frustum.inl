@@ -0,0 +1,92 @@
+// Kernels behind Frustum.h, included by Kernels.inl.
+
+namespace gfx::simd::GFX_SIMD_ISA
+{
+namespace
+{
+
+// Lane j of entry b is bit j of b, to turn 4 bits of a mask into 4 lanes at a time
+struct SpreadBits
+{
+    std::uint32_t lanes[16][4];
+
+    constexpr SpreadBits() noexcept
+        : lanes {}
+    {
+        for (std::uint32_t b = 0; b < 16; ++b)
+        {
+            for (std::uint32_t j = 0; j < 4; ++j) lanes[b][j] = b >> j & 1;
+        }
+    }
+};
+
+constexpr SpreadBits spread_bits;
+
+template <typename P>
+P signed_distance(const float* const plane, const Vec3<P>& p) noexcept
+{
+    return fmadd(P::broadcast(plane[0]), p.x, fmadd(P::broadcast(plane[1]), p.y, fmadd(P::broadcast(plane[2]), p.z, P::broadcast(plane[3]))));
+}
+
+void cull_spheres(
+    const ConstSoA centers,
+    const float* const radii,
+    const std::size_t n,
+    const float* const planes,
+    const std::size_t frusta,
+    std::uint32_t* const masks,
+    std::uint32_t* const* const visible,
+    std::size_t* const counts) noexcept
+{
+    if (visible)
+    {
+        for (std::size_t f = 0; f < frusta; ++f) counts[f] = 0;
+    }
+
+    // Every frustum against the same spheres, loaded once
+    for_lanes(n, [&]<typename P>(const std::size_t i) {
+        const Vec3<P> c = Vec3<P>::load(centers, i);
+        const P r = -abs(P::load(radii + i));
+
+        std::uint32_t inside[P::width] = {};
+        for (std::size_t f = 0; f < frusta; ++f)
+        {
+            const float* const plane = planes + 24 * f;
+            auto in = signed_distance(plane, c) >= r;
+            for (std::size_t k = 1; k < 6; ++k) in = in && signed_distance(plane + 4 * k, c) >= r;
+            const unsigned hits = bits(in);
+            if (hits == 0) continue;
+
+            if (masks)
+            {
+                constexpr std::size_t group = P::width < 4 ? P::width : 4;
+                for (std::size_t lane = 0; lane < P::width; lane += group)
+                {
+                    const std::uint32_t* const spread = spread_bits.lanes[hits >> lane & 15];
+                    for (std::size_t j = 0; j < group; ++j) inside[lane + j] |= spread[j] << f;
+                }
+            }
+            if (visible)
+            {
+                // Branch-free compaction: each lane is written, and kept by moving past it
+                // if visible, which never writes beyond its own index
+                std::uint32_t* const out = visible[f];
+                std::size_t count = counts[f];
+                for (std::size_t lane = 0; lane < P::width; ++lane)
+                {
+                    out[count] = std::uint32_t(i + lane);
+                    count += hits >> lane & 1;
+                }
+                counts[f] = count;
+            }
+        }
+
+        if (masks)
+        {
+            for (std::size_t lane = 0; lane < P::width; ++lane) masks[i + lane] = inside[lane];
+        }
+    });
+}
+
+} // namespace
+} // namespace gfx::simd::GFX_SIMD_ISA
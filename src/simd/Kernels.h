@@ -0,0 +1,168 @@
+#pragma once
+
+// Internal interface between the public batch APIs and the SIMD kernels.
+//
+// The kernels are compiled once per instruction set (see Kernels_*.cpp),
+// each time into its own namespace, and only ever see raw float arrays:
+// they must not include the public headers, or the linker could pick an
+// AVX-512 copy of some inline function for the whole program.
+
+#include <cstddef>
+#include <cstdint>
+
+namespace gfx::simd
+{
+
+/** Structure-of-arrays view of n 3D vectors. */
+struct SoA
+{
+    float* x;
+    float* y;
+    float* z;
+};
+
+struct ConstSoA
+{
+    const float* x;
+    const float* y;
+    const float* z;
+};
+
+/** Index reported by intersection kernels for rays that hit nothing. */
+inline constexpr std::uint32_t no_hit = 0xffffffff;
+
+/** Same as gfx::RENORMALIZE_LIMIT. */
+inline constexpr float renormalize_limit = 1e-3f;
+
+/**
+ * Closed form of the quaternion of Euler angles in some order (see gfx::euler_product):
+ * each of x, y, z, w is the sum of two products of the sines or cosines of the half angles,
+ * times ±1.
+ */
+struct EulerTerms
+{
+    /** Component of the angles holding the angle of each rotation, in order. */
+    std::uint8_t angle[3];
+    /** Bit k set for the sine of rotation k + 1. */
+    std::uint8_t sines[4][2];
+    float sign[4][2];
+};
+
+/**
+ * Bones influencing n vertices, count per vertex: influence k of vertex v
+ * is bone bones[v * count + k] with weight weights[v * count + k].
+ */
+struct Influences
+{
+    const std::uint16_t* bones;
+    const float* weights;
+    std::size_t count;
+};
+
+struct KernelTable
+{
+    // Vector3Batch
+    void (*dot)(ConstSoA a, ConstSoA b, float* out, std::size_t n) noexcept;
+    void (*cross)(ConstSoA a, ConstSoA b, SoA out, std::size_t n) noexcept;
+    void (*squared_norm)(ConstSoA v, float* out, std::size_t n) noexcept;
+    void (*normalize)(ConstSoA v, SoA out, std::size_t n) noexcept;
+    void (*lerp)(ConstSoA a, ConstSoA b, float α, SoA out, std::size_t n) noexcept;
+    void (*distance)(ConstSoA a, ConstSoA b, float* out, std::size_t n) noexcept;
+
+    // RotationBatch and Matrix3Batch, m is a row-major 3x3 matrix, q are (x, y, z, w) quaternions,
+    // *_xyz kernels work on interleaved (x, y, z) arrays
+    void (*rotate)(const float* m, ConstSoA in, SoA out, std::size_t n) noexcept;
+    void (*rotate_xyz)(const float* m, const float* in, float* out, std::size_t n) noexcept;
+    void (*rotate_each_xyz)(const float* q, const float* in, float* out, std::size_t n) noexcept;
+
+    // RayPacket, spheres are interleaved (x, y, z, radius),
+    // t and index get the closest hit of each of the n rays
+    void (*intersect_spheres)(
+        ConstSoA start, ConstSoA dir, std::size_t n,
+        const float* spheres, std::size_t count,
+        float* t, std::uint32_t* index) noexcept;
+
+    // Frustum, planes are 6 interleaved (normal x, y, z, distance) per frustum,
+    // bit f of masks[i] gets whether sphere i is in frustum f, or visible[f] its index
+    // and counts[f] the number of them, the unused outputs being null
+    void (*cull_spheres)(
+        ConstSoA centers, const float* radii, std::size_t n,
+        const float* planes, std::size_t frusta,
+        std::uint32_t* masks, std::uint32_t* const* visible, std::size_t* counts) noexcept;
+
+    // TransformBatch, t are interleaved (translation, rotation x y z w, scale),
+    // out gets n packed column-major matrices
+    void (*transform_to_4x4)(const float* t, float* out, std::size_t n) noexcept;
+    void (*transform_to_3x4)(const float* t, float* out, std::size_t n) noexcept;
+
+    // Animation, from and to point to interleaved transforms (see TransformBatch),
+    // blended into out by α in [0, 1]
+    void (*nlerp_transforms)(const float* const* from, const float* const* to, const float* α, float* out, std::size_t n) noexcept;
+    void (*slerp_transforms)(const float* const* from, const float* const* to, const float* α, float* out, std::size_t n) noexcept;
+    void (*fast_slerp_transforms)(const float* const* from, const float* const* to, const float* α, float* out, std::size_t n) noexcept;
+
+    // RotationEncoding, q are (x, y, z, w) quaternions,
+    // packed are little-endian smallest-three codes of 4, 6 or 8 bytes each
+    void (*encode_rotations_32)(const float* q, std::uint8_t* packed, std::size_t n) noexcept;
+    void (*encode_rotations_48)(const float* q, std::uint8_t* packed, std::size_t n) noexcept;
+    void (*encode_rotations_64)(const float* q, std::uint8_t* packed, std::size_t n) noexcept;
+    void (*decode_rotations_32)(const std::uint8_t* packed, float* q, std::size_t n) noexcept;
+    void (*decode_rotations_48)(const std::uint8_t* packed, float* q, std::size_t n) noexcept;
+    void (*decode_rotations_64)(const std::uint8_t* packed, float* q, std::size_t n) noexcept;
+
+    // RotationBatch, m are row-major 3x3 matrices, q gets (x, y, z, w) quaternions,
+    // the drifted version orthonormalizes the matrices first
+    void (*rotations_from_matrices)(const float* m, float* q, std::size_t n) noexcept;
+    void (*rotations_from_drifted_matrices)(const float* m, float* q, std::size_t n) noexcept;
+    // angles are interleaved (x, y, z) Euler angles in radians
+    void (*rotations_from_euler)(const float* angles, const EulerTerms& euler, float* q, std::size_t n) noexcept;
+    // Running products out[i] = out[i - 1] q[i], normalized every renormalize of them unless 0,
+    // and left products q[i] = p q[i]
+    void (*prefix_rotations)(const float* q, float* out, std::size_t n, std::size_t renormalize) noexcept;
+    void (*premultiply_rotations)(const float* p, float* q, std::size_t n) noexcept;
+    // Orientations q turned by interleaved (x, y, z) angular velocities for dt, to first order, then renormalized
+    void (*integrate_angular_velocities)(float* q, const float* angular_velocities, float dt, std::size_t n) noexcept;
+
+    // RotationSpline, out gets (x, y, z, w) quaternions at u in [0, 1] of a segment per curve:
+    // from and to point to the controls of its squad keys (q, s_in, s_out),
+    // controls to its 3 B-spline entries (q_{k - 1}, log(q_{k - 1}^-1 q_k), unused)
+    void (*squad_rotations)(const float* const* from, const float* const* to, const float* u, float* out, std::size_t n) noexcept;
+    void (*b_spline_rotations)(const float* const* controls, const float* u, float* out, std::size_t n) noexcept;
+
+    // TriangleMesh, ray is (start x, y, z, dir x, y, z), triangles are 3 indices into interleaved (x, y, z) vertices
+    // followed by one more vertex, read as 4 floats each,
+    // or precomputed as their first vertex a and edges e1 = b - a, e2 = c - a.
+    // Whether a triangle is hit within [t_min, *t], the closest one going to t and index, else left alone,
+    // or within [t_min, t_max] for the any versions, which stop at the first one
+    bool (*closest_indexed_triangle)(
+        const float* ray, const float* vertices, const std::uint32_t* indices, std::size_t n,
+        float t_min, float* t, std::uint32_t* index) noexcept;
+    bool (*any_indexed_triangle)(
+        const float* ray, const float* vertices, const std::uint32_t* indices, std::size_t n,
+        float t_min, float t_max) noexcept;
+    bool (*closest_precomputed_triangle)(
+        const float* ray, ConstSoA a, ConstSoA e1, ConstSoA e2, std::size_t n,
+        float t_min, float* t, std::uint32_t* index) noexcept;
+    bool (*any_precomputed_triangle)(
+        const float* ray, ConstSoA a, ConstSoA e1, ConstSoA e2, std::size_t n,
+        float t_min, float t_max) noexcept;
+
+    // Skinning, matrices are column-major 3x4 (see TransformBatch), bones are dual quaternions
+    // as (real x, y, z, w, dual x, y, z, w), normals are skipped if normals.x is null
+    void (*skin_linear)(
+        const Influences& influences, const float* matrices,
+        ConstSoA positions, ConstSoA normals, SoA out_positions, SoA out_normals, std::size_t n) noexcept;
+    void (*skin_dual_quaternion)(
+        const Influences& influences, const float* bones,
+        ConstSoA positions, ConstSoA normals, SoA out_positions, SoA out_normals, std::size_t n) noexcept;
+};
+
+namespace scalar { extern const KernelTable table; }
+namespace sse    { extern const KernelTable table; }
+namespace avx2   { extern const KernelTable table; }
+namespace avx512 { extern const KernelTable table; }
+
+/** Table for the instruction set selected at runtime (see Simd.h). */
+const KernelTable& kernels() noexcept;
+
+} // namespace gfx::simd
@@ -0,0 +1,69 @@
+// Body shared by the Kernels_*.cpp translation units:
+// each one defines GFX_SIMD_ISA and GFX_SIMD_LEVEL, then includes this file.
+
+#include "Pack.h"
+
+#include "Animation.inl"
+#include "Frustum.inl"
+#include "RayPacket.inl"
+#include "RotationBatch.inl"
+#include "RotationEncoding.inl"
+#include "RotationSpline.inl"
+#include "Skinning.inl"
+#include "TransformBatch.inl"
+#include "TriangleMesh.inl"
+#include "Vector3Batch.inl"
+
+namespace gfx::simd::GFX_SIMD_ISA
+{
+
+const KernelTable table = {
+    .dot          = dot,
+    .cross        = cross,
+    .squared_norm = squared_norm,
+    .normalize    = normalize,
+    .lerp         = lerp,
+    .distance     = distance,
+
+    .rotate          = rotate,
+    .rotate_xyz      = rotate_xyz,
+    .rotate_each_xyz = rotate_each_xyz,
+
+    .intersect_spheres = intersect_spheres,
+
+    .cull_spheres = cull_spheres,
+
+    .transform_to_4x4 = transform_to_4x4,
+    .transform_to_3x4 = transform_to_3x4,
+
+    .nlerp_transforms      = blend_transforms<Blend::nlerp>,
+    .slerp_transforms      = blend_transforms<Blend::slerp>,
+    .fast_slerp_transforms = blend_transforms<Blend::fast_slerp>,
+
+    .encode_rotations_32 = encode_rotations<4>,
+    .encode_rotations_48 = encode_rotations<6>,
+    .encode_rotations_64 = encode_rotations<8>,
+    .decode_rotations_32 = decode_rotations<4>,
+    .decode_rotations_48 = decode_rotations<6>,
+    .decode_rotations_64 = decode_rotations<8>,
+
+    .rotations_from_matrices         = rotations_from_matrices<false>,
+    .rotations_from_drifted_matrices = rotations_from_matrices<true>,
+    .rotations_from_euler            = rotations_from_euler,
+    .prefix_rotations                = prefix_rotations,
+    .premultiply_rotations           = premultiply_rotations,
+    .integrate_angular_velocities    = integrate_angular_velocities,
+
+    .squad_rotations    = squad_rotations,
+    .b_spline_rotations = b_spline_rotations,
+
+    .closest_indexed_triangle     = closest_indexed_triangle,
+    .any_indexed_triangle         = any_indexed_triangle,
+    .closest_precomputed_triangle = closest_precomputed_triangle,
+    .any_precomputed_triangle     = any_precomputed_triangle,
+
+    .skin_linear          = skin_linear,
+    .skin_dual_quaternion = skin_dual_quaternion,
+};
+
+} // namespace gfx::simd::GFX_SIMD_ISA
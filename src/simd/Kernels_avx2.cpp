@@ -0,0 +1,4 @@
+#define GFX_SIMD_ISA avx2
+#define GFX_SIMD_LEVEL 2
+
+#include "Kernels.inl"
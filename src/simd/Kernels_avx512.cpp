@@ -0,0 +1,4 @@
+#define GFX_SIMD_ISA avx512
+#define GFX_SIMD_LEVEL 3
+
+#include "Kernels.inl"
@@ -0,0 +1,4 @@
+#define GFX_SIMD_ISA scalar
+#define GFX_SIMD_LEVEL 0
+
+#include "Kernels.inl"
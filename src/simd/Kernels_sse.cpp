@@ -0,0 +1,4 @@
+#define GFX_SIMD_ISA sse
+#define GFX_SIMD_LEVEL 1
+
+#include "Kernels.inl"
@@ -0,0 +1,807 @@
+#pragma once
+
+// SIMD lane types for the kernels, selected by GFX_SIMD_LEVEL and the
+// compiler flags of the including translation unit.
+//
+// Everything lives in an anonymous namespace and only uses intrinsics,
+// so nothing compiled here can leak into code running on older CPUs.
+
+#include "Kernels.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GFX_SIMD_X86 1
+#include <immintrin.h>
+#else
+#include <cmath>
+#endif
+
+#if !defined(GFX_SIMD_ISA) || !defined(GFX_SIMD_LEVEL)
+#error "Define GFX_SIMD_ISA and GFX_SIMD_LEVEL before including Pack.h"
+#endif
+
+// Lane types available in this translation unit
+#if defined(GFX_SIMD_X86) && GFX_SIMD_LEVEL >= 1
+#define GFX_SIMD_FLOAT4 1
+#endif
+#if defined(GFX_SIMD_X86) && GFX_SIMD_LEVEL >= 2 && defined(__AVX2__)
+#define GFX_SIMD_FLOAT8 1
+#endif
+#if defined(GFX_SIMD_X86) && GFX_SIMD_LEVEL >= 3 && defined(__AVX512F__)
+#define GFX_SIMD_FLOAT16 1
+#endif
+
+namespace gfx::simd::GFX_SIMD_ISA
+{
+namespace
+{
+
+/**
+ * One float per lane, used for loop tails and by the scalar table.
+ */
+struct Lane1
+{
+    using Mask = bool;
+    static constexpr std::size_t width = 1;
+
+    float v;
+
+    static Lane1 load(const float* p) noexcept { return { *p }; }
+    static Lane1 broadcast(const float k) noexcept { return { k }; }
+    void store(float* p) const noexcept { *p = v; }
+};
+
+inline Lane1 operator+(const Lane1 a, const Lane1 b) noexcept { return { a.v + b.v }; }
+inline Lane1 operator-(const Lane1 a, const Lane1 b) noexcept { return { a.v - b.v }; }
+inline Lane1 operator*(const Lane1 a, const Lane1 b) noexcept { return { a.v * b.v }; }
+inline Lane1 operator/(const Lane1 a, const Lane1 b) noexcept { return { a.v / b.v }; }
+inline Lane1 operator-(const Lane1 a) noexcept { return { -a.v }; }
+
+inline Lane1 fmadd(const Lane1 a, const Lane1 b, const Lane1 c) noexcept { return { a.v * b.v + c.v }; }
+inline Lane1 min(const Lane1 a, const Lane1 b) noexcept { return { a.v < b.v ? a.v : b.v }; }
+inline Lane1 max(const Lane1 a, const Lane1 b) noexcept { return { a.v > b.v ? a.v : b.v }; }
+inline Lane1 abs(const Lane1 a) noexcept { return { a.v < 0 ? -a.v : a.v }; }
+
+inline Lane1 sqrt(const Lane1 a) noexcept
+{
+#ifdef GFX_SIMD_X86
+    return { _mm_cvtss_f32(_mm_sqrt_ss(_mm_set_ss(a.v))) };
+#else
+    return { std::sqrt(a.v) };
+#endif
+}
+
+inline bool operator<(const Lane1 a, const Lane1 b) noexcept { return a.v < b.v; }
+inline bool operator<=(const Lane1 a, const Lane1 b) noexcept { return a.v <= b.v; }
+inline bool operator>(const Lane1 a, const Lane1 b) noexcept { return a.v > b.v; }
+inline bool operator>=(const Lane1 a, const Lane1 b) noexcept { return a.v >= b.v; }
+
+inline Lane1 select(const bool m, const Lane1 a, const Lane1 b) noexcept { return m ? a : b; }
+inline unsigned bits(const bool m) noexcept { return m; }
+inline bool any(const bool m) noexcept { return m; }
+
+
+#ifdef GFX_SIMD_FLOAT4
+
+struct Float4
+{
+    struct Mask { __m128 m; };
+    static constexpr std::size_t width = 4;
+
+    __m128 v;
+
+    static Float4 load(const float* p) noexcept { return { _mm_loadu_ps(p) }; }
+    static Float4 broadcast(const float k) noexcept { return { _mm_set1_ps(k) }; }
+    // p[0], ..., p[3] in every group of 4 lanes, like swizzle
+    static Float4 broadcast4(const float* p) noexcept { return load(p); }
+    void store(float* p) const noexcept { _mm_storeu_ps(p, v); }
+};
+
+inline Float4 operator+(const Float4 a, const Float4 b) noexcept { return { _mm_add_ps(a.v, b.v) }; }
+inline Float4 operator-(const Float4 a, const Float4 b) noexcept { return { _mm_sub_ps(a.v, b.v) }; }
+inline Float4 operator*(const Float4 a, const Float4 b) noexcept { return { _mm_mul_ps(a.v, b.v) }; }
+inline Float4 operator/(const Float4 a, const Float4 b) noexcept { return { _mm_div_ps(a.v, b.v) }; }
+inline Float4 operator-(const Float4 a) noexcept { return { _mm_xor_ps(a.v, _mm_set1_ps(-0.0f)) }; }
+
+// No FMA guaranteed on SSE-only CPUs
+inline Float4 fmadd(const Float4 a, const Float4 b, const Float4 c) noexcept { return a * b + c; }
+inline Float4 min(const Float4 a, const Float4 b) noexcept { return { _mm_min_ps(a.v, b.v) }; }
+inline Float4 max(const Float4 a, const Float4 b) noexcept { return { _mm_max_ps(a.v, b.v) }; }
+inline Float4 abs(const Float4 a) noexcept { return { _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v) }; }
+inline Float4 sqrt(const Float4 a) noexcept { return { _mm_sqrt_ps(a.v) }; }
+
+inline Float4::Mask operator<(const Float4 a, const Float4 b) noexcept { return { _mm_cmplt_ps(a.v, b.v) }; }
+inline Float4::Mask operator<=(const Float4 a, const Float4 b) noexcept { return { _mm_cmple_ps(a.v, b.v) }; }
+inline Float4::Mask operator>(const Float4 a, const Float4 b) noexcept { return { _mm_cmpgt_ps(a.v, b.v) }; }
+inline Float4::Mask operator>=(const Float4 a, const Float4 b) noexcept { return { _mm_cmpge_ps(a.v, b.v) }; }
+inline Float4::Mask operator&&(const Float4::Mask a, const Float4::Mask b) noexcept { return { _mm_and_ps(a.m, b.m) }; }
+inline Float4::Mask operator||(const Float4::Mask a, const Float4::Mask b) noexcept { return { _mm_or_ps(a.m, b.m) }; }
+
+inline Float4 select(const Float4::Mask m, const Float4 a, const Float4 b) noexcept
+{
+    return { _mm_or_ps(_mm_and_ps(m.m, a.v), _mm_andnot_ps(m.m, b.v)) };
+}
+inline unsigned bits(const Float4::Mask m) noexcept { return unsigned(_mm_movemask_ps(m.m)); }
+inline bool any(const Float4::Mask m) noexcept { return bits(m) != 0; }
+
+// Same permutation within every group of 4 lanes, e.g. of the components of interleaved quaternions:
+// lane k of a group gets its lane ik
+template <int i0, int i1, int i2, int i3>
+inline Float4 swizzle(const Float4 a) noexcept { return { _mm_shuffle_ps(a.v, a.v, _MM_SHUFFLE(i3, i2, i1, i0)) }; }
+
+#endif // SSE
+
+
+#ifdef GFX_SIMD_FLOAT8
+
+struct Float8
+{
+    struct Mask { __m256 m; };
+    static constexpr std::size_t width = 8;
+
+    __m256 v;
+
+    static Float8 load(const float* p) noexcept { return { _mm256_loadu_ps(p) }; }
+    static Float8 broadcast(const float k) noexcept { return { _mm256_set1_ps(k) }; }
+    static Float8 broadcast4(const float* p) noexcept { return { _mm256_broadcast_ps(reinterpret_cast<const __m128*>(p)) }; }
+    void store(float* p) const noexcept { _mm256_storeu_ps(p, v); }
+};
+
+inline Float8 operator+(const Float8 a, const Float8 b) noexcept { return { _mm256_add_ps(a.v, b.v) }; }
+inline Float8 operator-(const Float8 a, const Float8 b) noexcept { return { _mm256_sub_ps(a.v, b.v) }; }
+inline Float8 operator*(const Float8 a, const Float8 b) noexcept { return { _mm256_mul_ps(a.v, b.v) }; }
+inline Float8 operator/(const Float8 a, const Float8 b) noexcept { return { _mm256_div_ps(a.v, b.v) }; }
+inline Float8 operator-(const Float8 a) noexcept { return { _mm256_xor_ps(a.v, _mm256_set1_ps(-0.0f)) }; }
+
+inline Float8 fmadd(const Float8 a, const Float8 b, const Float8 c) noexcept { return { _mm256_fmadd_ps(a.v, b.v, c.v) }; }
+inline Float8 min(const Float8 a, const Float8 b) noexcept { return { _mm256_min_ps(a.v, b.v) }; }
+inline Float8 max(const Float8 a, const Float8 b) noexcept { return { _mm256_max_ps(a.v, b.v) }; }
+inline Float8 abs(const Float8 a) noexcept { return { _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v) }; }
+inline Float8 sqrt(const Float8 a) noexcept { return { _mm256_sqrt_ps(a.v) }; }
+
+inline Float8::Mask operator<(const Float8 a, const Float8 b) noexcept { return { _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ) }; }
+inline Float8::Mask operator<=(const Float8 a, const Float8 b) noexcept { return { _mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ) }; }
+inline Float8::Mask operator>(const Float8 a, const Float8 b) noexcept { return { _mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ) }; }
+inline Float8::Mask operator>=(const Float8 a, const Float8 b) noexcept { return { _mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ) }; }
+inline Float8::Mask operator&&(const Float8::Mask a, const Float8::Mask b) noexcept { return { _mm256_and_ps(a.m, b.m) }; }
+inline Float8::Mask operator||(const Float8::Mask a, const Float8::Mask b) noexcept { return { _mm256_or_ps(a.m, b.m) }; }
+
+inline Float8 select(const Float8::Mask m, const Float8 a, const Float8 b) noexcept { return { _mm256_blendv_ps(b.v, a.v, m.m) }; }
+inline unsigned bits(const Float8::Mask m) noexcept { return unsigned(_mm256_movemask_ps(m.m)); }
+inline bool any(const Float8::Mask m) noexcept { return bits(m) != 0; }
+
+template <int i0, int i1, int i2, int i3>
+inline Float8 swizzle(const Float8 a) noexcept { return { _mm256_permute_ps(a.v, _MM_SHUFFLE(i3, i2, i1, i0)) }; }
+
+#endif // AVX2
+
+
+#ifdef GFX_SIMD_FLOAT16
+
+struct Float16
+{
+    struct Mask { __mmask16 m; };
+    static constexpr std::size_t width = 16;
+
+    __m512 v;
+
+    static Float16 load(const float* p) noexcept { return { _mm512_loadu_ps(p) }; }
+    static Float16 broadcast(const float k) noexcept { return { _mm512_set1_ps(k) }; }
+    static Float16 broadcast4(const float* p) noexcept { return { _mm512_broadcast_f32x4(_mm_loadu_ps(p)) }; }
+    void store(float* p) const noexcept { _mm512_storeu_ps(p, v); }
+};
+
+inline Float16 operator+(const Float16 a, const Float16 b) noexcept { return { _mm512_add_ps(a.v, b.v) }; }
+inline Float16 operator-(const Float16 a, const Float16 b) noexcept { return { _mm512_sub_ps(a.v, b.v) }; }
+inline Float16 operator*(const Float16 a, const Float16 b) noexcept { return { _mm512_mul_ps(a.v, b.v) }; }
+inline Float16 operator/(const Float16 a, const Float16 b) noexcept { return { _mm512_div_ps(a.v, b.v) }; }
+
+// Plain AVX-512F has no float xor
+inline Float16 operator-(const Float16 a) noexcept
+{
+    const __m512i sign = _mm512_set1_epi32(int(0x80000000u));
+    return { _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(a.v), sign)) };
+}
+
+inline Float16 fmadd(const Float16 a, const Float16 b, const Float16 c) noexcept { return { _mm512_fmadd_ps(a.v, b.v, c.v) }; }
+inline Float16 min(const Float16 a, const Float16 b) noexcept { return { _mm512_min_ps(a.v, b.v) }; }
+inline Float16 max(const Float16 a, const Float16 b) noexcept { return { _mm512_max_ps(a.v, b.v) }; }
+inline Float16 abs(const Float16 a) noexcept { return { _mm512_abs_ps(a.v) }; }
+inline Float16 sqrt(const Float16 a) noexcept { return { _mm512_sqrt_ps(a.v) }; }
+
+inline Float16::Mask operator<(const Float16 a, const Float16 b) noexcept { return { _mm512_cmp_ps_mask(a.v, b.v, _CMP_LT_OQ) }; }
+inline Float16::Mask operator<=(const Float16 a, const Float16 b) noexcept { return { _mm512_cmp_ps_mask(a.v, b.v, _CMP_LE_OQ) }; }
+inline Float16::Mask operator>(const Float16 a, const Float16 b) noexcept { return { _mm512_cmp_ps_mask(a.v, b.v, _CMP_GT_OQ) }; }
+inline Float16::Mask operator>=(const Float16 a, const Float16 b) noexcept { return { _mm512_cmp_ps_mask(a.v, b.v, _CMP_GE_OQ) }; }
+inline Float16::Mask operator&&(const Float16::Mask a, const Float16::Mask b) noexcept { return { __mmask16(a.m & b.m) }; }
+inline Float16::Mask operator||(const Float16::Mask a, const Float16::Mask b) noexcept { return { __mmask16(a.m | b.m) }; }
+
+inline Float16 select(const Float16::Mask m, const Float16 a, const Float16 b) noexcept { return { _mm512_mask_blend_ps(m.m, b.v, a.v) }; }
+inline unsigned bits(const Float16::Mask m) noexcept { return m.m; }
+inline bool any(const Float16::Mask m) noexcept { return m.m != 0; }
+
+template <int i0, int i1, int i2, int i3>
+inline Float16 swizzle(const Float16 a) noexcept { return { _mm512_permute_ps(a.v, _MM_SHUFFLE(i3, i2, i1, i0)) }; }
+
+#endif // AVX-512
+
+
+/** Widest lane type available in this translation unit. */
+#ifdef GFX_SIMD_FLOAT16
+using Wide = Float16;
+#elif defined(GFX_SIMD_FLOAT8)
+using Wide = Float8;
+#elif defined(GFX_SIMD_FLOAT4)
+using Wide = Float4;
+#else
+using Wide = Lane1;
+#endif
+
+/**
+ * Run f.template operator()<P>(i) over [0, n), with P = Wide for full blocks
+ * and the narrower types for the tail, down to P = Lane1.
+ */
+template <typename F>
+inline void for_lanes(const std::size_t n, F&& f) noexcept
+{
+    std::size_t i = 0;
+    for (; i + Wide::width <= n; i += Wide::width) f.template operator()<Wide>(i);
+#ifdef GFX_SIMD_FLOAT16
+    if (i + 8 <= n) { f.template operator()<Float8>(i); i += 8; }
+#endif
+#ifdef GFX_SIMD_FLOAT8
+    if (i + 4 <= n) { f.template operator()<Float4>(i); i += 4; }
+#endif
+    for (; i < n; ++i) f.template operator()<Lane1>(i);
+}
+
+
+/**
+ * Lane-wise 3D vector, mirroring the gfx::Vector3 operations.
+ */
+template <typename P>
+struct Vec3
+{
+    P x;
+    P y;
+    P z;
+
+    static Vec3 load(const ConstSoA s, const std::size_t i) noexcept
+    {
+        return { P::load(s.x + i), P::load(s.y + i), P::load(s.z + i) };
+    }
+
+    static Vec3 broadcast(const float x, const float y, const float z) noexcept
+    {
+        return { P::broadcast(x), P::broadcast(y), P::broadcast(z) };
+    }
+
+    void store(const SoA s, const std::size_t i) const noexcept
+    {
+        x.store(s.x + i);
+        y.store(s.y + i);
+        z.store(s.z + i);
+    }
+
+    Vec3 operator+(const Vec3& v) const noexcept { return { x + v.x, y + v.y, z + v.z }; }
+    Vec3 operator-(const Vec3& v) const noexcept { return { x - v.x, y - v.y, z - v.z }; }
+    Vec3 operator*(const P k) const noexcept { return { x * k, y * k, z * k }; }
+    Vec3 operator-() const noexcept { return { -x, -y, -z }; }
+
+    P dot(const Vec3& v) const noexcept
+    {
+        return fmadd(x, v.x, fmadd(y, v.y, z * v.z));
+    }
+
+    Vec3 cross(const Vec3& v) const noexcept
+    {
+        return {
+            y * v.z - z * v.y,
+            z * v.x - x * v.z,
+            x * v.y - y * v.x,
+        };
+    }
+
+    P squared_norm() const noexcept { return dot(*this); }
+    P norm() const noexcept { return sqrt(squared_norm()); }
+};
+
+/**
+ * Lane-wise 4D vector, e.g. quaternions as (x, y, z, w).
+ */
+template <typename P>
+struct Vec4
+{
+    P x;
+    P y;
+    P z;
+    P w;
+
+    Vec3<P> xyz() const noexcept { return { x, y, z }; }
+};
+
+
+/**
+ * Lane-wise 3x3 matrix, from row-major floats.
+ */
+template <typename P>
+struct Mat3
+{
+    Vec3<P> rows[3];
+
+    static Mat3 broadcast(const float* m) noexcept
+    {
+        return {{
+            Vec3<P>::broadcast(m[0], m[1], m[2]),
+            Vec3<P>::broadcast(m[3], m[4], m[5]),
+            Vec3<P>::broadcast(m[6], m[7], m[8]),
+        }};
+    }
+
+    Vec3<P> operator*(const Vec3<P>& v) const noexcept
+    {
+        return { rows[0].dot(v), rows[1].dot(v), rows[2].dot(v) };
+    }
+};
+
+
+/**
+ * Arc cosine on [-1, 1], within 2e-8 of the exact value before rounding.
+ * Milton Abramowitz and Irene Stegun, 1964, Handbook of Mathematical Functions, 4.4.46
+ */
+template <typename P>
+inline P acos(const P x) noexcept
+{
+    const P a = abs(x);
+    P p = P::broadcast(-0.0012624911f);
+    p = fmadd(p, a, P::broadcast(0.0066700901f));
+    p = fmadd(p, a, P::broadcast(-0.0170881256f));
+    p = fmadd(p, a, P::broadcast(0.0308918810f));
+    p = fmadd(p, a, P::broadcast(-0.0501743046f));
+    p = fmadd(p, a, P::broadcast(0.0889789874f));
+    p = fmadd(p, a, P::broadcast(-0.2145988016f));
+    p = fmadd(p, a, P::broadcast(1.5707963050f));
+
+    const P r = sqrt(max(P::broadcast(1) - a, P::broadcast(0))) * p;
+    return select(x < P::broadcast(0), P::broadcast(3.14159265f) - r, r);
+}
+
+/**
+ * Sine on [-π/2, π/2], from its Taylor series up to x^11: within 6e-8 of the exact value.
+ */
+template <typename P>
+inline P sin_quadrant(const P x) noexcept
+{
+    const P x2 = x * x;
+    P p = P::broadcast(-1.0f / 39916800);
+    p = fmadd(p, x2, P::broadcast(1.0f / 362880));
+    p = fmadd(p, x2, P::broadcast(-1.0f / 5040));
+    p = fmadd(p, x2, P::broadcast(1.0f / 120));
+    p = fmadd(p, x2, P::broadcast(-1.0f / 6));
+    return fmadd(p * x2, x, x);
+}
+
+/**
+ * Sine and cosine of any angle up to |x| = 8192, within 2e-7.
+ * x is reduced to r in [-π, π] by the nearest multiple of 2π, split in two parts (Cody and Waite),
+ * then sin r = sin(±π - r) and cos r = sin(π/2 - |r|) bring it back to [-π/2, π/2].
+ */
+template <typename P>
+inline void sin_cos(const P x, P& s, P& c) noexcept
+{
+    // Adding 1.5 2^23 rounds to an integer
+    const P shifter = P::broadcast(0x1.8p23f);
+    const P k = (x * P::broadcast(0.15915494f) + shifter) - shifter;
+    const P r = fmadd(k, P::broadcast(-1.9353071795864769e-3f), fmadd(k, P::broadcast(-6.28125f), x));
+
+    const P π = P::broadcast(3.14159265f);
+    const P half_π = P::broadcast(1.57079633f);
+    const P a = abs(r);
+    s = sin_quadrant(select(a > half_π, select(r < P::broadcast(0), -π, π) - r, r));
+    c = sin_quadrant(half_π - a);
+}
+
+
+// Conversions between interleaved arrays (x0 y0 z0 x1 ...) and lanes,
+// loading or storing P::width consecutive elements.
+// Wider types are assembled from the 4-wide in-register transposes.
+
+template <typename P> Vec3<P> load_xyz(const float* p) noexcept;
+template <typename P> void store_xyz(float* p, const Vec3<P>& v) noexcept;
+template <typename P> Vec4<P> load_xyzw(const float* p) noexcept;
+
+template <>
+inline Vec3<Lane1> load_xyz<Lane1>(const float* p) noexcept
+{
+    return { { p[0] }, { p[1] }, { p[2] } };
+}
+
+template <>
+inline void store_xyz<Lane1>(float* p, const Vec3<Lane1>& v) noexcept
+{
+    p[0] = v.x.v;
+    p[1] = v.y.v;
+    p[2] = v.z.v;
+}
+
+template <>
+inline Vec4<Lane1> load_xyzw<Lane1>(const float* p) noexcept
+{
+    return { { p[0] }, { p[1] }, { p[2] }, { p[3] } };
+}
+
+
+// Strided access, e.g. for arrays of structs: lane j of each vector
+// is loaded from or stored to consecutive floats at p + j * stride,
+// or at p[j] + offset for arrays of pointers.
+
+template <typename P> Vec4<P> load_transposed(const float* p, std::size_t stride) noexcept;
+template <typename P> Vec4<P> load_transposed(const float* const* p, std::size_t offset) noexcept;
+template <typename P> void store_transposed(float* p, std::size_t stride, const Vec4<P>& v) noexcept;
+template <typename P> void store_transposed(float* p, std::size_t stride, const Vec3<P>& v) noexcept;
+
+template <>
+inline Vec4<Lane1> load_transposed<Lane1>(const float* p, std::size_t) noexcept
+{
+    return load_xyzw<Lane1>(p);
+}
+
+template <>
+inline Vec4<Lane1> load_transposed<Lane1>(const float* const* p, const std::size_t offset) noexcept
+{
+    return load_xyzw<Lane1>(p[0] + offset);
+}
+
+template <>
+inline void store_transposed<Lane1>(float* p, std::size_t, const Vec4<Lane1>& v) noexcept
+{
+    p[0] = v.x.v;
+    p[1] = v.y.v;
+    p[2] = v.z.v;
+    p[3] = v.w.v;
+}
+
+template <>
+inline void store_transposed<Lane1>(float* p, std::size_t, const Vec3<Lane1>& v) noexcept
+{
+    store_xyz<Lane1>(p, v);
+}
+
+#ifdef GFX_SIMD_FLOAT4
+
+template <>
+inline Vec3<Float4> load_xyz<Float4>(const float* p) noexcept
+{
+    // a = x0 y0 z0 x1, b = y1 z1 x2 y2, c = z2 x3 y3 z3
+    const __m128 a = _mm_loadu_ps(p);
+    const __m128 b = _mm_loadu_ps(p + 4);
+    const __m128 c = _mm_loadu_ps(p + 8);
+
+    const __m128 x2x3 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(0, 1, 0, 2));
+    const __m128 y0y1 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1));
+    const __m128 y2y3 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3));
+    const __m128 z0z1 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2));
+    const __m128 z2z3 = _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0));
+
+    return {
+        { _mm_shuffle_ps(a, x2x3, _MM_SHUFFLE(2, 0, 3, 0)) },
+        { _mm_shuffle_ps(y0y1, y2y3, _MM_SHUFFLE(2, 0, 2, 0)) },
+        { _mm_shuffle_ps(z0z1, z2z3, _MM_SHUFFLE(2, 0, 2, 0)) },
+    };
+}
+
+template <>
+inline void store_xyz<Float4>(float* p, const Vec3<Float4>& v) noexcept
+{
+    const __m128 x = v.x.v;
+    const __m128 y = v.y.v;
+    const __m128 z = v.z.v;
+
+    const __m128 x0y0 = _mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 0, 0, 0));
+    const __m128 z0x1 = _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0));
+    const __m128 y1z1 = _mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1));
+    const __m128 x2y2 = _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2));
+    const __m128 z2x3 = _mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2));
+    const __m128 y3z3 = _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3));
+
+    _mm_storeu_ps(p,     _mm_shuffle_ps(x0y0, z0x1, _MM_SHUFFLE(2, 0, 2, 0)));
+    _mm_storeu_ps(p + 4, _mm_shuffle_ps(y1z1, x2y2, _MM_SHUFFLE(2, 0, 2, 0)));
+    _mm_storeu_ps(p + 8, _mm_shuffle_ps(z2x3, y3z3, _MM_SHUFFLE(2, 0, 2, 0)));
+}
+
+template <>
+inline Vec4<Float4> load_xyzw<Float4>(const float* p) noexcept
+{
+    __m128 x = _mm_loadu_ps(p);
+    __m128 y = _mm_loadu_ps(p + 4);
+    __m128 z = _mm_loadu_ps(p + 8);
+    __m128 w = _mm_loadu_ps(p + 12);
+    _MM_TRANSPOSE4_PS(x, y, z, w);
+    return { { x }, { y }, { z }, { w } };
+}
+
+template <>
+inline Vec4<Float4> load_transposed<Float4>(const float* p, const std::size_t stride) noexcept
+{
+    __m128 x = _mm_loadu_ps(p);
+    __m128 y = _mm_loadu_ps(p + stride);
+    __m128 z = _mm_loadu_ps(p + 2 * stride);
+    __m128 w = _mm_loadu_ps(p + 3 * stride);
+    _MM_TRANSPOSE4_PS(x, y, z, w);
+    return { { x }, { y }, { z }, { w } };
+}
+
+template <>
+inline Vec4<Float4> load_transposed<Float4>(const float* const* p, const std::size_t offset) noexcept
+{
+    __m128 x = _mm_loadu_ps(p[0] + offset);
+    __m128 y = _mm_loadu_ps(p[1] + offset);
+    __m128 z = _mm_loadu_ps(p[2] + offset);
+    __m128 w = _mm_loadu_ps(p[3] + offset);
+    _MM_TRANSPOSE4_PS(x, y, z, w);
+    return { { x }, { y }, { z }, { w } };
+}
+
+template <>
+inline void store_transposed<Float4>(float* p, const std::size_t stride, const Vec4<Float4>& v) noexcept
+{
+    __m128 x = v.x.v;
+    __m128 y = v.y.v;
+    __m128 z = v.z.v;
+    __m128 w = v.w.v;
+    _MM_TRANSPOSE4_PS(x, y, z, w);
+    _mm_storeu_ps(p, x);
+    _mm_storeu_ps(p + stride, y);
+    _mm_storeu_ps(p + 2 * stride, z);
+    _mm_storeu_ps(p + 3 * stride, w);
+}
+
+template <>
+inline void store_transposed<Float4>(float* p, const std::size_t stride, const Vec3<Float4>& v) noexcept
+{
+    __m128 r[4] = { v.x.v, v.y.v, v.z.v, _mm_setzero_ps() };
+    _MM_TRANSPOSE4_PS(r[0], r[1], r[2], r[3]);
+    for (int j = 0; j < 4; ++j)
+    {
+        float* const q = p + j * stride;
+        _mm_storel_pi(reinterpret_cast<__m64*>(q), r[j]);
+        _mm_store_ss(q + 2, _mm_movehl_ps(r[j], r[j]));
+    }
+}
+
+#endif // SSE
+
+#ifdef GFX_SIMD_FLOAT8
+
+inline Float8 combine(const Float4 lo, const Float4 hi) noexcept
+{
+    return { _mm256_insertf128_ps(_mm256_castps128_ps256(lo.v), hi.v, 1) };
+}
+
+inline Float4 part(const Float8 a, const int k) noexcept
+{
+    return { k == 0 ? _mm256_castps256_ps128(a.v) : _mm256_extractf128_ps(a.v, 1) };
+}
+
+template <>
+inline Vec3<Float8> load_xyz<Float8>(const float* p) noexcept
+{
+    const Vec3<Float4> lo = load_xyz<Float4>(p);
+    const Vec3<Float4> hi = load_xyz<Float4>(p + 12);
+    return { combine(lo.x, hi.x), combine(lo.y, hi.y), combine(lo.z, hi.z) };
+}
+
+template <>
+inline void store_xyz<Float8>(float* p, const Vec3<Float8>& v) noexcept
+{
+    for (int k = 0; k < 2; ++k)
+    {
+        store_xyz<Float4>(p + 12 * k, { part(v.x, k), part(v.y, k), part(v.z, k) });
+    }
+}
+
+template <>
+inline Vec4<Float8> load_xyzw<Float8>(const float* p) noexcept
+{
+    const Vec4<Float4> lo = load_xyzw<Float4>(p);
+    const Vec4<Float4> hi = load_xyzw<Float4>(p + 16);
+    return { combine(lo.x, hi.x), combine(lo.y, hi.y), combine(lo.z, hi.z), combine(lo.w, hi.w) };
+}
+
+template <>
+inline Vec4<Float8> load_transposed<Float8>(const float* p, const std::size_t stride) noexcept
+{
+    const Vec4<Float4> lo = load_transposed<Float4>(p, stride);
+    const Vec4<Float4> hi = load_transposed<Float4>(p + 4 * stride, stride);
+    return { combine(lo.x, hi.x), combine(lo.y, hi.y), combine(lo.z, hi.z), combine(lo.w, hi.w) };
+}
+
+template <>
+inline Vec4<Float8> load_transposed<Float8>(const float* const* p, const std::size_t offset) noexcept
+{
+    const Vec4<Float4> lo = load_transposed<Float4>(p, offset);
+    const Vec4<Float4> hi = load_transposed<Float4>(p + 4, offset);
+    return { combine(lo.x, hi.x), combine(lo.y, hi.y), combine(lo.z, hi.z), combine(lo.w, hi.w) };
+}
+
+template <>
+inline void store_transposed<Float8>(float* p, const std::size_t stride, const Vec4<Float8>& v) noexcept
+{
+    for (int k = 0; k < 2; ++k)
+    {
+        store_transposed<Float4>(p + 4 * k * stride, stride, { part(v.x, k), part(v.y, k), part(v.z, k), part(v.w, k) });
+    }
+}
+
+template <>
+inline void store_transposed<Float8>(float* p, const std::size_t stride, const Vec3<Float8>& v) noexcept
+{
+    for (int k = 0; k < 2; ++k)
+    {
+        store_transposed<Float4>(p + 4 * k * stride, stride, Vec3<Float4> { part(v.x, k), part(v.y, k), part(v.z, k) });
+    }
+}
+
+#endif // AVX2
+
+#ifdef GFX_SIMD_FLOAT16
+
+inline Float16 combine(const Float4 q0, const Float4 q1, const Float4 q2, const Float4 q3) noexcept
+{
+    __m512 r = _mm512_castps128_ps512(q0.v);
+    r = _mm512_insertf32x4(r, q1.v, 1);
+    r = _mm512_insertf32x4(r, q2.v, 2);
+    r = _mm512_insertf32x4(r, q3.v, 3);
+    return { r };
+}
+
+inline Float4 part(const Float16 a, const int k) noexcept
+{
+    switch (k)
+    {
+        case 0: return { _mm512_castps512_ps128(a.v) };
+        case 1: return { _mm512_extractf32x4_ps(a.v, 1) };
+        case 2: return { _mm512_extractf32x4_ps(a.v, 2) };
+        default: return { _mm512_extractf32x4_ps(a.v, 3) };
+    }
+}
+
+// Lane indices for _mm512_permutex2var_ps, where 16 + j picks lane j of the second operand.
+// 16 vectors span three registers, so every conversion takes two permutes per register.
+struct Index16
+{
+    int i[16];
+
+    __m512i load() const noexcept { return _mm512_loadu_si512(i); }
+};
+
+// Coordinate k of the 16 interleaved vectors: first from registers (a, b), then (a:b, c)
+constexpr Index16 gather_index(const int k, const int step) noexcept
+{
+    Index16 r {};
+    for (int i = 0; i < 16; ++i)
+    {
+        const int f = 3 * i + k;
+        if (step == 0) r.i[i] = f < 32 ? f : 0;
+        else           r.i[i] = f < 32 ? i : f - 16;
+    }
+    return r;
+}
+
+// Output register n: first from registers (x, y), then (x:y, z)
+constexpr Index16 scatter_index(const int n, const int step) noexcept
+{
+    Index16 r {};
+    for (int j = 0; j < 16; ++j)
+    {
+        const int f = 16 * n + j;
+        const int k = f % 3;
+        const int i = f / 3;
+        if (step == 0) r.i[j] = k == 0 ? i : k == 1 ? 16 + i : 0;
+        else           r.i[j] = k == 2 ? 16 + i : j;
+    }
+    return r;
+}
+
+template <>
+inline Vec3<Float16> load_xyz<Float16>(const float* p) noexcept
+{
+    static constexpr Index16 index[3][2] = {
+        { gather_index(0, 0), gather_index(0, 1) },
+        { gather_index(1, 0), gather_index(1, 1) },
+        { gather_index(2, 0), gather_index(2, 1) },
+    };
+
+    const __m512 a = _mm512_loadu_ps(p);
+    const __m512 b = _mm512_loadu_ps(p + 16);
+    const __m512 c = _mm512_loadu_ps(p + 32);
+
+    __m512 r[3];
+    for (int k = 0; k < 3; ++k)
+    {
+        const __m512 ab = _mm512_permutex2var_ps(a, index[k][0].load(), b);
+        r[k] = _mm512_permutex2var_ps(ab, index[k][1].load(), c);
+    }
+    return { { r[0] }, { r[1] }, { r[2] } };
+}
+
+template <>
+inline void store_xyz<Float16>(float* p, const Vec3<Float16>& v) noexcept
+{
+    static constexpr Index16 index[3][2] = {
+        { scatter_index(0, 0), scatter_index(0, 1) },
+        { scatter_index(1, 0), scatter_index(1, 1) },
+        { scatter_index(2, 0), scatter_index(2, 1) },
+    };
+
+    for (int n = 0; n < 3; ++n)
+    {
+        const __m512 xy = _mm512_permutex2var_ps(v.x.v, index[n][0].load(), v.y.v);
+        _mm512_storeu_ps(p + 16 * n, _mm512_permutex2var_ps(xy, index[n][1].load(), v.z.v));
+    }
+}
+
+template <>
+inline Vec4<Float16> load_xyzw<Float16>(const float* p) noexcept
+{
+    Vec4<Float4> q[4];
+    for (int k = 0; k < 4; ++k) q[k] = load_xyzw<Float4>(p + 16 * k);
+    return {
+        combine(q[0].x, q[1].x, q[2].x, q[3].x),
+        combine(q[0].y, q[1].y, q[2].y, q[3].y),
+        combine(q[0].z, q[1].z, q[2].z, q[3].z),
+        combine(q[0].w, q[1].w, q[2].w, q[3].w),
+    };
+}
+
+template <>
+inline Vec4<Float16> load_transposed<Float16>(const float* p, const std::size_t stride) noexcept
+{
+    Vec4<Float4> q[4];
+    for (int k = 0; k < 4; ++k) q[k] = load_transposed<Float4>(p + 4 * k * stride, stride);
+    return {
+        combine(q[0].x, q[1].x, q[2].x, q[3].x),
+        combine(q[0].y, q[1].y, q[2].y, q[3].y),
+        combine(q[0].z, q[1].z, q[2].z, q[3].z),
+        combine(q[0].w, q[1].w, q[2].w, q[3].w),
+    };
+}
+
+template <>
+inline Vec4<Float16> load_transposed<Float16>(const float* const* p, const std::size_t offset) noexcept
+{
+    Vec4<Float4> q[4];
+    for (int k = 0; k < 4; ++k) q[k] = load_transposed<Float4>(p + 4 * k, offset);
+    return {
+        combine(q[0].x, q[1].x, q[2].x, q[3].x),
+        combine(q[0].y, q[1].y, q[2].y, q[3].y),
+        combine(q[0].z, q[1].z, q[2].z, q[3].z),
+        combine(q[0].w, q[1].w, q[2].w, q[3].w),
+    };
+}
+
+template <>
+inline void store_transposed<Float16>(float* p, const std::size_t stride, const Vec4<Float16>& v) noexcept
+{
+    for (int k = 0; k < 4; ++k)
+    {
+        store_transposed<Float4>(p + 4 * k * stride, stride, { part(v.x, k), part(v.y, k), part(v.z, k), part(v.w, k) });
+    }
+}
+
+template <>
+inline void store_transposed<Float16>(float* p, const std::size_t stride, const Vec3<Float16>& v) noexcept
+{
+    for (int k = 0; k < 4; ++k)
+    {
+        store_transposed<Float4>(p + 4 * k * stride, stride, Vec3<Float4> { part(v.x, k), part(v.y, k), part(v.z, k) });
+    }
+}
+
+#endif // AVX-512
+
+} // namespace
+} // namespace gfx::simd::GFX_SIMD_ISA
@@ -0,0 +1,59 @@
+// Kernels behind RayPacket.h, included by Kernels.inl.
+
+namespace gfx::simd::GFX_SIMD_ISA
+{
+namespace
+{
+
+void intersect_spheres(
+    const ConstSoA start,
+    const ConstSoA dir,
+    const std::size_t n,
+    const float* const spheres,
+    const std::size_t count,
+    float* const t,
+    std::uint32_t* const index) noexcept
+{
+    constexpr float inf = std::numeric_limits<float>::infinity();
+
+    for_lanes(n, [&]<typename P>(const std::size_t i) {
+        const Vec3<P> G = Vec3<P>::load(start, i);
+        const Vec3<P> d = Vec3<P>::load(dir, i);
+        const P a = d.squared_norm();
+        const P inv_a = P::broadcast(1) / a;
+        const P zero = P::broadcast(0);
+
+        P closest = P::broadcast(inf);
+        for (std::size_t lane = 0; lane < P::width; ++lane) index[i + lane] = no_hit;
+
+        // Same equation as Ray::intersect, one sphere against all the lanes at a time
+        for (std::size_t s = 0; s < count; ++s)
+        {
+            const float* const sphere = spheres + 4 * s;
+            const Vec3<P> GC = G - Vec3<P>::broadcast(sphere[0], sphere[1], sphere[2]);
+            const P b = GC.dot(d);
+            const P c = GC.squared_norm() - P::broadcast(sphere[3] * sphere[3]);
+
+            // Most spheres miss the whole packet, skip the square root for them
+            const P delta = b * b - a * c;
+            const auto crossing = delta >= zero;
+            if (!any(crossing)) continue;
+
+            const P k = (-b - sqrt(max(delta, zero))) * inv_a;
+
+            const auto closer = crossing && k >= zero && k < closest;
+            if (!any(closer)) continue;
+
+            closest = select(closer, k, closest);
+            const unsigned hits = bits(closer);
+            for (std::size_t lane = 0; lane < P::width; ++lane)
+            {
+                if (hits >> lane & 1) index[i + lane] = std::uint32_t(s);
+            }
+        }
+        closest.store(t + i);
+    });
+}
+
+} // namespace
+} // namespace gfx::simd::GFX_SIMD_ISA
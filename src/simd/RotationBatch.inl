@@ -0,0 +1,247 @@
+// Kernels behind RotationBatch.h, included by Kernels.inl.
+
+namespace gfx::simd::GFX_SIMD_ISA
+{
+namespace
+{
+
+void rotate(const float* const m, const ConstSoA in, const SoA out, const std::size_t n) noexcept
+{
+    for_lanes(n, [&]<typename P>(const std::size_t i) {
+        (Mat3<P>::broadcast(m) * Vec3<P>::load(in, i)).store(out, i);
+    });
+}
+
+void rotate_xyz(const float* const m, const float* const in, float* const out, const std::size_t n) noexcept
+{
+    for_lanes(n, [&]<typename P>(const std::size_t i) {
+        store_xyz<P>(out + 3 * i, Mat3<P>::broadcast(m) * load_xyz<P>(in + 3 * i));
+    });
+}
+
+void rotate_each_xyz(const float* const q, const float* const in, float* const out, const std::size_t n) noexcept
+{
+    for_lanes(n, [&]<typename P>(const std::size_t i) {
+        const Vec4<P> r = load_xyzw<P>(q + 4 * i);
+        const Vec3<P> w = r.xyz();
+        const Vec3<P> v = load_xyz<P>(in + 3 * i);
+
+        // Same simplification as Rotation::rotate, sharing w x v:
+        // v' = v + 2 a (w x v) + 2 w x (w x v)
+        const Vec3<P> t = w.cross(v) * P::broadcast(2);
+        store_xyz<P>(out + 3 * i, v + t * r.w + w.cross(t));
+    });
+}
+
+template <bool orthonormalize>
+void rotations_from_matrices(const float* const m, float* const q, const std::size_t n) noexcept
+{
+    for_lanes(n, [&]<typename P>(const std::size_t i) {
+        // Elements 0-3, 4-7 and 5-8 of each matrix, so that no load goes past the last one
+        const float* const p = m + 9 * i;
+        const Vec4<P> a = load_transposed<P>(p, 9);
+        const Vec4<P> b = load_transposed<P>(p + 4, 9);
+        const Vec4<P> c = load_transposed<P>(p + 5, 9);
+        Mat3<P> M = {{
+            { a.x, a.y, a.z },
+            { a.w, b.x, b.y },
+            { b.z, b.w, c.w },
+        }};
+        const P one = P::broadcast(1);
+
+        if constexpr (orthonormalize)
+        {
+            // Same as Matrix3::orthonormalized
+            const P half_error = M.rows[0].dot(M.rows[1]) * P::broadcast(0.5f);
+            Vec3<P> x = M.rows[0] - M.rows[1] * half_error;
+            x = x * (one / x.norm());
+            Vec3<P> z = x.cross(M.rows[1] - M.rows[0] * half_error);
+            z = z * (one / z.norm());
+            M = {{ x, z.cross(x), z }};
+        }
+
+        // Rotation::from_matrix3, with the 4 cases computed for every lane
+        // and the one with the largest diagonal term selected
+        const Vec3<P>* const r = M.rows;
+        const P w4 = one + r[0].x + r[1].y + r[2].z;
+        const P x4 = one + r[0].x - r[1].y - r[2].z;
+        const P y4 = one - r[0].x + r[1].y - r[2].z;
+        const P z4 = one - r[0].x - r[1].y + r[2].z;
+
+        const P wx = r[2].y - r[1].z;
+        const P wy = r[0].z - r[2].x;
+        const P wz = r[1].x - r[0].y;
+        const P xy = r[0].y + r[1].x;
+        const P xz = r[0].z + r[2].x;
+        const P yz = r[1].z + r[2].y;
+
+        const auto x_largest = x4 > w4;
+        Vec4<P> v = {
+            select(x_largest, x4, wx),
+            select(x_largest, xy, wy),
+            select(x_largest, xz, wz),
+            select(x_largest, wx, w4),
+        };
+        P largest = max(w4, x4);
+
+        const auto y_largest = y4 > largest;
+        v = { select(y_largest, xy, v.x), select(y_largest, y4, v.y), select(y_largest, yz, v.z), select(y_largest, wy, v.w) };
+        largest = max(largest, y4);
+
+        const auto z_largest = z4 > largest;
+        v = { select(z_largest, xz, v.x), select(z_largest, yz, v.y), select(z_largest, z4, v.z), select(z_largest, wz, v.w) };
+
+        const P k = one / sqrt(fmadd(v.x, v.x, fmadd(v.y, v.y, fmadd(v.z, v.z, v.w * v.w))));
+        store_transposed<P>(q + 4 * i, 4, Vec4<P> { v.x * k, v.y * k, v.z * k, v.w * k });
+    });
+}
+
+void rotations_from_euler(const float* const angles, const EulerTerms& euler, float* const q, const std::size_t n) noexcept
+{
+    for_lanes(n, [&]<typename P>(const std::size_t i) {
+        const Vec3<P> v = load_xyz<P>(angles + 3 * i);
+        const P components[3] = { v.x, v.y, v.z };
+        const P half = P::broadcast(0.5f);
+
+        P c[3];
+        P s[3];
+        for (int k = 0; k < 3; ++k) sin_cos(components[euler.angle[k]] * half, s[k], c[k]);
+
+        // The 8 products of one sine or cosine per rotation, indexed like EulerTerms::sines
+        const P c12 = c[0] * c[1];
+        const P s1c2 = s[0] * c[1];
+        const P c1s2 = c[0] * s[1];
+        const P s12 = s[0] * s[1];
+        const P products[8] = {
+            c12 * c[2], s1c2 * c[2], c1s2 * c[2], s12 * c[2],
+            c12 * s[2], s1c2 * s[2], c1s2 * s[2], s12 * s[2],
+        };
+
+        P r[4];
+        for (int j = 0; j < 4; ++j)
+        {
+            r[j] = fmadd(
+                products[euler.sines[j][1]], P::broadcast(euler.sign[j][1]),
+                products[euler.sines[j][0]] * P::broadcast(euler.sign[j][0]));
+        }
+        store_transposed<P>(q + 4 * i, 4, Vec4<P> { r[0], r[1], r[2], r[3] });
+    });
+}
+
+/**
+ * Quaternion product a b, same as gfx::Quaternion::operator*.
+ */
+template <typename P>
+Vec4<P> multiply(const Vec4<P>& a, const Vec4<P>& b) noexcept
+{
+    const Vec3<P> v = a.xyz();
+    const Vec3<P> w = b.xyz();
+    const Vec3<P> c = v.cross(w);
+    return {
+        fmadd(v.x, b.w, fmadd(w.x, a.w, c.x)),
+        fmadd(v.y, b.w, fmadd(w.y, a.w, c.y)),
+        fmadd(v.z, b.w, fmadd(w.z, a.w, c.z)),
+        a.w * b.w - v.dot(w),
+    };
+}
+
+template <typename P>
+Vec4<P> normalized(const Vec4<P>& q) noexcept
+{
+    const P k = P::broadcast(1) / sqrt(fmadd(q.x, q.x, fmadd(q.y, q.y, fmadd(q.z, q.z, q.w * q.w))));
+    return { q.x * k, q.y * k, q.z * k, q.w * k };
+}
+
+void premultiply_rotations(const float* const p, float* const q, const std::size_t n) noexcept
+{
+    std::size_t i = 0;
+#ifdef GFX_SIMD_FLOAT4
+    // Linear in q: p q = pw q + px (qw, -qz, qy, -qx) + py (qz, qw, -qx, -qy) + pz (-qy, qx, qw, -qz),
+    // which permutes the components of each quaternion instead of transposing them
+    const float kx[4] = { p[0], -p[0], p[0], -p[0] };
+    const float ky[4] = { p[1], p[1], -p[1], -p[1] };
+    const float kz[4] = { -p[2], p[2], p[2], -p[2] };
+    const Wide x = Wide::broadcast4(kx);
+    const Wide y = Wide::broadcast4(ky);
+    const Wide z = Wide::broadcast4(kz);
+    const Wide w = Wide::broadcast(p[3]);
+
+    constexpr std::size_t per_pack = Wide::width / 4;
+    for (; i + per_pack <= n; i += per_pack)
+    {
+        const Wide r = Wide::load(q + 4 * i);
+        const Wide product = fmadd(swizzle<3, 2, 1, 0>(r), x,
+            fmadd(swizzle<2, 3, 0, 1>(r), y,
+            fmadd(swizzle<1, 0, 3, 2>(r), z, r * w)));
+        product.store(q + 4 * i);
+    }
+#endif
+
+    const Vec4<Lane1> a = { { p[0] }, { p[1] }, { p[2] }, { p[3] } };
+    for (; i < n; ++i)
+    {
+        store_transposed<Lane1>(q + 4 * i, 4, multiply(a, load_xyzw<Lane1>(q + 4 * i)));
+    }
+}
+
+void prefix_rotations(const float* const q, float* const out, const std::size_t n, const std::size_t renormalize) noexcept
+{
+    // Each lane runs the chain over its own run of m rotations, so that the products
+    // of different lanes overlap instead of waiting on each other
+    constexpr std::size_t lanes = Wide::width;
+    // Runs an odd number of cache lines apart, or long power of two chains would put
+    // the streams of every lane in the same cache sets
+    std::size_t lines = n / lanes / 4;
+    if (lines % 2 == 0 && lines > 0) --lines;
+    const std::size_t m = lines < 2 ? 0 : 4 * lines;
+
+    const Wide zero = Wide::broadcast(0);
+    Vec4<Wide> chain = { zero, zero, zero, Wide::broadcast(1) };
+    for (std::size_t j = 0; j < m; ++j)
+    {
+        chain = multiply(chain, load_transposed<Wide>(q + 4 * j, 4 * m));
+        if (renormalize != 0 && (j + 1) % renormalize == 0) chain = normalized(chain);
+        store_transposed<Wide>(out + 4 * j, 4 * m, chain);
+    }
+
+    // Then every run starts from the last rotation of the one before it, already complete
+    for (std::size_t k = 1; k < lanes && m > 0; ++k)
+    {
+        Vec4<Lane1> carry = load_xyzw<Lane1>(out + 4 * (k * m - 1));
+        if (renormalize != 0) carry = normalized(carry);
+        const float p[4] = { carry.x.v, carry.y.v, carry.z.v, carry.w.v };
+        premultiply_rotations(p, out + 4 * k * m, m);
+    }
+
+    // Leftovers, one at a time
+    for (std::size_t i = lanes * m; i < n; ++i)
+    {
+        const Vec4<Lane1> r = load_xyzw<Lane1>(q + 4 * i);
+        Vec4<Lane1> next = i == 0 ? r : multiply(load_xyzw<Lane1>(out + 4 * (i - 1)), r);
+        if (renormalize != 0 && (i + 1) % renormalize == 0) next = normalized(next);
+        store_transposed<Lane1>(out + 4 * i, 4, next);
+    }
+}
+
+void integrate_angular_velocities(float* const q, const float* const angular_velocities, const float dt, const std::size_t n) noexcept
+{
+    for_lanes(n, [&]<typename P>(const std::size_t i) {
+        const Vec4<P> r = load_xyzw<P>(q + 4 * i);
+        const Vec3<P> h = load_xyz<P>(angular_velocities + 3 * i) * P::broadcast(dt / 2);
+
+        // r + (h, 0) r
+        const Vec4<P> step = multiply(Vec4<P> { h.x, h.y, h.z, P::broadcast(0) }, r);
+        const Vec4<P> next = { r.x + step.x, r.y + step.y, r.z + step.z, r.w + step.w };
+
+        // Same as Rotation::from_drifted_quaternion, the square root only for packs with large steps
+        const P one = P::broadcast(1);
+        const P s = dot4(next, next);
+        P k = (P::broadcast(3) - s) * P::broadcast(0.5f);
+        const auto large = abs(s - one) > P::broadcast(renormalize_limit);
+        if (any(large)) k = select(large, one / sqrt(s), k);
+        store_transposed<P>(q + 4 * i, 4, Vec4<P> { next.x * k, next.y * k, next.z * k, next.w * k });
+    });
+}
+
+} // namespace
+} // namespace gfx::simd::GFX_SIMD_ISA
@@ -0,0 +1,134 @@
+// Kernels behind RotationEncoding.h, included by Kernels.inl.
+
+namespace gfx::simd::GFX_SIMD_ISA
+{
+namespace
+{
+
+// Smallest-three codes of the given size in bytes: the index of the largest component
+// in the top 2 bits, then the three other components in order, with b bits each.
+// Their values lie in [-1/√2, 1/√2], mapped linearly to [0, 2^b - 1].
+template <unsigned bytes>
+struct SmallestThree
+{
+    static constexpr unsigned b = (8 * bytes - 2) / 3;
+    static constexpr std::uint64_t mask = (std::uint64_t(1) << b) - 1;
+    static constexpr float max_code = float(mask);
+
+    // Little endian, whatever the platform
+    static void store(std::uint8_t* const p, const std::uint64_t code) noexcept
+    {
+        for (unsigned k = 0; k < bytes; ++k) p[k] = std::uint8_t(code >> 8 * k);
+    }
+
+    static std::uint64_t load(const std::uint8_t* const p) noexcept
+    {
+        std::uint64_t code = 0;
+        for (unsigned k = 0; k < bytes; ++k) code |= std::uint64_t(p[k]) << 8 * k;
+        return code;
+    }
+};
+
+constexpr float sqrt_half = 0.70710678f;
+
+template <unsigned bytes>
+void encode_rotations(const float* const q, std::uint8_t* const out, const std::size_t n) noexcept
+{
+    using Code = SmallestThree<bytes>;
+
+    for_lanes(n, [&]<typename P>(const std::size_t i) {
+        const Vec4<P> r = load_transposed<P>(q + 4 * i, 4);
+
+        // Largest component by magnitude, and its index as a float
+        P largest = r.x;
+        P index = P::broadcast(0);
+        const auto pick = [&](const P c, const float k) {
+            const auto larger = abs(c) > abs(largest);
+            largest = select(larger, c, largest);
+            index = select(larger, P::broadcast(k), index);
+        };
+        pick(r.y, 1);
+        pick(r.z, 2);
+        pick(r.w, 3);
+
+        // q and -q are the same rotation: keep the dropped component positive,
+        // so the decoder can rebuild it from the unit norm
+        const P scale = select(largest < P::broadcast(0), P::broadcast(-1), P::broadcast(1)) * P::broadcast(Code::max_code * sqrt_half);
+        // Half a step more, so the integer conversion rounds to nearest
+        const P offset = P::broadcast(Code::max_code * 0.5f + 0.5f);
+        const P zero = P::broadcast(0);
+        const P max_code = P::broadcast(Code::max_code);
+
+        const P smallest[3] = {
+            select(index < P::broadcast(0.5f), r.y, r.x),
+            select(index < P::broadcast(1.5f), r.z, r.y),
+            select(index < P::broadcast(2.5f), r.w, r.z),
+        };
+
+        float codes[4][P::width];
+        index.store(codes[0]);
+        for (int k = 0; k < 3; ++k)
+        {
+            min(max(fmadd(smallest[k], scale, offset), zero), max_code).store(codes[k + 1]);
+        }
+
+        for (std::size_t j = 0; j < P::width; ++j)
+        {
+            // Through int32, which converts from float in one instruction
+            const auto integer = [&](const int k) { return std::uint64_t(std::int32_t(codes[k][j])); };
+            const std::uint64_t code = integer(0) << (8 * bytes - 2)
+                                     | integer(1) << (2 * Code::b)
+                                     | integer(2) << Code::b
+                                     | integer(3);
+            Code::store(out + bytes * (i + j), code);
+        }
+    });
+}
+
+template <unsigned bytes>
+void decode_rotations(const std::uint8_t* const in, float* const q, const std::size_t n) noexcept
+{
+    using Code = SmallestThree<bytes>;
+
+    for_lanes(n, [&]<typename P>(const std::size_t i) {
+        float codes[4][P::width];
+        for (std::size_t j = 0; j < P::width; ++j)
+        {
+            const std::uint64_t code = Code::load(in + bytes * (i + j));
+            codes[0][j] = float(std::int32_t(code >> (8 * bytes - 2)));
+            codes[1][j] = float(std::int32_t((code >> (2 * Code::b)) & Code::mask));
+            codes[2][j] = float(std::int32_t((code >> Code::b) & Code::mask));
+            codes[3][j] = float(std::int32_t(code & Code::mask));
+        }
+
+        const P index = P::load(codes[0]);
+        const P scale = P::broadcast(2 * sqrt_half / Code::max_code);
+        const P offset = P::broadcast(-sqrt_half);
+        const Vec3<P> c = {
+            fmadd(P::load(codes[1]), scale, offset),
+            fmadd(P::load(codes[2]), scale, offset),
+            fmadd(P::load(codes[3]), scale, offset),
+        };
+
+        // Rebuild the largest component from the unit norm. Invalid codes can make
+        // the three others longer than 1: normalizing keeps the result a rotation
+        const P one = P::broadcast(1);
+        const P s = c.squared_norm();
+        const P largest = sqrt(max(one - s, P::broadcast(0)));
+        const P k = one / sqrt(max(s, one));
+
+        const auto is_0 = index < P::broadcast(0.5f);
+        const auto is_1 = index < P::broadcast(1.5f);
+        const auto is_2 = index < P::broadcast(2.5f);
+        const Vec4<P> r = {
+            select(is_0, largest, c.x) * k,
+            select(is_0, c.x, select(is_1, largest, c.y)) * k,
+            select(is_1, c.y, select(is_2, largest, c.z)) * k,
+            select(is_2, c.z, largest) * k,
+        };
+        store_transposed<P>(q + 4 * i, 4, r);
+    });
+}
+
+} // namespace
+} // namespace gfx::simd::GFX_SIMD_ISA
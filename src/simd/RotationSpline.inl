@@ -0,0 +1,90 @@
+// Kernels behind RotationSpline.h, included by Kernels.inl.
+
+namespace gfx::simd::GFX_SIMD_ISA
+{
+namespace
+{
+
+/**
+ * Slerp of unit quaternions, taking the shortest path, like Rotation::slerp.
+ * Close rotations keep the nlerp weights without normalizing: the result is then off unit length
+ * by less than 1e-5, for the caller to normalize once.
+ */
+template <typename P>
+Vec4<P> slerp(const Vec4<P>& p, const Vec4<P>& q, const P u) noexcept
+{
+    const P one = P::broadcast(1);
+    const P v = one - u;
+    const P d = dot4(p, q);
+    const P cos_θ = abs(d);
+    const P θ = acos(cos_θ);
+    const P inv_sin_θ = one / sin_quadrant(θ);
+    const auto close = cos_θ > P::broadcast(1 - 1e-5f);
+    const P wp = select(close, v, sin_quadrant(v * θ) * inv_sin_θ);
+    P wq = select(close, u, sin_quadrant(u * θ) * inv_sin_θ);
+    wq = select(d < P::broadcast(0), -wq, wq);
+    return {
+        fmadd(p.x, wp, q.x * wq),
+        fmadd(p.y, wp, q.y * wq),
+        fmadd(p.z, wp, q.z * wq),
+        fmadd(p.w, wp, q.w * wq),
+    };
+}
+
+/**
+ * exp((k v, 0)), same as gfx::Rotation::from_log(k v).
+ */
+template <typename P>
+Vec4<P> exp(const Vec3<P>& v, const P k) noexcept
+{
+    const Vec3<P> w = v * k;
+    const P θ = sqrt(w.dot(w));
+    P s, c;
+    sin_cos(θ, s, c);
+    const Vec3<P> imaginary = w * select(θ > P::broadcast(0), s / θ, P::broadcast(1));
+    return { imaginary.x, imaginary.y, imaginary.z, c };
+}
+
+// Controls of squad keys are (q, s_in, s_out), 12 floats each
+void squad_rotations(
+    const float* const* const from,
+    const float* const* const to,
+    const float* const u,
+    float* const out,
+    const std::size_t n) noexcept
+{
+    for_lanes(n, [&]<typename P>(const std::size_t i) {
+        const Vec4<P> p = load_transposed<P>(from + i, 0);
+        const Vec4<P> a = load_transposed<P>(from + i, 8);
+        const Vec4<P> b = load_transposed<P>(to + i, 4);
+        const Vec4<P> q = load_transposed<P>(to + i, 0);
+
+        const P t = P::load(u + i);
+        const P h = (t - t * t) * P::broadcast(2);
+        store_transposed<P>(out + 4 * i, 4, normalized(slerp(slerp(p, q, t), slerp(a, b, t), h)));
+    });
+}
+
+// Controls of B-spline segments are 3 consecutive (q_{k - 1}, ω_k, unused) of 8 floats
+void b_spline_rotations(const float* const* const controls, const float* const u, float* const out, const std::size_t n) noexcept
+{
+    for_lanes(n, [&]<typename P>(const std::size_t i) {
+        const P t = P::load(u + i);
+        const P t2 = t * t;
+        const P t3 = t2 * t;
+        const P sixth = P::broadcast(1.0f / 6);
+        // Cumulative basis functions
+        const P b1 = fmadd(t3 - P::broadcast(3) * t2, sixth, fmadd(t, P::broadcast(0.5f), P::broadcast(5.0f / 6)));
+        const P b2 = fmadd(P::broadcast(3) * t2 - P::broadcast(2) * t3, sixth, fmadd(t, P::broadcast(0.5f), sixth));
+        const P b3 = t3 * sixth;
+
+        Vec4<P> r = load_transposed<P>(controls + i, 0);
+        r = multiply(r, exp(load_transposed<P>(controls + i, 4).xyz(), b1));
+        r = multiply(r, exp(load_transposed<P>(controls + i, 12).xyz(), b2));
+        r = multiply(r, exp(load_transposed<P>(controls + i, 20).xyz(), b3));
+        store_transposed<P>(out + 4 * i, 4, normalized(r));
+    });
+}
+
+} // namespace
+} // namespace gfx::simd::GFX_SIMD_ISA
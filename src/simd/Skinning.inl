@@ -0,0 +1,185 @@
+// Kernels behind Skinning.h, included by Kernels.inl.
+
+namespace gfx::simd::GFX_SIMD_ISA
+{
+namespace
+{
+
+/**
+ * Pointers to the bones of influence k of the P::width vertices from i, bones having stride floats each.
+ */
+template <typename P>
+void gather_bones(
+    const std::uint16_t* const bones,
+    const std::size_t count,
+    const float* const data,
+    const std::size_t stride,
+    const std::size_t i,
+    const std::size_t k,
+    const float* (&bone)[P::width]) noexcept
+{
+    for (std::size_t lane = 0; lane < P::width; ++lane) bone[lane] = data + stride * bones[(i + lane) * count + k];
+}
+
+/**
+ * Calls f(k, bone, weight) for each influence of the P::width vertices from i.
+ * With a fixed count (4 or 8 being the usual ones), the loop unrolls
+ * and the weights load 4 at a time, as quadruples.
+ */
+template <std::size_t fixed, typename P, typename F>
+void for_influences(const Influences& influences, const float* const data, const std::size_t stride, const std::size_t i, F&& f) noexcept
+{
+    const std::size_t count = fixed != 0 ? fixed : influences.count;
+    const float* bone[P::width];
+    if constexpr (fixed % 4 == 0 && fixed != 0)
+    {
+        for (std::size_t k = 0; k < count; k += 4)
+        {
+            const Vec4<P> w = load_transposed<P>(influences.weights + i * count + k, count);
+            const P weights[4] = { w.x, w.y, w.z, w.w };
+            for (std::size_t j = 0; j < 4; ++j)
+            {
+                gather_bones<P>(influences.bones, count, data, stride, i, k + j, bone);
+                f(k + j, bone, weights[j]);
+            }
+        }
+    }
+    else
+    {
+        for (std::size_t k = 0; k < count; ++k)
+        {
+            float w[P::width];
+            for (std::size_t lane = 0; lane < P::width; ++lane) w[lane] = influences.weights[(i + lane) * count + k];
+            gather_bones<P>(influences.bones, count, data, stride, i, k, bone);
+            f(k, bone, P::load(w));
+        }
+    }
+}
+
+template <typename P>
+Vec4<P> weighted_sum(const Vec4<P>& sum, const Vec4<P>& v, const P w) noexcept
+{
+    return { fmadd(v.x, w, sum.x), fmadd(v.y, w, sum.y), fmadd(v.z, w, sum.z), fmadd(v.w, w, sum.w) };
+}
+
+template <typename P>
+Vec3<P> normalized3(const Vec3<P>& v) noexcept
+{
+    return v * (P::broadcast(1) / v.norm());
+}
+
+template <std::size_t fixed>
+void skin_linear_n(
+    const Influences& influences,
+    const float* const matrices,
+    const ConstSoA positions,
+    const ConstSoA normals,
+    const SoA out_positions,
+    const SoA out_normals,
+    const std::size_t n) noexcept
+{
+    for_lanes(n, [&]<typename P>(const std::size_t i) {
+        // Sums of the 3x4 matrices as 3 quadruples:
+        // (c0x c0y c0z c1x), (c1y c1z c2x c2y), (c2z tx ty tz)
+        const P zero = P::broadcast(0);
+        Vec4<P> m[3] = {
+            { zero, zero, zero, zero },
+            { zero, zero, zero, zero },
+            { zero, zero, zero, zero },
+        };
+        for_influences<fixed, P>(influences, matrices, 12, i, [&](std::size_t, const float* const* bone, const P w) {
+            for (std::size_t j = 0; j < 3; ++j) m[j] = weighted_sum(m[j], load_transposed<P>(bone, 4 * j), w);
+        });
+
+        const Vec3<P> c0 = { m[0].x, m[0].y, m[0].z };
+        const Vec3<P> c1 = { m[0].w, m[1].x, m[1].y };
+        const Vec3<P> c2 = { m[1].z, m[1].w, m[2].x };
+        const Vec3<P> t = { m[2].y, m[2].z, m[2].w };
+
+        const Vec3<P> p = Vec3<P>::load(positions, i);
+        (c0 * p.x + c1 * p.y + c2 * p.z + t).store(out_positions, i);
+
+        if (normals.x)
+        {
+            const Vec3<P> v = Vec3<P>::load(normals, i);
+            normalized3(c0 * v.x + c1 * v.y + c2 * v.z).store(out_normals, i);
+        }
+    });
+}
+
+template <std::size_t fixed>
+void skin_dual_quaternion_n(
+    const Influences& influences,
+    const float* const bones,
+    const ConstSoA positions,
+    const ConstSoA normals,
+    const SoA out_positions,
+    const SoA out_normals,
+    const std::size_t n) noexcept
+{
+    for_lanes(n, [&]<typename P>(const std::size_t i) {
+        const P zero = P::broadcast(0);
+        Vec4<P> real = { zero, zero, zero, zero };
+        Vec4<P> dual = real;
+        Vec4<P> first = real;
+        for_influences<fixed, P>(influences, bones, 8, i, [&](const std::size_t k, const float* const* bone, P w) {
+            const Vec4<P> r = load_transposed<P>(bone, 0);
+            const Vec4<P> d = load_transposed<P>(bone, 4);
+
+            // q and -q are the same transform, the closest to the first one gets blended
+            if (k == 0) first = r;
+            else w = select(dot4(first, r) < zero, -w, w);
+            real = weighted_sum(real, r, w);
+            dual = weighted_sum(dual, d, w);
+        });
+
+        // Same as DualQuaternion::transform_point, divided by the norm of the real part
+        const P inv_norm = P::broadcast(1) / sqrt(dot4(real, real));
+        const Vec3<P> v = real.xyz() * inv_norm;
+        const P s = real.w * inv_norm;
+        const Vec3<P> dv = dual.xyz() * inv_norm;
+        const P ds = dual.w * inv_norm;
+        const P two = P::broadcast(2);
+
+        const Vec3<P> p = Vec3<P>::load(positions, i);
+        const Vec3<P> t = (dv * s - v * ds + v.cross(dv)) * two;
+        (p + v.cross(v.cross(p) + p * s) * two + t).store(out_positions, i);
+
+        if (normals.x)
+        {
+            const Vec3<P> u = Vec3<P>::load(normals, i);
+            (u + v.cross(v.cross(u) + u * s) * two).store(out_normals, i);
+        }
+    });
+}
+
+// Fixed counts for the usual 4 and 8 influences, 0 for any other
+
+void skin_linear(
+    const Influences& influences,
+    const float* const matrices,
+    const ConstSoA positions,
+    const ConstSoA normals,
+    const SoA out_positions,
+    const SoA out_normals,
+    const std::size_t n) noexcept
+{
+    const auto skin = influences.count == 4 ? skin_linear_n<4> : influences.count == 8 ? skin_linear_n<8> : skin_linear_n<0>;
+    skin(influences, matrices, positions, normals, out_positions, out_normals, n);
+}
+
+void skin_dual_quaternion(
+    const Influences& influences,
+    const float* const bones,
+    const ConstSoA positions,
+    const ConstSoA normals,
+    const SoA out_positions,
+    const SoA out_normals,
+    const std::size_t n) noexcept
+{
+    const auto skin = influences.count == 4 ? skin_dual_quaternion_n<4> : influences.count == 8 ? skin_dual_quaternion_n<8> : skin_dual_quaternion_n<0>;
+    skin(influences, bones, positions, normals, out_positions, out_normals, n);
+}
+
+} // namespace
+} // namespace gfx::simd::GFX_SIMD_ISA
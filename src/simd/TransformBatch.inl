@@ -0,0 +1,73 @@
+// Kernels behind TransformBatch.h, included by Kernels.inl.
+
+namespace gfx::simd::GFX_SIMD_ISA
+{
+namespace
+{
+
+// Floats per transform: translation, rotation (x, y, z, w), scale
+constexpr std::size_t transform_stride = 10;
+
+/**
+ * Columns of the affine matrices of P::width consecutive transforms,
+ * the fourth one being the translation.
+ */
+template <typename P>
+void affine_columns(const float* const t, Vec3<P> (&columns)[4]) noexcept
+{
+    // Overlapping quadruples, all within the transform:
+    // (tx ty tz qx), (qx qy qz qw), (qw sx sy sz)
+    const Vec4<P> a = load_transposed<P>(t, transform_stride);
+    const Vec4<P> q = load_transposed<P>(t + 3, transform_stride);
+    const Vec4<P> s = load_transposed<P>(t + 6, transform_stride);
+
+    // Same matrix as Rotation::as_matrix3, with the products doubled once
+    const P one = P::broadcast(1);
+    const P x2 = q.x + q.x;
+    const P y2 = q.y + q.y;
+    const P z2 = q.z + q.z;
+    const P xx = q.x * x2, yy = q.y * y2, zz = q.z * z2;
+    const P xy = q.x * y2, xz = q.x * z2, yz = q.y * z2;
+    const P wx = q.w * x2, wy = q.w * y2, wz = q.w * z2;
+
+    columns[0] = Vec3<P> { one - (yy + zz), xy + wz, xz - wy } * s.y;
+    columns[1] = Vec3<P> { xy - wz, one - (xx + zz), yz + wx } * s.z;
+    columns[2] = Vec3<P> { xz + wy, yz - wx, one - (xx + yy) } * s.w;
+    columns[3] = a.xyz();
+}
+
+void transform_to_4x4(const float* const t, float* const out, const std::size_t n) noexcept
+{
+    for_lanes(n, [&]<typename P>(const std::size_t i) {
+        Vec3<P> columns[4];
+        affine_columns<P>(t + transform_stride * i, columns);
+
+        const P zero = P::broadcast(0);
+        float* const m = out + 16 * i;
+        for (int c = 0; c < 3; ++c)
+        {
+            store_transposed<P>(m + 4 * c, 16, { columns[c].x, columns[c].y, columns[c].z, zero });
+        }
+        store_transposed<P>(m + 12, 16, { columns[3].x, columns[3].y, columns[3].z, P::broadcast(1) });
+    });
+}
+
+void transform_to_3x4(const float* const t, float* const out, const std::size_t n) noexcept
+{
+    for_lanes(n, [&]<typename P>(const std::size_t i) {
+        Vec3<P> columns[4];
+        affine_columns<P>(t + transform_stride * i, columns);
+
+        // Columns as four floats, the spare one being the start of the next column,
+        // except for the last one, which would spill into the next matrix
+        float* const m = out + 12 * i;
+        for (int c = 0; c < 3; ++c)
+        {
+            store_transposed<P>(m + 3 * c, 12, { columns[c].x, columns[c].y, columns[c].z, columns[c + 1].x });
+        }
+        store_transposed<P>(m + 9, 12, columns[3]);
+    });
+}
+
+} // namespace
+} // namespace gfx::simd::GFX_SIMD_ISA
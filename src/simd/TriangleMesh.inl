@@ -0,0 +1,152 @@
+// Kernels behind TriangleMesh.h, included by Kernels.inl.
+
+namespace gfx::simd::GFX_SIMD_ISA
+{
+namespace
+{
+
+/**
+ * Triangles as 3 indices into interleaved vertices, followed by one more vertex:
+ * each vertex gets loaded as 4 floats, then transposed.
+ */
+struct IndexedTriangles
+{
+    const float* vertices;
+    const std::uint32_t* indices;
+
+    template <typename P>
+    void load(const std::size_t i, Vec3<P>& a, Vec3<P>& e1, Vec3<P>& e2) const noexcept
+    {
+        const float* v[3][P::width];
+        for (std::size_t lane = 0; lane < P::width; ++lane)
+        {
+            const std::uint32_t* const triangle = indices + 3 * (i + lane);
+            for (std::size_t k = 0; k < 3; ++k) v[k][lane] = vertices + 3 * std::size_t(triangle[k]);
+        }
+        a = load_transposed<P>(v[0], 0).xyz();
+        e1 = load_transposed<P>(v[1], 0).xyz() - a;
+        e2 = load_transposed<P>(v[2], 0).xyz() - a;
+    }
+};
+
+/**
+ * Triangles as their first vertex and edges, loaded as they are.
+ */
+struct PrecomputedTriangles
+{
+    ConstSoA a;
+    ConstSoA e1;
+    ConstSoA e2;
+
+    template <typename P>
+    void load(const std::size_t i, Vec3<P>& a, Vec3<P>& e1, Vec3<P>& e2) const noexcept
+    {
+        a = Vec3<P>::load(this->a, i);
+        e1 = Vec3<P>::load(this->e1, i);
+        e2 = Vec3<P>::load(this->e2, i);
+    }
+};
+
+/**
+ * Same test as gfx::Ray::hit_distance, one ray against P::width triangles at a time.
+ * Stops at the first hit if any, else keeps the closest, the last one on ties like Ray::closest_hit.
+ */
+template <bool first, typename Triangles>
+bool intersect_triangles(
+    const float* const ray,
+    const Triangles& triangles,
+    const std::size_t n,
+    const float t_min,
+    float* const t,
+    std::uint32_t* const index) noexcept
+{
+    bool found = false;
+    for_lanes(n, [&]<typename P>(const std::size_t i) {
+        if (first && found) return;
+
+        Vec3<P> a, e1, e2;
+        triangles.template load<P>(i, a, e1, e2);
+        const Vec3<P> G = Vec3<P>::broadcast(ray[0], ray[1], ray[2]);
+        const Vec3<P> d = Vec3<P>::broadcast(ray[3], ray[4], ray[5]);
+
+        const Vec3<P> p = d.cross(e2);
+        const P inv_det = P::broadcast(1) / e1.dot(p);
+        const Vec3<P> s = G - a;
+        const P u = s.dot(p) * inv_det;
+        const Vec3<P> q = s.cross(e1);
+        const P v = d.dot(q) * inv_det;
+        const P k = e2.dot(q) * inv_det;
+
+        // A null determinant makes u infinite or NaN, failing the tests without a branch
+        const P zero = P::broadcast(0);
+        const auto hit = u >= zero && v >= zero && u + v <= P::broadcast(1) && k >= P::broadcast(t_min) && k <= P::broadcast(*t);
+        if (!any(hit)) return;
+
+        found = true;
+        if constexpr (first) return;
+
+        float distances[P::width];
+        k.store(distances);
+        const unsigned hits = bits(hit);
+        for (std::size_t lane = 0; lane < P::width; ++lane)
+        {
+            if ((hits >> lane & 1) && distances[lane] <= *t)
+            {
+                *t = distances[lane];
+                *index = std::uint32_t(i + lane);
+            }
+        }
+    });
+    return found;
+}
+
+bool closest_indexed_triangle(
+    const float* const ray,
+    const float* const vertices,
+    const std::uint32_t* const indices,
+    const std::size_t n,
+    const float t_min,
+    float* const t,
+    std::uint32_t* const index) noexcept
+{
+    return intersect_triangles<false>(ray, IndexedTriangles { vertices, indices }, n, t_min, t, index);
+}
+
+bool any_indexed_triangle(
+    const float* const ray,
+    const float* const vertices,
+    const std::uint32_t* const indices,
+    const std::size_t n,
+    const float t_min,
+    float t_max) noexcept
+{
+    return intersect_triangles<true>(ray, IndexedTriangles { vertices, indices }, n, t_min, &t_max, nullptr);
+}
+
+bool closest_precomputed_triangle(
+    const float* const ray,
+    const ConstSoA a,
+    const ConstSoA e1,
+    const ConstSoA e2,
+    const std::size_t n,
+    const float t_min,
+    float* const t,
+    std::uint32_t* const index) noexcept
+{
+    return intersect_triangles<false>(ray, PrecomputedTriangles { a, e1, e2 }, n, t_min, t, index);
+}
+
+bool any_precomputed_triangle(
+    const float* const ray,
+    const ConstSoA a,
+    const ConstSoA e1,
+    const ConstSoA e2,
+    const std::size_t n,
+    const float t_min,
+    float t_max) noexcept
+{
+    return intersect_triangles<true>(ray, PrecomputedTriangles { a, e1, e2 }, n, t_min, &t_max, nullptr);
+}
+
+} // namespace
+} // namespace gfx::simd::GFX_SIMD_ISA
@@ -0,0 +1,54 @@
+// Kernels behind Vector3Batch.h, included by Kernels.inl.
+
+namespace gfx::simd::GFX_SIMD_ISA
+{
+namespace
+{
+
+void dot(const ConstSoA a, const ConstSoA b, float* const out, const std::size_t n) noexcept
+{
+    for_lanes(n, [&]<typename P>(const std::size_t i) {
+        Vec3<P>::load(a, i).dot(Vec3<P>::load(b, i)).store(out + i);
+    });
+}
+
+void cross(const ConstSoA a, const ConstSoA b, const SoA out, const std::size_t n) noexcept
+{
+    for_lanes(n, [&]<typename P>(const std::size_t i) {
+        Vec3<P>::load(a, i).cross(Vec3<P>::load(b, i)).store(out, i);
+    });
+}
+
+void squared_norm(const ConstSoA v, float* const out, const std::size_t n) noexcept
+{
+    for_lanes(n, [&]<typename P>(const std::size_t i) {
+        Vec3<P>::load(v, i).squared_norm().store(out + i);
+    });
+}
+
+void normalize(const ConstSoA v, const SoA out, const std::size_t n) noexcept
+{
+    for_lanes(n, [&]<typename P>(const std::size_t i) {
+        const Vec3<P> u = Vec3<P>::load(v, i);
+        (u * (P::broadcast(1) / u.norm())).store(out, i);
+    });
+}
+
+void lerp(const ConstSoA a, const ConstSoA b, const float α, const SoA out, const std::size_t n) noexcept
+{
+    for_lanes(n, [&]<typename P>(const std::size_t i) {
+        const Vec3<P> u = Vec3<P>::load(a, i);
+        const Vec3<P> v = Vec3<P>::load(b, i);
+        (v * P::broadcast(α) + u * P::broadcast(1 - α)).store(out, i);
+    });
+}
+
+void distance(const ConstSoA a, const ConstSoA b, float* const out, const std::size_t n) noexcept
+{
+    for_lanes(n, [&]<typename P>(const std::size_t i) {
+        (Vec3<P>::load(b, i) - Vec3<P>::load(a, i)).norm().store(out + i);
+    });
+}
+
+} // namespace
+} // namespace gfx::simd::GFX_SIMD_ISA
@@ -0,0 +1,696 @@
+// Microbenchmarks of the library hot paths.
+//
+// Usage: gfx_bench [--filter text] [--json output.json] [--baseline previous.json] [--threshold percent]
+//
+// Every benchmark is warmed up, then timed over many samples of a calibrated number of iterations.
+// Times are per operation: one call for the single-object functions, one element for the batch ones.
+// With --baseline, benchmarks whose median got slower by more than the threshold (10% by default)
+// are reported as regressions and the exit code is 1.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Animation.h"
+#include "Archive.h"
+#include "Bvh.h"
+#include "DualQuaternion.h"
+#include "Frustum.h"
+#include "Matrix3.h"
+#include "Matrix3Batch.h"
+#include "Memory.h"
+#include "Ray.h"
+#include "Rotation.h"
+#include "RotationAccumulator.h"
+#include "RotationBatch.h"
+#include "RotationEncoding.h"
+#include "RotationSpline.h"
+#include "Simd.h"
+#include "Skinning.h"
+#include "SpatialHash.h"
+#include "ThreadPool.h"
+#include "Sphere.h"
+#include "Transform.h"
+#include "TransformBatch.h"
+#include "TriangleMesh.h"
+#include "Vector3.h"
+#include "Vector3Batch.h"
+
+using gfx::Matrix3;
+using gfx::Quaternion;
+using gfx::Ray;
+using gfx::Rotation;
+using gfx::Scalar;
+using gfx::Sphere;
+using gfx::Transform;
+using gfx::Vector3;
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * Make the compiler assume value is read, so the work producing it cannot be optimized away.
+ */
+template <typename T>
+inline void do_not_optimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    const volatile char* const p = reinterpret_cast<const volatile char*>(&value);
+    (void)*p;
+#endif
+}
+
+struct Result
+{
+    std::string name;
+    // Nanoseconds per operation
+    double median;
+    double p99;
+    double mean;
+    std::size_t samples;
+
+    double ops_per_second() const { return 1e9 / median; }
+};
+
+class Harness
+{
+private:
+    std::string _filter;
+    std::vector<Result> _results;
+
+    static constexpr auto warm_up = std::chrono::milliseconds(20);
+    static constexpr auto min_sample = std::chrono::microseconds(200);
+    static constexpr auto max_time = std::chrono::milliseconds(400);
+    static constexpr std::size_t min_samples = 11;
+    static constexpr std::size_t max_samples = 201;
+
+public:
+    explicit Harness(std::string filter)
+        : _filter(std::move(filter))
+    {
+    }
+
+    const std::vector<Result>& results() const noexcept { return _results; }
+
+    /**
+     * Time f, which performs items operations per call.
+     */
+    template <typename F>
+    void run(const std::string& name, const std::size_t items, F&& f)
+    {
+        if (name.find(_filter) == std::string::npos) return;
+
+        const auto time = [&](const std::size_t iterations) {
+            const auto start = Clock::now();
+            for (std::size_t i = 0; i < iterations; ++i) f();
+            return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        };
+
+        // Warm up caches, branch predictors and clocks, while finding enough iterations per sample
+        // for the timer resolution not to matter
+        const double min_sample_ns = std::chrono::duration<double, std::nano>(min_sample).count();
+        const auto warm_up_end = Clock::now() + warm_up;
+        std::size_t iterations = 1;
+        while (true)
+        {
+            if (time(iterations) < min_sample_ns) iterations *= 2;
+            else if (Clock::now() >= warm_up_end) break;
+        }
+
+        std::vector<double> samples;
+        const auto end = Clock::now() + max_time;
+        while (samples.size() < max_samples && (samples.size() < min_samples || Clock::now() < end))
+        {
+            samples.push_back(time(iterations) / double(iterations * items));
+        }
+
+        std::sort(samples.begin(), samples.end());
+        double sum = 0;
+        for (const double s : samples) sum += s;
+
+        const std::size_t p99 = std::size_t(std::ceil(0.99 * samples.size())) - 1;
+        _results.push_back({ name, samples[samples.size() / 2], samples[p99], sum / samples.size(), samples.size() });
+
+        const Result& r = _results.back();
+        std::cout << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(12) << r.median << " ns/op (p99 " << std::setw(9) << r.p99 << ")"
+                  << std::setw(16) << std::setprecision(0) << r.ops_per_second() << " ops/s\n";
+    }
+};
+
+void write_json(std::ostream& os, const std::vector<Result>& results)
+{
+    // One benchmark per line, which read_baseline relies on
+    os << "{\n  \"simd\": \"" << gfx::name(gfx::simd_isa()) << "\",\n  \"benchmarks\": [\n";
+    for (std::size_t i = 0; i < results.size(); ++i)
+    {
+        const Result& r = results[i];
+        os << std::setprecision(6) << std::defaultfloat
+           << "    { \"name\": \"" << r.name << "\""
+           << ", \"median_ns\": " << r.median
+           << ", \"p99_ns\": " << r.p99
+           << ", \"mean_ns\": " << r.mean
+           << ", \"ops_per_s\": " << r.ops_per_second()
+           << ", \"samples\": " << r.samples << " }"
+           << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    os << "  ]\n}\n";
+}
+
+/**
+ * Median times by name, from the output of write_json.
+ */
+std::map<std::string, double> read_baseline(std::istream& is)
+{
+    std::map<std::string, double> medians;
+    std::string line;
+    while (std::getline(is, line))
+    {
+        const auto name = line.find("\"name\": \"");
+        const auto median = line.find("\"median_ns\": ");
+        if (name == std::string::npos || median == std::string::npos) continue;
+
+        const auto begin = name + 9;
+        const auto end = line.find('"', begin);
+        medians[line.substr(begin, end - begin)] = std::strtod(line.c_str() + median + 13, nullptr);
+    }
+    return medians;
+}
+
+/**
+ * @return Number of regressions.
+ */
+int compare(const std::vector<Result>& results, const std::map<std::string, double>& baseline, const double threshold)
+{
+    int regressions = 0;
+    std::cout << "\nAgainst baseline (threshold " << threshold << "%):\n";
+    for (const Result& r : results)
+    {
+        const auto base = baseline.find(r.name);
+        if (base == baseline.end()) continue;
+
+        const double change = (r.median - base->second) / base->second * 100;
+        const bool regression = change > threshold;
+        regressions += regression;
+        std::cout << std::left << std::setw(28) << r.name << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(8) << std::showpos << change << "%" << std::noshowpos
+                  << (regression ? "  REGRESSION" : "") << "\n";
+    }
+    return regressions;
+}
+
+
+std::vector<Vector3> random_points(const std::size_t n, const unsigned seed = 42)
+{
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<Scalar> unit(-1, 1);
+    std::vector<Vector3> points(n);
+    for (Vector3& p : points) p = { unit(random), unit(random), unit(random) };
+    return points;
+}
+
+std::vector<Rotation> random_rotations(const std::size_t n, const unsigned seed = 7)
+{
+    std::vector<Rotation> rotations;
+    for (const Vector3& p : random_points(n, seed)) rotations.push_back(Rotation::from_euler(p * 3));
+    return rotations;
+}
+
+void run_benchmarks(Harness& bench)
+{
+    // Inputs cycle through small arrays, so nothing gets constant-folded.
+    // Binary operations take elements k and k ^ 1
+    constexpr std::size_t n = 1024;
+    const std::vector<Vector3> points = random_points(n);
+    const std::vector<Rotation> rotations = random_rotations(n);
+    std::size_t i = 0;
+    const auto next = [&] { return i++ & (n - 1); };
+
+    bench.run("rotate", 1, [&] {
+        const std::size_t k = next();
+        do_not_optimize(rotations[k].rotate(points[k ^ 1]));
+    });
+    bench.run("naive_rotate", 1, [&] {
+        const std::size_t k = next();
+        do_not_optimize(rotations[k].naive_rotate(points[k ^ 1]));
+    });
+    bench.run("as_matrix3", 1, [&] {
+        const std::size_t k = next();
+        do_not_optimize(rotations[k].as_matrix3());
+    });
+
+    std::vector<Matrix3> matrices;
+    for (const Rotation& r : rotations) matrices.push_back(r.as_matrix3());
+    bench.run("matrix3_mul_matrix3", 1, [&] {
+        const std::size_t k = next();
+        do_not_optimize(matrices[k] * matrices[k ^ 1]);
+    });
+    bench.run("matrix3_mul_vector3", 1, [&] {
+        const std::size_t k = next();
+        do_not_optimize(matrices[k] * points[k ^ 1]);
+    });
+
+    const std::vector<Vector3> angles = random_points(n, 5);
+    bench.run("from_euler", 1, [&] {
+        do_not_optimize(Rotation::from_euler(angles[next()]));
+    });
+    bench.run("to_euler", 1, [&] {
+        do_not_optimize(rotations[next()].to_euler());
+    });
+
+    bench.run("nlerp", 1, [&] {
+        const std::size_t k = next();
+        do_not_optimize(nlerp(rotations[k], rotations[k ^ 1], 0.3f));
+    });
+    bench.run("slerp", 1, [&] {
+        const std::size_t k = next();
+        do_not_optimize(slerp(rotations[k], rotations[k ^ 1], 0.3f));
+    });
+    bench.run("slerp_fast_math", 1, [&] {
+        const std::size_t k = next();
+        do_not_optimize(slerp<gfx::FastMath>(rotations[k], rotations[k ^ 1], 0.3f));
+    });
+    bench.run("fast_slerp", 1, [&] {
+        const std::size_t k = next();
+        do_not_optimize(fast_slerp(rotations[k], rotations[k ^ 1], 0.3f));
+    });
+
+    std::vector<Sphere> spheres;
+    for (const Vector3& p : random_points(n, 3)) spheres.push_back({ p * 10 + Vector3 { 0, 0, 20 }, 1 });
+    bench.run("ray_intersect", 1, [&] {
+        const std::size_t k = next();
+        const Ray ray = { Vector3::zero(), points[k] + Vector3::forwards() };
+        do_not_optimize(ray.intersect(spheres[k ^ 1]));
+    });
+    bench.run("ray_closest_hit", 1, [&] {
+        const std::size_t k = next();
+        const Ray ray = { Vector3::zero(), points[k] + Vector3::forwards() };
+        do_not_optimize(ray.closest_hit(spheres[k ^ 1]));
+    });
+    bench.run("ray_any_hit", 1, [&] {
+        const std::size_t k = next();
+        const Ray ray = { Vector3::zero(), points[k] + Vector3::forwards() };
+        do_not_optimize(ray.any_hit(spheres[k ^ 1]));
+    });
+
+    // Bumpy grid of 2048 triangles in front of the rays, per triangle tested
+    constexpr std::uint32_t side = 33;
+    std::vector<Vector3> grid;
+    for (std::uint32_t i = 0; i < side; ++i)
+    {
+        for (std::uint32_t j = 0; j < side; ++j) grid.push_back({ Scalar(i) - 16, Scalar(j) - 16, 20 + std::sin(Scalar(i + j)) });
+    }
+    std::vector<std::uint32_t> grid_indices;
+    for (std::uint32_t i = 0; i + 1 < side; ++i)
+    {
+        for (std::uint32_t j = 0; j + 1 < side; ++j)
+        {
+            const std::uint32_t k = i * side + j;
+            grid_indices.insert(grid_indices.end(), { k, k + side, k + 1, k + 1, k + side, k + side + 1 });
+        }
+    }
+    const gfx::TriangleMesh mesh(grid, grid_indices);
+    const gfx::TriangleBatch mesh_batch(mesh);
+    std::vector<gfx::Triangle> triangles;
+    for (std::size_t k = 0; k < mesh.size(); ++k) triangles.push_back(mesh.triangle(k));
+    bench.run("mesh_closest_hit_scalar", mesh.size(), [&] {
+        const std::size_t k = next();
+        const Ray ray = { Vector3::zero(), points[k] + Vector3::forwards() };
+        do_not_optimize(ray.closest_hit(triangles));
+    });
+    bench.run("mesh_closest_hit", mesh.size(), [&] {
+        const std::size_t k = next();
+        const Ray ray = { Vector3::zero(), points[k] + Vector3::forwards() };
+        do_not_optimize(mesh.closest_hit(ray));
+    });
+    bench.run("mesh_batch_closest_hit", mesh.size(), [&] {
+        const std::size_t k = next();
+        const Ray ray = { Vector3::zero(), points[k] + Vector3::forwards() };
+        do_not_optimize(mesh_batch.closest_hit(ray));
+    });
+    bench.run("mesh_batch_any_hit", mesh.size(), [&] {
+        const std::size_t k = next();
+        const Ray ray = { Vector3::zero(), points[k] + Vector3::forwards() };
+        do_not_optimize(mesh_batch.any_hit(ray));
+    });
+
+    // Batch versions, per element
+    std::vector<Vector3> out(n);
+    bench.run("batch_rotate", n, [&] {
+        gfx::rotate(rotations[next()], points, out);
+        do_not_optimize(out.front());
+    });
+    bench.run("batch_rotate_each", n, [&] {
+        gfx::rotate(rotations, points, out);
+        do_not_optimize(out.front());
+    });
+
+    const Matrix3 normal_matrix = matrices[0].normal_matrix();
+    bench.run("batch_matrix3_multiply", n, [&] {
+        gfx::multiply(normal_matrix, points, out);
+        do_not_optimize(out.front());
+    });
+
+    std::vector<Rotation> from_matrices(n);
+    bench.run("from_matrix3", 1, [&] {
+        do_not_optimize(Rotation::from_matrix3(matrices[next()]));
+    });
+    bench.run("batch_from_matrix3", n, [&] {
+        gfx::rotations_from_matrices(matrices, from_matrices);
+        do_not_optimize(from_matrices.front());
+    });
+    bench.run("batch_from_drifted_matrix3", n, [&] {
+        gfx::rotations_from_matrices(matrices, from_matrices, gfx::Orthonormalize::yes);
+        do_not_optimize(from_matrices.front());
+    });
+
+    bench.run("batch_from_euler", n, [&] {
+        gfx::rotations_from_euler(angles, from_matrices, gfx::EulerOrder::xyz);
+        do_not_optimize(from_matrices.front());
+    });
+
+    std::vector<std::byte> packed(8 * n);
+    std::vector<Rotation> unpacked(n);
+    bench.run("encode_rotations_48", n, [&] {
+        gfx::encode_rotations(rotations, packed, gfx::RotationEncoding::smallest_three_48);
+        do_not_optimize(packed.front());
+    });
+    bench.run("decode_rotations_48", n, [&] {
+        gfx::decode_rotations(packed, unpacked, gfx::RotationEncoding::smallest_three_48);
+        do_not_optimize(unpacked.front());
+    });
+
+    const gfx::Vector3Batch batch(points);
+    gfx::Vector3Batch normalized(n);
+    bench.run("batch_normalize", n, [&] {
+        gfx::normalize(batch, normalized);
+        do_not_optimize(normalized[0]);
+    });
+
+    std::vector<Transform> transforms;
+    for (std::size_t k = 0; k < n; ++k) transforms.push_back({ points[k], rotations[k], { 1, 2, 3 } });
+    std::vector<float> matrices_4x4(16 * n);
+    bench.run("write_matrices_4x4", n, [&] {
+        gfx::write_matrices(transforms, matrices_4x4);
+        do_not_optimize(matrices_4x4.front());
+    });
+
+    // Skinning n vertices with 4 bones each out of 64, with normals
+    const std::size_t bone_count = 64;
+    std::vector<gfx::DualQuaternion> bone_poses;
+    std::vector<Matrix3> bone_rotations;
+    for (std::size_t b = 0; b < bone_count; ++b)
+    {
+        bone_poses.push_back(gfx::DualQuaternion::from_rotation_translation(rotations[b], points[b]));
+        bone_rotations.push_back(rotations[b].as_matrix3());
+    }
+    std::vector<float> bone_matrices(12 * bone_count);
+    gfx::write_matrices(std::span(transforms).first(bone_count), bone_matrices, gfx::MatrixLayout::column_major_3x4);
+    std::vector<std::uint16_t> skin_bones;
+    std::vector<Scalar> skin_weights;
+    for (std::size_t k = 0; k < 4 * n; ++k)
+    {
+        skin_bones.push_back(std::uint16_t((k * 13 + k / 4) % bone_count));
+        skin_weights.push_back(0.25f);
+    }
+    const gfx::SkinInfluences influences = { skin_bones, skin_weights, 4 };
+    gfx::Vector3Batch skinned(n);
+    gfx::Vector3Batch skinned_normals(n);
+    bench.run("skin_matrix3_scalar", n, [&] {
+        // Blending a Matrix3 and a translation per vertex
+        for (std::size_t v = 0; v < n; ++v)
+        {
+            Matrix3 M = bone_rotations[skin_bones[4 * v]] * skin_weights[4 * v];
+            Vector3 t = points[skin_bones[4 * v]] * skin_weights[4 * v];
+            for (std::size_t k = 1; k < 4; ++k)
+            {
+                M = M + bone_rotations[skin_bones[4 * v + k]] * skin_weights[4 * v + k];
+                t += points[skin_bones[4 * v + k]] * skin_weights[4 * v + k];
+            }
+            skinned.set(v, M * batch[v] + t);
+            skinned_normals.set(v, (M * normalized[v]).normalized());
+        }
+        do_not_optimize(skinned[0]);
+    });
+    bench.run("batch_skin_linear", n, [&] {
+        gfx::skin_linear(influences, bone_matrices, batch, normalized, skinned, skinned_normals);
+        do_not_optimize(skinned[0]);
+    });
+    bench.run("batch_skin_dual_quaternion", n, [&] {
+        gfx::skin_dual_quaternion(influences, bone_poses, batch, normalized, skinned, skinned_normals);
+        do_not_optimize(skinned[0]);
+    });
+    bench.run("batch_skin_dual_quaternion_pool", n, [&] {
+        gfx::skin_dual_quaternion(influences, bone_poses, batch, normalized, skinned, skinned_normals, gfx::ThreadPool::shared());
+        do_not_optimize(skinned[0]);
+    });
+
+    std::vector<gfx::AnimationTrack> tracks(n);
+    for (std::size_t k = 0; k < n; ++k)
+    {
+        for (int key = 0; key < 16; ++key) tracks[k].add(key * 0.1f, transforms[(k + key) & (n - 1)]);
+    }
+    gfx::AnimationSampler sampler(tracks);
+    Scalar time = 0;
+    bench.run("animation_slerp", n, [&] {
+        time = time > 1.5f ? 0 : time + 0.01f;
+        sampler.sample(time, transforms, gfx::Interpolation::slerp);
+        do_not_optimize(transforms.front());
+    });
+
+    // Same keys on smooth curves, one spline at a time or all of them
+    std::vector<gfx::RotationSpline> squads;
+    std::vector<gfx::RotationSpline> b_splines;
+    for (const gfx::AnimationTrack& track : tracks)
+    {
+        std::vector<Rotation> keys;
+        for (const Transform& key : track.keys()) keys.push_back(key.rotation);
+        const auto times = track.times();
+        squads.emplace_back(std::vector<Scalar>(times.begin(), times.end()), keys);
+        b_splines.emplace_back(std::vector<Scalar>(times.begin(), times.end()), keys, gfx::RotationSplineType::b_spline);
+    }
+    std::vector<Rotation> spline_rotations(n);
+    bench.run("spline_squad_scalar", n, [&] {
+        time = time > 1.5f ? 0 : time + 0.01f;
+        for (std::size_t k = 0; k < n; ++k) spline_rotations[k] = squads[k].sample(time);
+        do_not_optimize(spline_rotations.front());
+    });
+    gfx::RotationSplineSampler squad_sampler(squads);
+    bench.run("spline_squad", n, [&] {
+        time = time > 1.5f ? 0 : time + 0.01f;
+        squad_sampler.sample(time, spline_rotations);
+        do_not_optimize(spline_rotations.front());
+    });
+    gfx::RotationSplineSampler b_spline_sampler(b_splines);
+    bench.run("spline_b_spline", n, [&] {
+        time = time > 1.5f ? 0 : time + 0.01f;
+        b_spline_sampler.sample(time, spline_rotations);
+        do_not_optimize(spline_rotations.front());
+    });
+
+    // Long kinematic chain, e.g. a rope
+    const std::vector<Rotation> segments = random_rotations(1 << 17, 11);
+    std::vector<Rotation> chain(segments.size());
+    bench.run("chain_then", segments.size(), [&] {
+        chain[0] = segments[0];
+        for (std::size_t k = 1; k < segments.size(); ++k) chain[k] = segments[k].then(chain[k - 1]);
+        do_not_optimize(chain.back());
+    });
+    bench.run("batch_cumulative_rotations", segments.size(), [&] {
+        gfx::cumulative_rotations(segments, chain);
+        do_not_optimize(chain.back());
+    });
+    bench.run("batch_cumulative_rotations_pool", segments.size(), [&] {
+        gfx::cumulative_rotations(segments, chain, gfx::ThreadPool::shared());
+        do_not_optimize(chain.back());
+    });
+
+    // Orientation of one body over many steps: normalized every step, or lazily
+    bench.run("chain_then_normalized", segments.size(), [&] {
+        Quaternion q = segments[0].as_quaternion();
+        for (std::size_t k = 1; k < segments.size(); ++k) q = (segments[k].as_quaternion() * q).normalized();
+        do_not_optimize(q);
+    });
+    bench.run("chain_accumulator", segments.size(), [&] {
+        gfx::RotationAccumulator accumulator(segments[0]);
+        for (std::size_t k = 1; k < segments.size(); ++k) accumulator.then(segments[k]);
+        do_not_optimize(accumulator.as_quaternion());
+    });
+
+    // A simulation step of many bodies, turning at their angular velocities
+    std::vector<Rotation> orientations = segments;
+    std::vector<Vector3> angular_velocities(orientations.size());
+    for (std::size_t k = 0; k < angular_velocities.size(); ++k) angular_velocities[k] = points[k % points.size()] * 3;
+    bench.run("integrate_normalized_scalar", orientations.size(), [&] {
+        for (std::size_t k = 0; k < orientations.size(); ++k)
+        {
+            const Quaternion q = orientations[k].as_quaternion();
+            orientations[k] = Rotation::from_quaternion(q + Quaternion { angular_velocities[k] * (1.0f / 120), 0 } * q);
+        }
+        do_not_optimize(orientations.back());
+    });
+    bench.run("batch_integrate_angular_velocities", orientations.size(), [&] {
+        gfx::integrate_angular_velocities(orientations, angular_velocities, 1.0f / 60);
+        do_not_optimize(orientations.back());
+    });
+
+    std::vector<Sphere> field;
+    for (const Vector3& p : random_points(100000, 5)) field.push_back({ p * 100, 0.5f });
+    const gfx::Bvh bvh(field);
+    bench.run("bvh_closest_hit", 1, [&] {
+        const std::size_t k = next();
+        const Ray ray = { Vector3::zero(), points[k] };
+        do_not_optimize(bvh.closest_hit(ray));
+    });
+    bench.run("bvh_any_hit", 1, [&] {
+        const std::size_t k = next();
+        const Ray ray = { Vector3::zero(), points[k] };
+        do_not_optimize(bvh.any_hit(ray));
+    });
+
+    // Rebuilding part of the field every frame, with the temporary memory from the heap or from an arena
+    const std::span<const Sphere> moving = std::span(field).first(4096);
+    gfx::Bvh rebuilt;
+    bench.run("bvh_build", moving.size(), [&] {
+        rebuilt.build(moving);
+        do_not_optimize(rebuilt.bounds());
+    });
+    gfx::LinearArena frame_memory;
+    bench.run("bvh_build_arena", moving.size(), [&] {
+        frame_memory.reset();
+        rebuilt.build(moving, {}, &frame_memory);
+        do_not_optimize(rebuilt.bounds());
+    });
+
+    // Culling the field for a camera in its middle, and for 4 shadow cascades at once
+    gfx::Vector3Batch field_centers(field.size());
+    std::vector<Scalar> field_radii;
+    for (std::size_t k = 0; k < field.size(); ++k)
+    {
+        field_centers.set(k, field[k].center);
+        field_radii.push_back(field[k].radius);
+    }
+    const gfx::Frustum view = gfx::Frustum::perspective(Vector3::zero(), Rotation(), gfx::radians(60), 16.0f / 9, 0.1f, 200);
+    gfx::Frustum cascades[4];
+    for (std::size_t c = 0; c < 4; ++c)
+    {
+        const Rotation light = Rotation::from_euler_degrees({ 50, 30, 0 });
+        cascades[c] = gfx::Frustum::perspective(light.rotate(Vector3::backwards()) * 300, light, gfx::radians(10 + 10 * c), 1, 1, 600);
+    }
+    std::vector<std::uint32_t> visible(field.size());
+    bench.run("frustum_intersects", field.size(), [&] {
+        std::size_t count = 0;
+        for (const Sphere& s : field) count += view.intersects(s);
+        do_not_optimize(count);
+    });
+    bench.run("batch_cull_spheres", field.size(), [&] {
+        do_not_optimize(gfx::cull_spheres(field_centers, field_radii, view, visible));
+    });
+    bench.run("batch_cull_spheres_4_frusta", field.size(), [&] {
+        gfx::cull_spheres(field_centers, field_radii, cascades, visible);
+        do_not_optimize(visible.back());
+    });
+
+    // Particles about as dense as a liquid, jittering in place
+    std::vector<Sphere> particles;
+    for (const Vector3& p : random_points(1 << 18, 13)) particles.push_back({ p * 40, 0.5f });
+    const std::vector<Vector3> jitter = random_points(particles.size(), 17);
+    gfx::SpatialHash hash;
+    bench.run("spatial_hash_build", particles.size(), [&] {
+        hash.build(particles);
+        do_not_optimize(hash.size());
+    });
+    std::size_t frame = 0;
+    bench.run("spatial_hash_update", particles.size(), [&] {
+        const Scalar step = (frame++ & 1) ? 0.05f : -0.05f;
+        for (std::size_t k = 0; k < particles.size(); ++k) particles[k].center += jitter[k] * step;
+        hash.update(particles);
+        do_not_optimize(hash.size());
+    });
+    std::pmr::vector<gfx::SpatialHash::Pair> pairs;
+    bench.run("spatial_hash_pairs", particles.size(), [&] {
+        hash.overlapping_pairs(pairs);
+        do_not_optimize(pairs.size());
+    });
+    bench.run("spatial_hash_pairs_pool", particles.size(), [&] {
+        hash.overlapping_pairs(pairs, gfx::ThreadPool::shared());
+        do_not_optimize(pairs.size());
+    });
+
+    // Loading a scene: mapping and looking up an array, then checking its contents
+    const std::string archive_path = (std::filesystem::temp_directory_path() / "gfx_bench_archive.bin").string();
+    {
+        gfx::ArchiveWriter writer(archive_path);
+        writer.write("spheres", field);
+    }
+    bench.run("archive_open", 1, [&] {
+        const gfx::MappedArchive archive(archive_path);
+        do_not_optimize(archive.get<Sphere>("spheres").size());
+    });
+    const gfx::MappedArchive archive(archive_path);
+    bench.run("archive_verify", field.size(), [&] {
+        do_not_optimize(archive.verify());
+    });
+    std::filesystem::remove(archive_path);
+}
+
+int main(int argc, char** argv)
+{
+    std::string filter;
+    std::string json;
+    std::string baseline;
+    double threshold = 10;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (std::strcmp(argv[i], "--filter") == 0) filter = argv[i + 1];
+        else if (std::strcmp(argv[i], "--json") == 0) json = argv[i + 1];
+        else if (std::strcmp(argv[i], "--baseline") == 0) baseline = argv[i + 1];
+        else if (std::strcmp(argv[i], "--threshold") == 0) threshold = std::strtod(argv[i + 1], nullptr);
+        else
+        {
+            std::cerr << "Unknown option " << argv[i] << "\n";
+            return 2;
+        }
+    }
+
+    std::cout << "SIMD: " << gfx::name(gfx::simd_isa()) << "\n";
+    Harness bench(filter);
+    run_benchmarks(bench);
+
+    if (!json.empty())
+    {
+        std::ofstream file(json);
+        write_json(file, bench.results());
+        if (!file)
+        {
+            std::cerr << "Could not write " << json << "\n";
+            return 2;
+        }
+        std::cout << "Written " << json << "\n";
+    }
+
+    if (!baseline.empty())
+    {
+        std::ifstream file(baseline);
+        if (!file)
+        {
+            std::cerr << "Could not read " << baseline << "\n";
+            return 2;
+        }
+        if (compare(bench.results(), read_baseline(file), threshold) > 0) return 1;
+    }
+
+    return 0;
+}
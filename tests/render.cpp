@@ -0,0 +1,139 @@
+// Graphical test and throughput benchmark: renders a procedural field of spheres.
+//
+// Usage: gfx_render [width] [height] [spheres] [threads] [output.ppm|output.pfm]
+//        gfx_render --scaling [width] [height] [spheres]
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Camera.h"
+#include "Renderer.h"
+#include "Rotation.h"
+#include "Sphere.h"
+#include "ThreadPool.h"
+#include "Vector3.h"
+
+using gfx::Camera;
+using gfx::Image;
+using gfx::RenderOptions;
+using gfx::Rotation;
+using gfx::Scalar;
+using gfx::Scene;
+using gfx::Sphere;
+using gfx::ThreadPool;
+using gfx::Vector3;
+
+std::vector<Sphere> sphere_field(const std::size_t count)
+{
+    std::mt19937 random(42);
+    std::uniform_real_distribution<Scalar> unit(0, 1);
+
+    // A huge sphere as the floor, then a jittered grid of small ones on top of it
+    std::vector<Sphere> spheres = { { { 0, -10000, 0 }, 10000 } };
+    const auto side = std::size_t(std::ceil(std::sqrt(double(count))));
+    for (std::size_t i = 0; i + 1 < count; ++i)
+    {
+        const Scalar r = 0.2f + 0.3f * unit(random);
+        const Scalar x = (Scalar(i % side) - side / 2.0f + unit(random)) * 1.2f;
+        const Scalar z = (Scalar(i / side) + unit(random)) * 1.2f;
+        spheres.push_back({ { x, r + 2 * unit(random) * unit(random), z }, r });
+    }
+    return spheres;
+}
+
+Camera camera()
+{
+    return {
+        .position = { 0, 6, -12 },
+        .rotation = Rotation::from_euler_degrees({ 20, 0, 0 }),
+        .fov = gfx::radians(55),
+    };
+}
+
+// Render and return primary rays per second
+double benchmark(const Scene& scene, const RenderOptions& options, ThreadPool& pool, Image* image = nullptr)
+{
+    // Warm up caches and threads
+    gfx::render(camera(), scene, options, pool);
+
+    const int frames = 3;
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; ++i)
+    {
+        Image frame = gfx::render(camera(), scene, options, pool);
+        if (image) *image = std::move(frame);
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    return double(frames) * options.width * options.height / elapsed.count();
+}
+
+int main(int argc, char** argv)
+{
+    const bool scaling = argc > 1 && std::strcmp(argv[1], "--scaling") == 0;
+    if (scaling)
+    {
+        --argc;
+        ++argv;
+    }
+
+    const auto arg = [&](const int i, const unsigned fallback) {
+        return argc > i ? unsigned(std::strtoul(argv[i], nullptr, 10)) : fallback;
+    };
+
+    RenderOptions options;
+    options.width = arg(1, 640);
+    options.height = arg(2, 480);
+    const unsigned count = arg(3, 100000);
+    const unsigned threads = arg(4, 0);
+    const std::string output = argc > 5 ? argv[5] : "render.ppm";
+
+    const auto build_start = std::chrono::steady_clock::now();
+    const Scene scene(sphere_field(count));
+    const std::chrono::duration<double> build = std::chrono::steady_clock::now() - build_start;
+
+    std::cout << options.width << "x" << options.height << ", "
+              << scene.spheres.size() << " spheres (BVH built in " << build.count() * 1000 << " ms)\n";
+
+    if (scaling)
+    {
+        // Powers of two, then all the cores
+        const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+        std::vector<unsigned> counts;
+        for (unsigned n = 1; n < cores; n *= 2) counts.push_back(n);
+        counts.push_back(cores);
+
+        double single = 0;
+        for (const unsigned n : counts)
+        {
+            ThreadPool pool(n);
+            const double rays = benchmark(scene, options, pool);
+            if (n == 1) single = rays;
+            std::cout << n << " threads: " << rays / 1e6 << " Mrays/s, "
+                      << rays / single << "x speedup\n";
+        }
+        return 0;
+    }
+
+    ThreadPool pool(threads);
+    Image image;
+    const double rays = benchmark(scene, options, pool, &image);
+    std::cout << pool.size() << " threads: " << rays / 1e6 << " Mrays/s\n";
+
+    const bool pfm = output.size() > 4 && output.substr(output.size() - 4) == ".pfm";
+    if (!(pfm ? image.write_pfm(output) : image.write_ppm(output)))
+    {
+        std::cerr << "Could not write " << output << "\n";
+        return 1;
+    }
+    std::cout << "Written " << output << "\n";
+
+    return 0;
+}
@@ -1,21 +1,114 @@
 #include <iostream>
 #include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory_resource>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
 
+#include "Animation.h"
+#include "Archive.h"
+#include "Bvh.h"
+#include "Half.h"
+#include "Hit.h"
+#include "Camera.h"
+#include "DualQuaternion.h"
+#include "EulerOrder.h"
+#include "Frustum.h"
 #include "Matrix3.h"
+#include "Matrix3Batch.h"
+#include "Matrix4.h"
+#include "Memory.h"
 #include "Quaternion.h"
+#include "Renderer.h"
 #include "Ray.h"
+#include "RayPacket.h"
 #include "Rotation.h"
+#include "RotationAccumulator.h"
+#include "RotationBatch.h"
+#include "RotationEncoding.h"
+#include "RotationSpline.h"
 #include "Scalar.h"
+#include "Simd.h"
+#include "Skinning.h"
+#include "SpatialHash.h"
 #include "Sphere.h"
+#include "ThreadPool.h"
+#include "Transform.h"
+#include "TransformBatch.h"
+#include "TransformHierarchy.h"
+#include "Triangle.h"
+#include "TriangleMesh.h"
 #include "Vector3.h"
+#include "Vector3Batch.h"
 
+using gfx::AnimationTrack;
+using gfx::Bvh;
+using gfx::DualQuaternion;
+using gfx::EulerOrder;
+using gfx::Frustum;
+using gfx::Hit;
+using gfx::Interpolation;
 using gfx::Matrix3;
+using gfx::Matrix4;
+using gfx::Plane;
 using gfx::Quaternion;
 using gfx::Ray;
+using gfx::RayPacket;
 using gfx::Rotation;
+using gfx::RotationSpline;
+using gfx::RotationSplineType;
 using gfx::Scalar;
+using gfx::SimdIsa;
 using gfx::Sphere;
+using gfx::ThreadPool;
+using gfx::Transform;
+using gfx::TransformHierarchy;
+using gfx::Triangle;
+using gfx::TriangleBatch;
+using gfx::TriangleMesh;
 using gfx::Vector3;
+using gfx::Vector3Batch;
+
+// Every allocation of the program, for test_memory
+std::atomic<std::size_t> allocation_count = 0;
+
+void* operator new(const std::size_t size)
+{
+    ++allocation_count;
+    if (void* const p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(const std::size_t size, const std::align_val_t alignment)
+{
+    ++allocation_count;
+    const std::size_t a = std::size_t(alignment);
+#ifdef _WIN32
+    if (void* const p = _aligned_malloc(size ? size : 1, a)) return p;
+#else
+    if (void* const p = std::aligned_alloc(a, (size + a) / a * a)) return p;
+#endif
+    throw std::bad_alloc();
+}
+
+void operator delete(void* const p) noexcept { std::free(p); }
+void operator delete(void* const p, std::size_t) noexcept { std::free(p); }
+
+#ifdef _WIN32
+void operator delete(void* const p, std::align_val_t) noexcept { _aligned_free(p); }
+void operator delete(void* const p, std::size_t, std::align_val_t) noexcept { _aligned_free(p); }
+#else
+void operator delete(void* const p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* const p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+#endif
 
 void test_vector3_operators()
 {
@@ -140,16 +233,1701 @@ void test_rot_matrix()
     // Test composition with another rotation
     const Rotation r2 = Rotation::from_axis_angle_degrees({ 0.5, -1, 0.25 }, 35);
     assert(r.then(r2).rotate(p) == r2.as_matrix3() * r.as_matrix3() * p);
+
+    // Back from the matrix, through each of the 4 cases (largest w, x, y, z)
+    for (const Rotation& q : {
+        r,
+        Rotation::from_axis_angle_degrees({ 1, 0.1f, -0.2f }, 170),
+        Rotation::from_axis_angle_degrees({ 0.1f, -1, 0.2f }, 180),
+        Rotation::from_axis_angle_degrees({ 0, 0, 1 }, 179.9f),
+        Rotation(),
+    })
+    {
+        assert(gfx::are_equivalent(Rotation::from_matrix3(q.as_matrix3()), q));
+    }
+    static_assert(Rotation::from_matrix3(Matrix3::from_diagonal({ 1, -1, -1 })).as_quaternion() == Quaternion::i());
+
+    // Drifted by many incremental updates
+    Matrix3 M = r.as_matrix3();
+    const Matrix3 step = r2.as_matrix3();
+    for (int i = 0; i < 1000; ++i) M = step * M;
+    M = M + Matrix3 { { 0.01f, 0, -0.02f }, { 0, 0.02f, 0.01f }, { 0.01f, 0, 0 } };
+    const Matrix3 O = M.orthonormalized();
+    assert(O * O.transposed() == Matrix3::identity());
+    assert(gfx::are_equal(O.determinant(), 1.0f));
+    assert(gfx::are_equal(O, M, 0.05f));
+    assert(O.orthonormalized() == O);
+}
+
+void test_matrix3()
+{
+    const Matrix3 M = { { 2, -1, 0.5 }, { 1, 3, -2 }, { 0.25, 4, 1 } };
+    const Vector3 p = { 5, 3, 12 };
+
+    assert(M.element(2, 3) == -2);
+    assert(M(1, 2) == -2);
+    assert(std::isnan(M.element(0, 1)) && std::isnan(M.element(1, 4)));
+    assert(M.col(2) == Vector3(-1, 3, 4));
+    assert(Matrix3::from_columns(M.col(1), M.col(2), M.col(3)) == M);
+
+    assert(M * Matrix3::identity() == M);
+    assert(M * p == Vector3(M.row(1).dot(p), M.row(2).dot(p), M.row(3).dot(p)));
+    assert((M * M) * p == M * (M * p));
+
+    assert(M.transposed().row(2) == M.col(2));
+    assert(M.transposed().transposed() == M);
+    assert(gfx::are_equal(M.determinant(), M.transposed().determinant()));
+    assert(gfx::are_equal(M.determinant(), 2 * 11 + 1 * 1.5f + 0.5f * 3.25f));
+    assert(gfx::are_equal((M * M).determinant(), M.determinant() * M.determinant(), 1e-3f));
+    assert(M * M.inverse() == Matrix3::identity());
+    assert(M.inverse() * M == Matrix3::identity());
+
+    const Matrix3 R = Rotation::from_euler_degrees({ 32, 124, -54 }).as_matrix3();
+    assert(gfx::are_equal(R.determinant(), Scalar(1)));
+    assert(R.inverse() == R.transposed());
+    assert(R.normal_matrix() == R);
+
+    // Normals stay perpendicular to tangents under non-uniform scaling
+    const Matrix3 S = R * Matrix3::from_diagonal({ 2, 0.5, 3 });
+    const Vector3 tangent = { 1, 2, 0 };
+    const Vector3 normal = { -2, 1, 5 };
+    assert(gfx::is_zero((S * tangent).dot(S.normal_matrix() * normal)));
+
+    const auto columns = M.column_major();
+    const auto padded = M.column_major_padded();
+    for (unsigned c = 0; c < 3; ++c)
+    {
+        for (unsigned r = 0; r < 3; ++r)
+        {
+            assert(M.row_major()[3 * r + c] == M(r, c));
+            assert(columns[3 * c + r] == M(r, c));
+            assert(padded[4 * c + r] == M(r, c));
+        }
+        assert(padded[4 * c + 3] == 0);
+    }
+}
+
+void test_precision()
+{
+    using gfx::Half;
+    using gfx::Matrix3d;
+    using gfx::Rotationd;
+    using gfx::Vector3d;
+    using gfx::Vector3h;
+
+    static_assert(sizeof(Vector3d) == 3 * sizeof(double));
+    static_assert(sizeof(Vector3h) == 3 * sizeof(std::uint16_t));
+    static_assert(gfx::epsilon<double> < gfx::EPSILON);
+    static_assert(Half(0.5f).bits == 0x3800 && float(Half::from_bits(0x3800)) == 0.5f);
+
+    // Large-world coordinates: float cannot tell these apart, double can
+    const Vector3d far = { 1e7, -2e7, 3e7 };
+    const Vector3d nudged = far + Vector3d { 0.01, 0, 0 };
+    assert(far.cast<Scalar>() == nudged.cast<Scalar>());
+    assert(far != nudged);
+    assert(gfx::are_equal(distance(far, nudged), 0.01, 1e-6));
+
+    // Same operations in both precisions
+    const Rotation r = Rotation::from_euler_degrees({ 32, 124, -54 });
+    const Rotationd rd = Rotationd::from_euler_degrees({ 32, 124, -54 });
+    const Vector3 p = { 5, 3, 12 };
+    assert(gfx::are_equivalent(rd.cast<Scalar>(), r));
+    assert(rd.rotate(p.cast<double>()).cast<Scalar>() == r.rotate(p));
+    assert(gfx::are_equivalent(slerp(rd, Rotationd(), 0.3), slerp(r, Rotation(), 0.3f).cast<double>(), 1e-5));
+
+    const Matrix3d M = rd.as_matrix3() * Matrix3d::from_diagonal({ 2, 0.5, 3 });
+    assert(M * M.inverse() == Matrix3d::identity());
+    assert(M.cast<Scalar>() * p == (M * p.cast<double>()).cast<Scalar>());
+
+    const Sphere s = { { 0, 0, 10 }, 2 };
+    const gfx::Rayd ray = { Vector3d::zero(), Vector3d::forwards() };
+    assert(ray.intersect(s.cast<double>()) == Vector3d(0, 0, 8));
+    assert(ray.cast<Scalar>().intersect(s) == Vector3(0, 0, 8));
+
+    // Half storage: exact on small integers and dyadic fractions, rounds to nearest even otherwise
+    const Vector3h h = Vector3 { 1, -0.375f, 1024 }.cast<Half>();
+    assert(h.cast<Scalar>() == Vector3(1, -0.375f, 1024));
+    assert(Half(1).bits == 0x3c00 && Half(-2).bits == 0xc000);
+    assert(float(Half(1 + 0x1p-11f)) == 1);
+    assert(float(Half(1 + 0x1p-11f + 0x1p-10f)) == 1 + 0x1p-9f);
+    assert(float(Half(65504)) == 65504);
+    assert(float(Half(70000)) == INFINITY && float(Half(-INFINITY)) == -INFINITY);
+    assert(std::isnan(float(Half(NAN))));
+    // Subnormals
+    assert(float(Half(0x1p-24f)) == 0x1p-24f);
+    assert(float(Half(3 * 0x1p-20f)) == 3 * 0x1p-20f);
+    assert(float(Half(0x1p-26f)) == 0);
+    for (std::uint32_t bits = 0; bits < 0x7c00; ++bits)
+    {
+        const Half half = Half::from_bits(std::uint16_t(bits));
+        assert(Half(float(half)).bits == bits);
+    }
+}
+
+// Deterministic, non-trivial test points
+std::vector<Vector3> test_points(const std::size_t n)
+{
+    std::vector<Vector3> points;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        const Scalar t = i;
+        points.push_back({ std::sin(t) * 3 + 0.5f, std::cos(t * 1.3f) * 2 - 0.25f, t / n - 0.5f });
+    }
+    return points;
+}
+
+// Run test once per instruction set supported by the CPU
+template <typename Test>
+void for_each_simd_isa(Test test)
+{
+    const SimdIsa initial = gfx::simd_isa();
+    for (const SimdIsa isa : { SimdIsa::scalar, SimdIsa::sse, SimdIsa::avx2, SimdIsa::avx512 })
+    {
+        if (gfx::set_simd_isa(isa)) test();
+    }
+    gfx::set_simd_isa(initial);
+}
+
+void test_transform()
+{
+    const Transform t = {
+        .translation = { 1, -2, 3 },
+        .rotation = Rotation::from_euler_degrees({ 32, 124, -54 }),
+        .scale = { 2, 0.5, 3 },
+    };
+    const Vector3 p = { 0.5, 4, -1 };
+    const Vector3 d = { -2, 1, 0.25 };
+
+    const Matrix4 M = t.as_matrix4();
+    assert(M.transform_point(p) == t.transform_point(p));
+    assert(M.transform_direction(d) == t.transform_direction(d));
+    assert(M.translation() == t.translation);
+    assert(std::isnan(M.element(0, 1)) && std::isnan(M.element(1, 5)));
+    assert(gfx::are_equal(M.determinant(), 2 * 0.5f * 3));
+
+    // Same product as applying the factors one after the other
+    const Matrix4 S = Matrix4::from_scaling(t.scale);
+    const Matrix4 R = Matrix4::from_affine(t.rotation.as_matrix3(), Vector3::zero());
+    assert(M == Matrix4::from_translation(t.translation) * R * S);
+
+    assert(M * M.inverse() == Matrix4::identity());
+    assert(M.inverse().transform_point(M.transform_point(p)) == p);
+    assert(M.transposed().transposed() == M);
+
+    const auto columns = M.column_major();
+    assert(columns[12] == 1 && columns[13] == -2 && columns[14] == 3 && columns[15] == 1);
+    assert(M.row_major()[3] == 1);
+
+    // Perspective-like matrix: points get divided by w
+    const Matrix4 P = Matrix4::identity().set(4, 3, 1).set(4, 4, 0);
+    assert(P.transform_point({ 2, 4, 2 }) == Vector3(1, 2, 1));
+
+    // Composition and inverse are exact with a uniform scale
+    const Transform parent = {
+        .translation = { -4, 0, 2 },
+        .rotation = Rotation::from_axis_angle_degrees({ 1, 1, 0 }, 70),
+        .scale = { 1.5, 1.5, 1.5 },
+    };
+    const Transform world = t.then(parent);
+    assert(world.transform_point(p) == parent.transform_point(t.transform_point(p)));
+    assert(world.as_matrix4() == parent.as_matrix4() * M);
+
+    const Transform inverse = parent.inverse();
+    assert(inverse.transform_point(parent.transform_point(p)) == p);
+    assert(gfx::are_equivalent(parent.then(inverse), Transform {}));
+    assert(inverse.as_matrix4() == parent.as_matrix4().inverse());
+}
+
+void test_slerp()
+{
+    const Rotation a = Rotation::from_euler_degrees({ 10, 20, 30 });
+    const Rotation b = Rotation::from_euler_degrees({ -60, 150, 5 });
+
+    assert(gfx::are_equivalent(slerp(a, b, 0), a));
+    assert(gfx::are_equivalent(slerp(a, b, 1), b));
+    // Same key twice, and the same rotation through the other quaternion
+    assert(gfx::are_equivalent(slerp(a, a, 0.3f), a));
+    const Rotation minus_b = Rotation::from_quaternion(-b.as_quaternion());
+    assert(gfx::are_equivalent(slerp(a, minus_b, 0.3f), slerp(a, b, 0.3f)));
+
+    for (int i = 0; i <= 16; ++i)
+    {
+        const Scalar α = i / 16.0f;
+        const Quaternion s = slerp(a, b, α).as_quaternion();
+        const Quaternion f = fast_slerp(a, b, α).as_quaternion();
+        const Scalar angle = 4 * std::asin(std::min((s - f).norm(), (s + f).norm()) / 2);
+        assert(angle <= gfx::FAST_SLERP_ERROR);
+    }
+}
+
+void test_fast_math()
+{
+    using gfx::FastMath;
+    using gfx::PreciseMath;
+
+    // Constant-evaluated, with any compiler
+    static_assert(FastMath::rsqrt(4.0f) > 0.4999f && FastMath::rsqrt(4.0f) < 0.5001f);
+    static_assert(FastMath::sqrt(0.0) == 0);
+    static_assert(FastMath::cos(0.0f) == 1 && FastMath::sin(0.0f) == 0);
+    static_assert(FastMath::acos(1.0f) < 1e-3f);
+
+    for (int i = -4096; i <= 4096; ++i)
+    {
+        const double x = i * 1.999;
+        const double c = i / 4096.0;
+        assert(std::abs(FastMath::sin(float(x)) - std::sin(float(x))) <= FastMath::SIN_COS_ERROR);
+        assert(std::abs(FastMath::cos(x) - std::cos(x)) <= FastMath::SIN_COS_ERROR);
+        assert(std::abs(FastMath::acos(float(c)) - std::acos(float(c))) <= FastMath::ACOS_ERROR);
+        assert(std::abs(FastMath::acos(c) - std::acos(c)) <= FastMath::ACOS_ERROR);
+    }
+    for (float x = 1e-30f; x < 1e30f; x *= 1.37f)
+    {
+        assert(std::abs(FastMath::rsqrt(x) * std::sqrt(x) - 1) <= FastMath::RSQRT_ERROR);
+        assert(std::abs(FastMath::sqrt(x) / std::sqrt(x) - 1) <= FastMath::RSQRT_ERROR);
+    }
+
+    // Same results through the types, up to the errors above
+    const Vector3 v = { 3, -4, 12 };
+    assert(std::abs(v.normalized<FastMath>().norm() - 1) <= FastMath::RSQRT_ERROR + gfx::EPSILON);
+    assert(gfx::are_equal(v.norm<FastMath>(), 13.0f, 1e-4f));
+    assert(v.normalized<PreciseMath>() == v.normalized());
+
+    const Rotation a = Rotation::from_euler_degrees<FastMath>({ 10, 20, 30 });
+    const Rotation b = Rotation::from_euler_degrees({ -60, 150, 5 });
+    assert(gfx::are_equivalent(a, Rotation::from_euler_degrees({ 10, 20, 30 })));
+    for (int i = 0; i <= 16; ++i)
+    {
+        const Scalar α = i / 16.0f;
+        assert(gfx::are_equivalent(slerp<FastMath>(a, b, α), slerp(a, b, α)));
+        assert(gfx::are_equivalent(nlerp<FastMath>(a, b, α), nlerp(a, b, α)));
+    }
+}
+
+void test_animation()
+{
+    // Tracks of various lengths, with uneven key times
+    std::vector<AnimationTrack> tracks(37);
+    const std::vector<Vector3> points = test_points(200);
+    for (std::size_t i = 0; i < tracks.size(); ++i)
+    {
+        Scalar time = 0;
+        for (std::size_t k = 0; k < i % 6; ++k)
+        {
+            const Vector3& p = points[(i * 5 + k) % points.size()];
+            tracks[i].add(time, {
+                .translation = p,
+                .rotation = Rotation::from_euler(p * 2),
+                .scale = { 1 + 0.1f * k, 1, 2 },
+            });
+            time += 0.25f + 0.1f * Scalar((i + k) % 3);
+        }
+    }
+    assert(tracks[0].empty() && tracks[1].size() == 1);
+    assert(tracks[5].segment(-1) == 0 && tracks[5].segment(0.5f) == 1 && tracks[5].segment(100) == 4);
+
+    // Forwards in small steps, then jumps backwards and far forwards
+    std::vector<Scalar> times;
+    for (int i = 0; i < 30; ++i) times.push_back(i * 0.05f - 0.1f);
+    for (const Scalar t : { 0.4f, 0.1f, 1.9f, 0.0f, 5.0f }) times.push_back(t);
+
+    for_each_simd_isa([&] {
+        for (const auto interpolation : { Interpolation::nlerp, Interpolation::slerp, Interpolation::fast_slerp })
+        {
+            gfx::AnimationSampler sampler(tracks);
+            std::vector<Transform> out(tracks.size());
+            for (const Scalar t : times)
+            {
+                sampler.sample(t, out, interpolation);
+                for (std::size_t i = 0; i < tracks.size(); ++i)
+                {
+                    assert(gfx::are_equivalent(out[i], tracks[i].sample(t, interpolation), 1e-4f));
+                }
+            }
+        }
+    });
+}
+
+void test_rotation_spline()
+{
+    const Rotation r = Rotation::from_axis_angle({ 1, -2, 0.5f }, 1.2f);
+    assert(gfx::are_equal(r.log().norm(), 0.6f));
+    assert(gfx::are_equivalent(Rotation::from_log(r.log()), r));
+    assert(gfx::are_equivalent(Rotation::from_log(Vector3::zero()), Rotation()));
+
+    // Uneven key times
+    const std::vector<Vector3> points = test_points(60);
+    const auto keys = [&](const std::size_t offset, const std::size_t n) {
+        std::vector<Scalar> times;
+        std::vector<Rotation> rotations;
+        Scalar time = 0;
+        for (std::size_t k = 0; k < n; ++k)
+        {
+            times.push_back(time);
+            rotations.push_back(Rotation::from_euler(points[offset + k] * 0.4f));
+            time += 0.25f + 0.15f * Scalar((offset + k) % 3);
+        }
+        return std::pair { times, rotations };
+    };
+    // Angular velocity in the frame of the rotation, from steps after it (or before it if δ < 0),
+    // extrapolated from δ and 2 δ to cancel the first order error
+    const auto velocity = [](const RotationSpline& spline, const Scalar t, const Scalar δ) {
+        const Rotation a = spline.sample(t);
+        const auto step = [&](const Scalar h) {
+            const Rotation b = spline.sample(t + h);
+            return (h > 0 ? b.then(a.inverse()) : a.then(b.inverse())).log() * (2 / std::abs(h));
+        };
+        return step(δ) * 2 - step(2 * δ);
+    };
+    const auto [times, rotations] = keys(0, 7);
+    const RotationSpline squad(times, rotations);
+    const RotationSpline b_spline(times, rotations, RotationSplineType::b_spline);
+    assert(squad.size() == 7 && gfx::are_equal(squad.duration(), times.back()));
+    for (std::size_t k = 0; k < times.size(); ++k)
+    {
+        assert(gfx::are_equivalent(squad.sample(times[k]), rotations[k], 1e-5f));
+        if (k == 0 || k + 1 == times.size()) continue;
+
+        // Same angular velocity on both sides of the key, unlike slerp
+        const Vector3 before = velocity(squad, times[k], -1e-3f);
+        const Vector3 after = velocity(squad, times[k], 1e-3f);
+        assert(gfx::are_equal(before, after, 5e-3f));
+        const Vector3 slerp_before = rotations[k].then(rotations[k - 1].inverse()).log() * (2 / (times[k] - times[k - 1]));
+        const Vector3 slerp_after = rotations[k + 1].then(rotations[k].inverse()).log() * (2 / (times[k + 1] - times[k]));
+        assert(!gfx::are_equal(slerp_before, slerp_after, 0.1f));
+    }
+    // The B-spline only goes through its ends, and is smooth everywhere with even keys
+    assert(gfx::are_equivalent(b_spline.sample(-1), rotations.front(), 1e-5f));
+    assert(gfx::are_equivalent(b_spline.sample(times.back()), rotations.back(), 1e-5f));
+    assert(!gfx::are_equivalent(b_spline.sample(times[3]), rotations[3], 1e-3f));
+    const std::vector<Scalar> even = { 0, 0.5f, 1, 1.5f, 2, 2.5f, 3 };
+    const RotationSpline even_b_spline(even, rotations, RotationSplineType::b_spline);
+    for (std::size_t k = 1; k + 1 < even.size(); ++k)
+    {
+        assert(gfx::are_equal(velocity(even_b_spline, even[k], -1e-3f), velocity(even_b_spline, even[k], 1e-3f), 5e-3f));
+    }
+    // Two keys make both curves a slerp
+    const std::vector<Rotation> ends = { rotations[0], rotations[1] };
+    for (const auto type : { RotationSplineType::squad, RotationSplineType::b_spline })
+    {
+        const RotationSpline spline({ 1, 3 }, ends, type);
+        assert(gfx::are_equivalent(spline.sample(1.5f), gfx::slerp(ends[0], ends[1], 0.25f), 1e-5f));
+    }
+
+    // Splines of various lengths, empty and single key ones included,
+    // sampled forwards in small steps, then jumping backwards and far forwards
+    std::vector<Scalar> samples;
+    for (int i = 0; i < 40; ++i) samples.push_back(i * 0.05f - 0.1f);
+    for (const Scalar t : { 0.4f, 0.1f, 1.9f, 0.0f, 5.0f }) samples.push_back(t);
+
+    for_each_simd_isa([&] {
+        for (const auto type : { RotationSplineType::squad, RotationSplineType::b_spline })
+        {
+            std::vector<RotationSpline> splines;
+            for (std::size_t i = 0; i < 37; ++i)
+            {
+                const auto [t, q] = keys(i % 11, i % 7);
+                splines.emplace_back(t, q, type);
+            }
+            gfx::RotationSplineSampler sampler(splines);
+            std::vector<Rotation> out(splines.size());
+            for (const Scalar t : samples)
+            {
+                sampler.sample(t, out);
+                for (std::size_t i = 0; i < splines.size(); ++i)
+                {
+                    assert(out[i].as_quaternion().is_rotation());
+                    assert(gfx::are_equivalent(out[i], splines[i].sample(t), 1e-5f));
+                }
+            }
+            assert(gfx::are_equivalent(out[0], Rotation()) && gfx::are_equivalent(out[1], keys(1, 1).second[0], 1e-6f));
+        }
+    });
+}
+
+void test_vector3_batch()
+{
+    // Not a multiple of any vector width, to cover the tails
+    const std::size_t n = 37;
+    const std::vector<Vector3> a = test_points(n);
+    std::vector<Vector3> b = test_points(2 * n);
+    b.erase(b.begin(), b.begin() + n);
+
+    const Vector3Batch A(a);
+    const Vector3Batch B(b);
+    assert(A.size() == n);
+    assert(reinterpret_cast<std::uintptr_t>(A.y()) % Vector3Batch::alignment == 0);
+
+    std::vector<Vector3> round_trip(n);
+    A.copy_to(round_trip);
+    for (std::size_t i = 0; i < n; ++i) assert(round_trip[i] == a[i]);
+
+    for_each_simd_isa([&] {
+        std::vector<Scalar> s(n);
+        Vector3Batch V(n);
+
+        gfx::dot(A, B, s);
+        for (std::size_t i = 0; i < n; ++i) assert(gfx::are_equal(s[i], dot(a[i], b[i])));
+
+        gfx::squared_norm(A, s);
+        for (std::size_t i = 0; i < n; ++i) assert(gfx::are_equal(s[i], a[i].squared_norm()));
+
+        gfx::distance(A, B, s);
+        for (std::size_t i = 0; i < n; ++i) assert(gfx::are_equal(s[i], distance(a[i], b[i])));
+
+        gfx::cross(A, B, V);
+        for (std::size_t i = 0; i < n; ++i) assert(V[i] == cross(a[i], b[i]));
+
+        gfx::lerp(A, B, 0.3f, V);
+        for (std::size_t i = 0; i < n; ++i) assert(V[i] == gfx::lerp(a[i], b[i], 0.3f));
+
+        gfx::normalize(A, V);
+        for (std::size_t i = 0; i < n; ++i) assert(V[i] == a[i].normalized());
+
+        // In place
+        V = A;
+        gfx::normalize(V);
+        for (std::size_t i = 0; i < n; ++i) assert(V[i] == a[i].normalized());
+    });
+
+    Vector3Batch grown;
+    for (const Vector3& v : a) grown.push_back(v);
+    for (std::size_t i = 0; i < n; ++i) assert(grown[i] == a[i]);
+}
+
+void test_rotation_batch()
+{
+    const std::size_t n = 37;
+    const std::vector<Vector3> points = test_points(n);
+    const Rotation r = Rotation::from_euler_degrees({ 32, 124, -54 });
+
+    std::vector<Rotation> rotations;
+    for (const Vector3& p : test_points(n)) rotations.push_back(Rotation::from_euler(p));
+
+    for_each_simd_isa([&] {
+        std::vector<Vector3> out(n);
+        gfx::rotate(r, points, out);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            assert(out[i] == r.rotate(points[i]));
+            assert(out[i] == r.naive_rotate(points[i]));
+        }
+
+        // In place
+        out = points;
+        gfx::rotate(r, out);
+        for (std::size_t i = 0; i < n; ++i) assert(out[i] == r.rotate(points[i]));
+
+        Vector3Batch soa(points);
+        gfx::rotate(r, soa);
+        for (std::size_t i = 0; i < n; ++i) assert(soa[i] == r.rotate(points[i]));
+
+        gfx::rotate(rotations, points, out);
+        for (std::size_t i = 0; i < n; ++i) assert(out[i] == rotations[i].rotate(points[i]));
+
+        // Matrices covering the 4 cases of from_matrix3, and drifted ones
+        std::vector<Matrix3> matrices;
+        std::vector<Matrix3> drifted;
+        for (const Rotation& q : rotations)
+        {
+            matrices.push_back(q.as_matrix3());
+            drifted.push_back(q.as_matrix3() * 1.01f + Matrix3::from_diagonal({ 0.01f, 0, -0.01f }));
+        }
+        std::vector<Rotation> from(n);
+        gfx::rotations_from_matrices(matrices, from);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            assert(from[i].as_quaternion() == Rotation::from_matrix3(matrices[i]).as_quaternion());
+            assert(gfx::are_equivalent(from[i], rotations[i]));
+        }
+        gfx::rotations_from_matrices(drifted, from, gfx::Orthonormalize::yes);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            assert(from[i].as_quaternion() == Rotation::from_matrix3(drifted[i].orthonormalized()).as_quaternion());
+        }
+    });
+}
+
+void test_cumulative_rotations()
+{
+    const std::vector<Vector3> points = test_points(1000);
+    ThreadPool pool(4);
+
+    for (const std::size_t n : { 0, 1, 7, 100, 1001, 100003 })
+    {
+        std::vector<Rotation> local;
+        for (std::size_t i = 0; i < n; ++i) local.push_back(Rotation::from_euler(points[i % points.size()] * 0.5f));
+
+        // Serial chain, in double
+        std::vector<gfx::Rotationd> expected;
+        for (const Rotation& r : local)
+        {
+            const gfx::Rotationd rd = r.cast<double>();
+            expected.push_back(expected.empty() ? rd : rd.then(expected.back()));
+        }
+
+        for_each_simd_isa([&] {
+            for (const std::size_t renormalize : { 0, 64 })
+            {
+                std::vector<Rotation> out(n);
+                gfx::cumulative_rotations(local, out, renormalize);
+                std::vector<Rotation> parallel_out(n);
+                gfx::cumulative_rotations(local, parallel_out, pool, renormalize);
+                std::vector<Rotation> in_place = local;
+                gfx::cumulative_rotations(in_place, in_place, renormalize);
+
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    const Rotation e = expected[i].cast<Scalar>();
+                    assert(gfx::are_equivalent(out[i], e, 1e-3f));
+                    assert(gfx::are_equivalent(parallel_out[i], e, 1e-3f));
+                    assert(gfx::are_equivalent(in_place[i], out[i], 1e-6f));
+                }
+                if (renormalize != 0 && n > 0)
+                {
+                    assert(gfx::are_equal(parallel_out.back().as_quaternion().squared_norm(), Scalar(1), 1e-5f));
+                }
+            }
+        });
+    }
+}
+
+void test_rotation_accumulator()
+{
+    // First-order correction of a small drift, full normalization of a large one
+    const Quaternion q = Rotation::from_euler({ 0.3f, -1.2f, 2 }).as_quaternion();
+    const Quaternion drifted = q * 1.0003f;
+    assert(std::abs(drifted.renormalized().squared_norm() - 1) < 1e-6f);
+    assert(gfx::are_equal(drifted.renormalized(), q, 1e-6f));
+    assert(gfx::are_equal(Rotation::from_drifted_quaternion(drifted).as_quaternion(), q, 1e-6f));
+    assert(gfx::are_equal(Rotation::from_drifted_quaternion(q * 3).as_quaternion(), q, 1e-6f));
+
+    // A long chain stays a rotation, with a normalization every many products
+    const std::vector<Vector3> points = test_points(1000);
+    gfx::RotationAccumulator accumulator;
+    gfx::Rotationd expected;
+    for (std::size_t i = 0; i < 20000; ++i)
+    {
+        const Rotation r = Rotation::from_euler(points[i % points.size()] * 0.1f);
+        accumulator.then(r);
+        expected = expected.then(r.cast<double>());
+        assert(accumulator.drift() <= accumulator.tolerance());
+        assert(accumulator.as_quaternion().is_rotation());
+    }
+    assert(gfx::are_equivalent(accumulator.rotation(), expected.cast<Scalar>(), 1e-3f));
+
+    // Spinning a quarter turn around y in 60 steps
+    gfx::RotationAccumulator spin;
+    for (int step = 0; step < 60; ++step) spin.integrate({ 0, gfx::radians(90), 0 }, 1.0f / 60);
+    assert(spin.as_quaternion().is_rotation());
+    assert(gfx::are_equivalent(spin.rotation(), Rotation::from_axis_angle_degrees(Vector3::up(), 90), 1e-4f));
+
+    // Bulk steps, some of them too large for the first-order correction
+    std::vector<Rotation> orientations;
+    std::vector<Vector3> velocities;
+    for (std::size_t i = 0; i < 1003; ++i)
+    {
+        orientations.push_back(Rotation::from_euler(points[i] * 3));
+        velocities.push_back(points[(i + 7) % points.size()] * (i % 5 == 0 ? 50.0f : 2.0f));
+    }
+    ThreadPool pool(3);
+    for_each_simd_isa([&] {
+        std::vector<Rotation> stepped = orientations;
+        gfx::integrate_angular_velocities(stepped, velocities, 1.0f / 60);
+        std::vector<Rotation> parallel_stepped = orientations;
+        gfx::integrate_angular_velocities(parallel_stepped, velocities, 1.0f / 60, pool, 100);
+
+        for (std::size_t i = 0; i < orientations.size(); ++i)
+        {
+            const Quaternion r = orientations[i].as_quaternion();
+            const Quaternion step = r + Quaternion { velocities[i] * (1.0f / 120), 0 } * r;
+            assert(gfx::are_equivalent(stepped[i], Rotation::from_quaternion(step), 1e-6f));
+            assert(stepped[i].as_quaternion().is_rotation());
+            assert(gfx::are_equivalent(parallel_stepped[i], stepped[i], 1e-6f));
+        }
+    });
+}
+
+void test_matrix3_batch()
+{
+    const std::size_t n = 37;
+    const std::vector<Vector3> points = test_points(n);
+    const Matrix3 M = Matrix3 { { 2, -1, 0.5 }, { 1, 3, -2 }, { 0.25, 4, 1 } }.normal_matrix();
+
+    for_each_simd_isa([&] {
+        std::vector<Vector3> out(n);
+        gfx::multiply(M, points, out);
+        for (std::size_t i = 0; i < n; ++i) assert(out[i] == M * points[i]);
+
+        // In place
+        out = points;
+        gfx::multiply(M, out);
+        for (std::size_t i = 0; i < n; ++i) assert(out[i] == M * points[i]);
+
+        Vector3Batch soa(points);
+        gfx::multiply(M, soa);
+        for (std::size_t i = 0; i < n; ++i) assert(soa[i] == M * points[i]);
+    });
+}
+
+// Angles of the rotations of an order, in the order they are applied, as the angles vector
+Vector3 euler_angles(const EulerOrder order, const Vector3& in_order)
+{
+    const auto components = gfx::euler_angle_components(order);
+    Scalar angles[3] = {};
+    for (unsigned k = 0; k < 3; ++k) angles[components[k]] = in_order.element(k + 1);
+    return { angles[0], angles[1], angles[2] };
+}
+
+template <EulerOrder order>
+void test_euler_order()
+{
+    const auto axes = gfx::euler_axes(order);
+    const Vector3 unit[3] = { Vector3::right(), Vector3::up(), Vector3::forwards() };
+
+    std::vector<Vector3> angles;
+    for (const Vector3& p : test_points(50)) angles.push_back(p * 6);
+
+    for (const Vector3& a : angles)
+    {
+        // Same as the product of the three rotations
+        const auto components = gfx::euler_angle_components(order);
+        Rotation expected;
+        for (unsigned k = 0; k < 3; ++k)
+        {
+            expected = expected.then(Rotation::from_axis_angle(unit[axes[k]], a.element(components[k] + 1)));
+        }
+        const Rotation r = Rotation::from_euler<order>(a);
+        assert(gfx::are_equivalent(r, expected));
+
+        assert(gfx::are_equivalent(Rotation::from_euler<order>(r.to_euler<order>()), r, 1e-4f));
+    }
+
+    // In range, the same angles
+    const Vector3 in_range = euler_angles(order, { 0.3f, 1.2f, -2.5f });
+    assert(gfx::are_equal(Rotation::from_euler<order>(in_range).template to_euler<order>(), in_range, 1e-4f));
+    assert(gfx::are_equal(Rotation::from_euler_degrees<order>({ 10, 20, 30 }).template to_euler_degrees<order>(), Vector3(10, 20, 30), 1e-2f));
+
+    // Gimbal lock: the first and last axes line up, the last angle becomes 0
+    const Scalar lock = gfx::is_proper_euler(order) ? 0 : M_PI / 2;
+    for (const Scalar middle : { lock, -lock })
+    {
+        const Rotation r = Rotation::from_euler<order>(euler_angles(order, { 0.4f, middle, 0.7f }));
+        const Vector3 back = r.to_euler<order>();
+        assert(back.element(gfx::euler_angle_components(order)[2] + 1) == 0);
+        assert(gfx::are_equivalent(Rotation::from_euler<order>(back), r, 1e-4f));
+    }
+
+    for_each_simd_isa([&] {
+        std::vector<Rotation> out(angles.size());
+        gfx::rotations_from_euler(angles, out, order);
+        for (std::size_t i = 0; i < angles.size(); ++i)
+        {
+            assert(gfx::are_equivalent(out[i], Rotation::from_euler<order>(angles[i])));
+        }
+    });
+}
+
+template <std::size_t... i>
+void test_euler_orders(std::index_sequence<i...>)
+{
+    (test_euler_order<gfx::EULER_ORDERS[i]>(), ...);
+}
+
+void test_euler()
+{
+    test_euler_orders(std::make_index_sequence<gfx::EULER_ORDERS.size()>());
+
+    // The default order is Unity's: z, then x, then y
+    const Vector3 angles = { 0.5f, -1.2f, 2.4f };
+    const Rotation roll  = Rotation::from_axis_angle(Vector3::forwards(), angles.z);
+    const Rotation pitch = Rotation::from_axis_angle(Vector3::right(),    angles.x);
+    const Rotation yaw   = Rotation::from_axis_angle(Vector3::up(),       angles.y);
+    assert(gfx::are_equivalent(Rotation::from_euler(angles), roll.then(pitch).then(yaw)));
+    assert(gfx::are_equal(Rotation::from_euler(angles).to_euler(), angles, 1e-4f));
+
+    static_assert(Rotation::from_euler<EulerOrder::zyz, gfx::FastMath>({ 0, 0, 0 }).as_quaternion() == Quaternion { {}, 1 });
+}
+
+void test_rotation_encoding()
+{
+    using gfx::RotationEncoding;
+
+    std::vector<Rotation> rotations;
+    for (const Vector3& p : test_points(61)) rotations.push_back(Rotation::from_euler(p * 3));
+    // Worst cases: all components ±1/2, two largest components, identity and its opposite
+    rotations.push_back(Rotation::from_quaternion({ { 0.5, -0.5, 0.5 }, 0.5 }));
+    rotations.push_back(Rotation::from_quaternion({ { 0.7071, 0.7072, 0 }, 0 }));
+    rotations.push_back(Rotation());
+    rotations.push_back(Rotation::from_quaternion({ Vector3::zero(), -1 }));
+    const std::size_t n = rotations.size();
+
+    for_each_simd_isa([&] {
+        for (const RotationEncoding encoding : {
+                 RotationEncoding::smallest_three_32,
+                 RotationEncoding::smallest_three_48,
+                 RotationEncoding::smallest_three_64 })
+        {
+            std::vector<std::byte> packed(n * gfx::bytes_per_rotation(encoding));
+            std::vector<Rotation> decoded(n);
+            gfx::encode_rotations(rotations, packed, encoding);
+            gfx::decode_rotations(packed, decoded, encoding);
+
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                const Quaternion q = rotations[i].as_quaternion();
+                const Quaternion d = decoded[i].as_quaternion();
+                assert(d.is_rotation());
+                const Scalar angle = 4 * std::asin(std::min((q - d).norm(), (q + d).norm()) / 2);
+                assert(angle <= gfx::max_angular_error(encoding));
+            }
+        }
+    });
+
+    // Any bytes decode to a rotation
+    std::vector<std::byte> garbage(8 * n);
+    for (std::size_t i = 0; i < garbage.size(); ++i) garbage[i] = std::byte(i * 37 + 11);
+    std::vector<Rotation> decoded(n);
+    gfx::decode_rotations(garbage, decoded, RotationEncoding::smallest_three_64);
+    for (const Rotation& r : decoded) assert(r.as_quaternion().is_rotation());
+}
+
+void test_transform_batch()
+{
+    const std::size_t n = 37;
+    const std::vector<Vector3> points = test_points(n);
+
+    std::vector<Transform> transforms;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        transforms.push_back({
+            .translation = points[i],
+            .rotation = Rotation::from_euler(points[(i + 1) % n]),
+            .scale = { 1 + Scalar(i % 3), 0.5, 2 },
+        });
+    }
+
+    for_each_simd_isa([&] {
+        for (const auto layout : { gfx::MatrixLayout::column_major_4x4, gfx::MatrixLayout::column_major_3x4 })
+        {
+            const std::size_t size = gfx::floats_per_matrix(layout);
+
+            // One extra matrix, which must stay untouched
+            std::vector<float> out((n + 1) * size, -1);
+            gfx::write_matrices(transforms, out, layout);
+
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                const auto expected = transforms[i].as_matrix4().column_major();
+                for (std::size_t c = 0; c < 4; ++c)
+                {
+                    for (std::size_t r = 0; r < size / 4; ++r)
+                    {
+                        assert(gfx::are_equal(out[i * size + c * size / 4 + r], expected[4 * c + r]));
+                    }
+                }
+            }
+            for (std::size_t k = n * size; k < out.size(); ++k) assert(out[k] == -1);
+        }
+    });
+}
+
+void test_dual_quaternion()
+{
+    const Rotation r = Rotation::from_euler_degrees({ 30, -70, 115 });
+    const Vector3 t = { 1, -2, 3 };
+    const DualQuaternion q = DualQuaternion::from_rotation_translation(r, t);
+    const Vector3 p = { 0.5f, 4, -1 };
+    assert(are_equal(q.transform_point(p), r.rotate(p) + t));
+    assert(are_equal(q.transform_direction(p), r.rotate(p)));
+    assert(are_equal(q.translation(), t));
+    assert(are_equivalent(q.rotation(), r));
+    assert(are_equal(DualQuaternion().transform_point(p), p));
+
+    const DualQuaternion u = DualQuaternion::from_rotation_translation(Rotation::from_axis_angle_degrees(Vector3::up(), 40), { 0, 5, 0 });
+    assert(are_equal(q.then(u).transform_point(p), u.transform_point(q.transform_point(p))));
+    assert(are_equal((u * q).transform_point(p), u.transform_point(q.transform_point(p))));
+    assert(are_equal(q.conjugated().transform_point(q.transform_point(p)), p));
+    assert(gfx::are_equivalent(q * Scalar(-1), q));
+
+    // Blends are brought back to rigid transforms
+    const DualQuaternion scaled = q * Scalar(3);
+    assert(gfx::are_equal(scaled.normalized(), q, 1e-6f));
+    const DualQuaternion drifted = { q.real + Quaternion { { 0.01f, 0, 0 }, 0 }, q.dual + Quaternion { { 0, 0.02f, 0 }, 0.01f } };
+    const DualQuaternion n = drifted.normalized();
+    assert(gfx::are_equal(n.real.squared_norm(), 1.0f) && std::abs(n.real.dot(n.dual)) < 1e-6f);
+}
+
+void test_skinning()
+{
+    const std::size_t bone_count = 13;
+    std::vector<Transform> poses;
+    std::vector<DualQuaternion> dual_quaternions;
+    for (const Vector3& p : test_points(bone_count))
+    {
+        const Transform pose = { .translation = p * 2, .rotation = Rotation::from_euler(p * 3) };
+        poses.push_back(pose);
+        dual_quaternions.push_back(DualQuaternion::from_rotation_translation(pose.rotation, pose.translation));
+    }
+    std::vector<float> matrices(12 * bone_count);
+    gfx::write_matrices(poses, matrices, gfx::MatrixLayout::column_major_3x4);
+
+    const std::size_t n = 1003;
+    const std::vector<Vector3> points = test_points(n);
+    std::vector<Vector3> normals;
+    for (const Vector3& p : points) normals.push_back(Vector3 { p.y, p.z, 1 }.normalized());
+    const Vector3Batch positions(points);
+    const Vector3Batch normal_batch(normals);
+
+    for (const std::size_t count : { std::size_t(1), std::size_t(3), std::size_t(4), std::size_t(8) })
+    {
+        std::vector<std::uint16_t> bones;
+        std::vector<Scalar> weights;
+        for (std::size_t v = 0; v < n; ++v)
+        {
+            Scalar sum = 0;
+            for (std::size_t k = 0; k < count; ++k)
+            {
+                bones.push_back(std::uint16_t((v * 7 + k * 5) % bone_count));
+                // Some unused influences
+                weights.push_back((v + k) % 5 == 4 ? 0 : 1 + Scalar((v * 3 + k) % 4));
+                sum += weights.back();
+            }
+            if (sum == 0) weights[v * count] = sum = 1;
+            for (std::size_t k = 0; k < count; ++k) weights[v * count + k] /= sum;
+        }
+        const gfx::SkinInfluences influences = { bones, weights, count };
+
+        // Blends of the scalar operations
+        std::vector<Vector3> linear_positions, linear_normals, dual_positions, dual_normals;
+        for (std::size_t v = 0; v < n; ++v)
+        {
+            Vector3 p = Vector3::zero();
+            Vector3 d = Vector3::zero();
+            DualQuaternion blend = { Quaternion { Vector3::zero(), 0 }, Quaternion { Vector3::zero(), 0 } };
+            const Quaternion& first = dual_quaternions[bones[v * count]].real;
+            for (std::size_t k = 0; k < count; ++k)
+            {
+                const Scalar w = weights[v * count + k];
+                const std::uint16_t b = bones[v * count + k];
+                p += w * poses[b].transform_point(points[v]);
+                d += w * poses[b].transform_direction(normals[v]);
+                blend = blend + dual_quaternions[b] * (first.dot(dual_quaternions[b].real) < 0 ? -w : w);
+            }
+            blend = blend * (1 / blend.real.norm());
+            linear_positions.push_back(p);
+            linear_normals.push_back(d.normalized());
+            dual_positions.push_back(blend.transform_point(points[v]));
+            dual_normals.push_back(blend.transform_direction(normals[v]));
+        }
+
+        ThreadPool pool(4);
+        for_each_simd_isa([&] {
+            Vector3Batch out(n);
+            Vector3Batch out_normals(n);
+            const auto check = [&](const std::vector<Vector3>& expected, const Vector3Batch& actual) {
+                for (std::size_t v = 0; v < n; ++v) assert(gfx::are_equal(actual[v], expected[v], 1e-5f));
+            };
+
+            gfx::skin_linear(influences, matrices, positions, normal_batch, out, out_normals);
+            check(linear_positions, out);
+            check(linear_normals, out_normals);
+            gfx::skin_linear(influences, matrices, positions, {}, out, {}, pool, 64);
+            check(linear_positions, out);
+
+            gfx::skin_dual_quaternion(influences, dual_quaternions, positions, normal_batch, out, out_normals);
+            check(dual_positions, out);
+            check(dual_normals, out_normals);
+            gfx::skin_dual_quaternion(influences, dual_quaternions, positions, normal_batch, out, out_normals, pool, 64);
+            check(dual_positions, out);
+            check(dual_normals, out_normals);
+        });
+    }
+
+    // Half way along a joint twisted by 180°, linear blending collapses to the axis
+    const DualQuaternion twist[2] = {
+        DualQuaternion(),
+        DualQuaternion::from_rotation_translation(Rotation::from_axis_angle_degrees(Vector3::right(), 180), Vector3::zero()),
+    };
+    const std::uint16_t twist_bones[2] = { 0, 1 };
+    const Scalar twist_weights[2] = { 0.5f, 0.5f };
+    Vector3Batch twisted(1);
+    const Vector3Batch skin_point(std::vector<Vector3> { { 2, 1, 0 } });
+    gfx::skin_dual_quaternion({ twist_bones, twist_weights, 2 }, twist, skin_point, {}, twisted, {});
+    assert(gfx::are_equal(twisted[0].with_x(0).norm(), 1.0f) && gfx::are_equal(twisted[0].x, 2.0f));
+
+    const Transform twist_poses[2] = { { .rotation = twist[0].rotation() }, { .rotation = twist[1].rotation() } };
+    float twist_matrices[24];
+    gfx::write_matrices(twist_poses, twist_matrices, gfx::MatrixLayout::column_major_3x4);
+    gfx::skin_linear({ twist_bones, twist_weights, 2 }, twist_matrices, skin_point, {}, twisted, {});
+    assert(twisted[0].with_x(0).norm() < 1e-6f);
+}
+
+template <std::size_t N>
+void test_ray_packet(const std::vector<Sphere>& spheres)
+{
+    // Camera-like fan of rays, some of them missing everything
+    std::vector<Ray> rays;
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        const Scalar u = Scalar(i) / N - 0.5f;
+        rays.push_back({ { 0, 0, -20 }, { 2 * u, u * u, 1 } });
+    }
+    const RayPacket<N> packet(std::span<const Ray, N>(rays.data(), N));
+
+    const auto hits = packet.intersect(spheres);
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        // Linear scan with the scalar intersection
+        Scalar closest = INFINITY;
+        for (const Sphere& s : spheres)
+        {
+            const Vector3 hit = rays[i].intersect(s);
+            if (!std::isinf(hit.x)) closest = std::min(closest, distance(hit, rays[i].start()));
+        }
+
+        assert(hits.hit(i) == (closest != INFINITY));
+        if (!hits.hit(i)) continue;
+
+        assert(gfx::are_equal(hits.t[i], closest, 1e-3f));
+        assert(packet.at(i, hits.t[i]) == rays[i].intersect(spheres[hits.sphere[i]]));
+    }
+
+    const auto single = packet.intersect(spheres.front());
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        assert(single.hit(i) == !std::isinf(rays[i].intersect(spheres.front()).x));
+    }
+}
+
+void test_ray_packets()
+{
+    const std::vector<Sphere> spheres = {
+        { { 0, 0, 0 }, 2 },
+        { { -4, 0.5, 5 }, 3 },
+        { { 6, 1, 10 }, 4 },
+        { { 0, 0, -30 }, 1 }, // Behind the rays
+    };
+
+    for_each_simd_isa([&] {
+        test_ray_packet<4>(spheres);
+        test_ray_packet<8>(spheres);
+        test_ray_packet<16>(spheres);
+    });
+}
+
+void test_triangle_mesh()
+{
+    // Front face towards +z
+    const Triangle triangle { { -1, -1, 10 }, { 1, -1, 10 }, { 0, 1, 10 } };
+    assert(triangle.normal() == Vector3::forwards());
+    const Ray ray { Vector3::origin(), Vector3::forwards() };
+    const Hit hit = ray.closest_hit(triangle);
+    assert(hit && hit.primitive == 0 && gfx::are_equal(hit.t, 10.0f));
+    assert(hit.point == Vector3(0, 0, 10) && hit.normal == Vector3::forwards());
+    assert(!ray.closest_hit(triangle, 0, 9.9f) && !ray.closest_hit(triangle, 10.1f));
+    assert(!Ray({ 1, 1, 0 }, Vector3::forwards()).closest_hit(triangle));
+    assert(!Ray(Vector3::origin(), Vector3::backwards()).closest_hit(triangle));
+    assert(!Ray({ 0, 0, 10 }, Vector3::up()).closest_hit(triangle));
+    assert(!ray.closest_hit(Triangle { { 0, 0, 10 }, { 1, 1, 10 }, { 2, 2, 10 } }));
+
+    // Bumpy grid of 8x8 quads, plus a degenerate triangle
+    const std::uint32_t side = 9;
+    std::vector<Vector3> vertices;
+    for (std::uint32_t i = 0; i < side; ++i)
+    {
+        for (std::uint32_t j = 0; j < side; ++j)
+        {
+            const Scalar x = Scalar(i) - 4;
+            const Scalar z = Scalar(j) - 4;
+            vertices.push_back({ x, std::sin(x) * std::cos(z * 0.7f), z });
+        }
+    }
+    std::vector<std::uint32_t> indices;
+    for (std::uint32_t i = 0; i + 1 < side; ++i)
+    {
+        for (std::uint32_t j = 0; j + 1 < side; ++j)
+        {
+            const std::uint32_t k = i * side + j;
+            indices.insert(indices.end(), { k, k + 1, k + side, k + 1, k + side + 1, k + side });
+        }
+    }
+    indices.insert(indices.end(), { 3, 3, 40 });
+    const TriangleMesh mesh(vertices, indices);
+    assert(mesh.size() == 129 && mesh.vertices().size() == vertices.size() && mesh.triangle(128).a == vertices[3]);
+
+    std::vector<Triangle> triangles;
+    for (std::size_t i = 0; i < mesh.size(); ++i) triangles.push_back(mesh.triangle(i));
+    const TriangleBatch batch(mesh);
+    assert(batch.size() == mesh.size() && gfx::are_equal(batch.triangle(5).c, triangles[5].c));
+    assert(batch.normals()[5] == triangles[5].normal());
+
+    // Rays from above and from the sides, some missing, some grazing the bumps
+    std::vector<Ray> rays;
+    const std::vector<Vector3> points = test_points(50);
+    for (const Vector3& p : points)
+    {
+        rays.emplace_back(Vector3 { p.x, 3, p.y }, Vector3 { p.z, -1, p.x * 0.1f });
+        rays.emplace_back(Vector3 { -6, p.z, p.y }, Vector3 { 1, p.x * 0.05f, p.y * 0.1f });
+    }
+
+    for_each_simd_isa([&] {
+        for (const Ray& r : rays)
+        {
+            for (const Scalar t_min : { 0.0f, 2.5f })
+            {
+                const Hit expected = r.closest_hit(triangles, t_min);
+                for (const Hit& h : { mesh.closest_hit(r, t_min), batch.closest_hit(r, t_min) })
+                {
+                    assert(bool(h) == bool(expected));
+                    if (!h) continue;
+                    assert(gfx::are_equal(h.t, expected.t, 1e-4f));
+                    assert(h.primitive == expected.primitive || gfx::are_equal(r.hit_distance(triangles[h.primitive], t_min), expected.t, 1e-4f));
+                    assert(gfx::are_equal(h.point, r.at(h.t)) && h.normal == triangles[h.primitive].normal());
+                }
+                assert(mesh.any_hit(r, t_min) == bool(expected) && batch.any_hit(r, t_min) == bool(expected));
+                if (expected)
+                {
+                    assert(!mesh.any_hit(r, t_min, expected.t * 0.99f) || r.any_hit(triangles, t_min, expected.t * 0.99f));
+                    assert(!mesh.closest_hit(r, expected.t * 1.01f) || mesh.closest_hit(r, expected.t * 1.01f).t > expected.t);
+                }
+            }
+        }
+        assert(!TriangleMesh().closest_hit(ray) && !TriangleBatch().any_hit(ray));
+    });
+}
+
+void test_ray_hits()
+{
+    const Sphere sphere { { 0, 0, 10 }, 2 };
+    const Ray ray { Vector3::origin(), Vector3::forwards() };
+
+    const Hit hit = ray.closest_hit(sphere);
+    assert(hit && hit.primitive == 0);
+    assert(gfx::are_equal(hit.t, 8.0f));
+    assert(hit.point == Vector3(0, 0, 8));
+    assert(hit.normal == Vector3::backwards());
+
+    // Past the near side, or starting inside: the far side, seen from within
+    const Hit far = ray.closest_hit(sphere, 9);
+    assert(gfx::are_equal(far.t, 12.0f));
+    assert(far.normal == Vector3::forwards());
+    assert(Ray({ 0, 0, 10 }, Vector3::up()).closest_hit(sphere).point == Vector3(0, 2, 10));
+
+    // Out of range
+    assert(!ray.closest_hit(sphere, 0, 7.9f));
+    assert(!ray.closest_hit(sphere, 12.1f));
+    assert(!Ray(Vector3::origin(), Vector3::backwards()).closest_hit(sphere));
+    assert(!Ray(Vector3::origin(), Vector3::up()).closest_hit(sphere));
+
+    // Closest of several, with its index
+    const Sphere spheres[] = { sphere, { { 0, 0, 5 }, 1 }, { { 0, 5, 0 }, 1 } };
+    const Hit closest = ray.closest_hit(spheres);
+    assert(closest.primitive == 1 && gfx::are_equal(closest.t, 4.0f));
+    assert(ray.closest_hit(spheres, 4.5f).primitive == 1);
+    assert(ray.closest_hit(spheres, 6.5f).primitive == 0);
+    assert(!ray.closest_hit(std::span(spheres).last(1)));
+
+    // The occlusion query agrees with the hit record, over ranges around every root
+    const Scalar bounds[] = { 0, 3.9f, 4.1f, 5.9f, 6.1f, 7.9f, 8.1f, 10, 11.9f, 12.1f, INFINITY };
+    for (const Scalar t_min : bounds)
+    {
+        for (const Scalar t_max : bounds)
+        {
+            if (t_max < t_min) continue;
+            for (const Sphere& s : spheres)
+            {
+                assert(ray.any_hit(s, t_min, t_max) == bool(ray.closest_hit(s, t_min, t_max)));
+            }
+            assert(ray.any_hit(spheres, t_min, t_max) == bool(ray.closest_hit(spheres, t_min, t_max)));
+        }
+    }
+    for (const Vector3& p : test_points(500))
+    {
+        const Ray r { p * 4, p.cross(Vector3::one()) + Vector3::up() };
+        for (const Sphere& s : spheres)
+        {
+            assert(r.any_hit(s) == bool(r.closest_hit(s)));
+            assert(r.any_hit(s, 0, 5) == bool(r.closest_hit(s, 0, 5)));
+        }
+    }
+}
+
+void test_bvh()
+{
+    // Scattered spheres of different sizes, with some clustering from the test points
+    std::vector<Sphere> spheres;
+    for (const Vector3& p : test_points(3000))
+    {
+        spheres.push_back({ p * 10 + Vector3 { p.z * 40, 0, 0 }, 0.1f + std::abs(p.y) * 0.2f });
+    }
+
+    std::vector<Ray> rays;
+    for (const Vector3& p : test_points(200))
+    {
+        rays.push_back({ { 0, 0, -40 }, p.with_z(8) });
+        rays.push_back({ p * 5, { p.y, p.z, p.x } });
+    }
+
+    const Bvh bvh(spheres);
+    // Force the parallel builder on a small input
+    const Bvh parallel_bvh(spheres, { .parallel_threshold = 64, .threads = 4 });
+    assert(bvh.size() == spheres.size());
+    assert(parallel_bvh.nodes().size() == bvh.nodes().size());
+
+    std::size_t hits = 0;
+    for (const Ray& ray : rays)
+    {
+        const Hit closest = ray.closest_hit(spheres);
+
+        for (const Bvh* tree : { &bvh, &parallel_bvh })
+        {
+            const Hit hit = tree->closest_hit(ray);
+            assert(bool(hit) == bool(closest));
+            assert(tree->any_hit(ray) == bool(hit));
+            if (!hit) continue;
+
+            assert(gfx::are_equal(hit.t, closest.t, 1e-3f));
+            assert(hit.point == closest.point);
+            assert(!std::isinf(ray.hit_distance(spheres[hit.primitive])));
+
+            // Nothing closer than the closest hit, and something further on
+            assert(!tree->any_hit(ray, 0, hit.t * 0.999f));
+            assert(tree->any_hit(ray, hit.t * 0.999f));
+            assert(tree->closest_hit(ray, hit.t * 1.001f).t > hit.t);
+        }
+        hits += bool(closest);
+    }
+    // Make sure the test covers both hits and misses
+    assert(hits > 0 && hits < rays.size());
+}
+
+void test_spatial_hash()
+{
+    std::vector<Sphere> spheres;
+    for (const Vector3& p : test_points(2000))
+    {
+        spheres.push_back({ p * 20 + Vector3 { p.z * 30, 0, 0 }, 0.2f + std::abs(p.y) * 0.5f });
+    }
+
+    const auto brute_force_pairs = [](const std::vector<Sphere>& s) {
+        std::vector<gfx::SpatialHash::Pair> pairs;
+        for (std::uint32_t i = 0; i < s.size(); ++i)
+        {
+            for (std::uint32_t j = i + 1; j < s.size(); ++j)
+            {
+                const Scalar r = s[i].radius + s[j].radius;
+                if ((s[j].center - s[i].center).squared_norm() < r * r) pairs.push_back({ i, j });
+            }
+        }
+        return pairs;
+    };
+    const auto sorted = [](const std::pmr::vector<gfx::SpatialHash::Pair>& found) {
+        std::vector<gfx::SpatialHash::Pair> pairs(found.begin(), found.end());
+        std::sort(pairs.begin(), pairs.end());
+        return pairs;
+    };
+
+    gfx::SpatialHash hash(spheres);
+    assert(hash.size() == spheres.size());
+    assert(hash.cell_size() >= 2 * 0.7f);
+
+    std::pmr::vector<gfx::SpatialHash::Pair> pairs;
+    hash.overlapping_pairs(pairs);
+    const auto expected = brute_force_pairs(spheres);
+    assert(!expected.empty());
+    assert(sorted(pairs) == expected);
+
+    ThreadPool pool(3);
+    std::pmr::vector<gfx::SpatialHash::Pair> parallel_pairs;
+    hash.overlapping_pairs(parallel_pairs, pool, 64);
+    assert(parallel_pairs == pairs);
+
+    // Small steps, with a few spheres jumping far and one growing past the cells
+    const std::vector<Vector3> steps = test_points(spheres.size());
+    for (int frame = 0; frame < 3; ++frame)
+    {
+        for (std::size_t i = 0; i < spheres.size(); ++i) spheres[i].center += steps[i] * 0.3f;
+        spheres[frame * 7].center = { 100.0f * frame, -50, 3 };
+        if (frame == 2) spheres[5].radius = 2;
+
+        hash.update(spheres);
+        hash.overlapping_pairs(pairs);
+        assert(sorted(pairs) == brute_force_pairs(spheres));
+    }
+    assert(hash.cell_size() >= 4);
+
+    // Neighbours within a radius, with larger and smaller query spheres than the cells
+    for (const Sphere& q : { Sphere { Vector3::zero(), 3 }, Sphere { { 10, 5, -2 }, 0.5f }, Sphere { Vector3::zero(), 100 } })
+    {
+        std::pmr::vector<std::uint32_t> found;
+        hash.query(q, found);
+        std::sort(found.begin(), found.end());
+
+        std::vector<std::uint32_t> expected_found;
+        for (std::uint32_t i = 0; i < spheres.size(); ++i)
+        {
+            const Scalar r = q.radius + spheres[i].radius;
+            if ((spheres[i].center - q.center).squared_norm() < r * r) expected_found.push_back(i);
+        }
+        assert(std::ranges::equal(found, expected_found));
+    }
+
+    // Cells larger than needed give the same pairs
+    const gfx::SpatialHash coarse(spheres, 10);
+    assert(coarse.cell_size() == 10);
+    coarse.overlapping_pairs(parallel_pairs);
+    assert(sorted(parallel_pairs) == sorted(pairs));
+
+    gfx::SpatialHash empty;
+    empty.build({});
+    empty.overlapping_pairs(pairs);
+    assert(pairs.empty());
+}
+
+void test_frustum()
+{
+    const Plane plane = Plane::through({ 0, 2, 0 }, { 0, 3, 0 });
+    assert(gfx::are_equal(plane.signed_distance({ 5, 3, -1 }), 1.0f));
+    assert(gfx::are_equal(Plane { { 0, 2, 0 }, -4 }.normalized().signed_distance({ 5, 3, -1 }), 1.0f));
+    assert(plane.reaches({ { 0, 1.5f, 0 }, 0.6f }) && !plane.reaches({ { 0, 1.5f, 0 }, 0.4f }));
+
+    // 90° wide, from 1 to 100 along z
+    const gfx::Camera camera { .position = Vector3::zero(), .rotation = Rotation(), .fov = gfx::radians(90) };
+    const Frustum frustum = camera.frustum(1, 1, 100);
+    assert(frustum.contains({ 0, 0, 10 }) && frustum.contains({ 9, -9, 10 }));
+    assert(!frustum.contains({ 0, 0, -10 }) && !frustum.contains({ 0, 0, 0.5f }) && !frustum.contains({ 0, 0, 101 }));
+    assert(!frustum.contains({ 11, 0, 10 }) && !frustum.contains({ 0, 11, 10 }));
+    assert(frustum.intersects({ { 11, 0, 10 }, 1 }) && !frustum.intersects({ { 11, 0, 10 }, 0.5f }));
+    assert(frustum.intersects({ { 0, 0, 0.5f }, 0.6f }) && !frustum.intersects({ { 0, 0, -1 }, 1.5f }));
+
+    // Turned around, then moved
+    const Rotation back = Rotation::from_axis_angle_degrees(Vector3::up(), 180);
+    const Frustum behind = Frustum::perspective({ 0, 0, 5 }, back, gfx::radians(90), 1, 1, 100);
+    assert(behind.contains({ 0, 0, -10 }) && behind.contains({ 0, 0, 3 }) && !behind.contains({ 0, 0, 4.5f }));
+
+    std::vector<Vector3> centers;
+    std::vector<Scalar> radii;
+    for (const Vector3& p : test_points(1003))
+    {
+        centers.push_back({ p.x * 10, p.y * 10, p.z * 60 });
+        radii.push_back(std::abs(p.y) * 2 - 0.5f);
+    }
+    const Vector3Batch batch(centers);
+
+    const Frustum frusta[3] = {
+        frustum,
+        behind,
+        Frustum::perspective({ 1, 0, 0 }, Rotation::from_axis_angle_degrees(Vector3::up(), 90), gfx::radians(60), 2, 0.5f, 20),
+    };
+
+    for_each_simd_isa([&] {
+        std::vector<std::uint32_t> masks(centers.size());
+        gfx::cull_spheres(batch, radii, frusta, masks);
+
+        std::vector<std::uint32_t> visible[3];
+        std::vector<std::uint32_t> single(centers.size());
+        for (std::vector<std::uint32_t>& v : visible) v.resize(centers.size());
+        const std::span<std::uint32_t> lists[3] = { visible[0], visible[1], visible[2] };
+        std::size_t counts[3];
+        gfx::cull_spheres(batch, radii, frusta, lists, counts);
+
+        for (std::size_t f = 0; f < 3; ++f)
+        {
+            std::vector<std::uint32_t> expected;
+            for (std::uint32_t i = 0; i < centers.size(); ++i)
+            {
+                const bool in = frusta[f].intersects({ centers[i], radii[i] });
+                assert(bool(masks[i] >> f & 1) == in);
+                if (in) expected.push_back(i);
+            }
+            assert(!expected.empty() && expected.size() < centers.size());
+            assert(std::ranges::equal(std::span(visible[f]).first(counts[f]), expected));
+
+            const std::size_t count = gfx::cull_spheres(batch, radii, frusta[f], single);
+            assert(std::ranges::equal(std::span(single).first(count), expected));
+        }
+        assert(std::ranges::all_of(masks, [](const std::uint32_t m) { return m < 8; }));
+    });
+
+    assert(gfx::cull_spheres(gfx::ConstVector3Span(), {}, frustum, {}) == 0);
+}
+
+void test_memory()
+{
+    const auto aligned = [](const void* p, const std::size_t alignment) {
+        return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+    };
+
+    // Overflowing into upstream chunks, then growing to fit them after a reset
+    gfx::LinearArena arena(64);
+    assert(arena.capacity() == 64);
+    const auto allocate_frame = [&] {
+        const void* a = arena.allocate(10, 1);
+        const void* b = arena.allocate(8, 8);
+        const void* c = arena.allocate(1000, 64);
+        const void* d = arena.allocate(40, 16);
+        assert(aligned(b, 8) && aligned(c, 64) && aligned(d, 16));
+        assert(a != b && b != c && c != d);
+    };
+    allocate_frame();
+    assert(arena.overflow() >= 1000);
+    arena.reset();
+    assert(arena.overflow() == 0 && arena.capacity() >= 1064);
+    allocate_frame();
+    assert(arena.overflow() == 0);
+
+    alignas(16) std::byte buffer[256];
+    gfx::LinearArena outside(buffer);
+    const std::byte* in_buffer = static_cast<const std::byte*>(outside.allocate(100, 4));
+    assert(in_buffer >= buffer && in_buffer + 100 <= buffer + sizeof(buffer));
+    assert(outside.allocate(200, 4) != in_buffer);
+    assert(outside.overflow() > 0);
+    outside.reset();
+    assert(outside.capacity() > sizeof(buffer) && outside.overflow() == 0);
+
+    // Freed blocks come back first, larger requests pass through
+    gfx::BlockPool pool(20, 4);
+    assert(pool.block_size() == 32);
+    std::vector<void*> blocks;
+    for (int k = 0; k < 9; ++k) blocks.push_back(pool.allocate(20));
+    assert(std::ranges::all_of(blocks, [&](const void* p) { return aligned(p, gfx::BlockPool::alignment); }));
+    std::vector<void*> distinct = blocks;
+    std::sort(distinct.begin(), distinct.end());
+    assert(std::adjacent_find(distinct.begin(), distinct.end()) == distinct.end());
+    pool.deallocate(blocks[3], 20);
+    assert(pool.allocate(8) == blocks[3]);
+    void* large = pool.allocate(1000);
+    pool.deallocate(large, 1000);
+    for (void* p : blocks) pool.deallocate(p, 20);
+
+    // A frame of ray and sphere queries allocates nothing once its arena is large enough
+    std::vector<Sphere> spheres;
+    std::vector<Vector3> centers;
+    std::vector<Scalar> radii;
+    for (const Vector3& p : test_points(700))
+    {
+        spheres.push_back({ p * 20, 0.3f + std::abs(p.x) });
+        centers.push_back(spheres.back().center);
+        radii.push_back(spheres.back().radius);
+    }
+    std::vector<Vector3> starts;
+    std::vector<Vector3> dirs;
+    for (const Vector3& p : test_points(301))
+    {
+        starts.push_back(p * 30);
+        dirs.push_back(-p);
+    }
+    const std::vector<Vector3> steps = test_points(spheres.size());
+    const Frustum frustum = Frustum::perspective({ 0, 0, -40 }, Rotation(), gfx::radians(50), 1, 1, 100);
+
+    gfx::LinearArena frame_memory;
+    Bvh bvh;
+    gfx::SpatialHash hash(spheres);
+    std::size_t last_hits = 0;
+    std::size_t last_pairs = 0;
+    const auto frame = [&](const int k) {
+        frame_memory.reset();
+
+        const Vector3Batch ray_starts(starts, &frame_memory);
+        const Vector3Batch ray_dirs(dirs, &frame_memory);
+        std::pmr::vector<Scalar> t(starts.size(), &frame_memory);
+        std::pmr::vector<std::uint32_t> index(starts.size(), &frame_memory);
+        gfx::intersect(ray_starts, ray_dirs, spheres, t, index);
+
+        bvh.build(spheres, {}, &frame_memory);
+        std::size_t hits = 0;
+        for (std::size_t i = 0; i < starts.size(); ++i)
+        {
+            const Ray ray = { starts[i], dirs[i] };
+            const Hit hit = bvh.closest_hit(ray);
+            assert(hit.primitive == ray.closest_hit(spheres).primitive);
+            hits += hit.primitive != gfx::no_hit && index[i] != gfx::no_hit;
+        }
+
+        const Vector3Batch sphere_centers(centers, &frame_memory);
+        const std::pmr::vector<std::uint32_t> visible = gfx::visible_spheres(sphere_centers, radii, frustum, &frame_memory);
+        assert(!visible.empty() && visible.size() < spheres.size());
+        assert(std::ranges::all_of(visible, [&](const std::uint32_t i) { return frustum.intersects(spheres[i]); }));
+
+        // Back and forth, so that every other frame does the same work
+        std::pmr::vector<Sphere> moved(spheres.begin(), spheres.end(), &frame_memory);
+        for (std::size_t i = 0; i < moved.size(); ++i) moved[i].center += steps[i] * Scalar(k % 2);
+        hash.update(moved, &frame_memory);
+        std::pmr::vector<gfx::SpatialHash::Pair> pairs(&frame_memory);
+        hash.overlapping_pairs(pairs);
+        std::pmr::vector<std::uint32_t> found(&frame_memory);
+        hash.query({ Vector3::zero(), 5 }, found, &frame_memory);
+
+        last_hits = hits;
+        last_pairs = pairs.size();
+    };
+
+    frame(0);
+    frame(1);
+    const std::size_t before = allocation_count;
+    frame(2);
+    frame(3);
+    assert(allocation_count == before);
+    assert(last_hits > 0 && last_pairs > 0);
+}
+
+void test_thread_pool()
+{
+    ThreadPool pool(3);
+    assert(pool.size() == 3);
+
+    std::vector<int> visits(1000, 0);
+    pool.parallel_for(visits.size(), [&](const std::size_t i) { ++visits[i]; });
+    for (const int v : visits) assert(v == 1);
+
+    // Nested calls from the workers
+    std::atomic<std::size_t> total = 0;
+    pool.parallel_for(8, [&](std::size_t) {
+        pool.parallel_for(100, 7, [&](const std::size_t begin, const std::size_t end) { total += end - begin; });
+    });
+    assert(total == 800);
+
+    // Exceptions reach the caller once no task runs anymore, leaving the pool usable
+    for (const std::size_t thrower : { std::size_t(0), std::size_t(999) })
+    {
+        bool caught = false;
+        try
+        {
+            pool.parallel_for(1000, [&](const std::size_t i) {
+                if (i == thrower) throw std::runtime_error("task");
+            });
+        }
+        catch (const std::runtime_error&)
+        {
+            caught = true;
+        }
+        assert(caught);
+    }
+    std::fill(visits.begin(), visits.end(), 0);
+    pool.parallel_for(visits.size(), [&](const std::size_t i) { ++visits[i]; });
+    for (const int v : visits) assert(v == 1);
+}
+
+Transform expected_world(const TransformHierarchy& h, const TransformHierarchy::Node node)
+{
+    const auto parent = h.parent(node);
+    return parent == TransformHierarchy::no_parent ? h.local(node) : h.local(node).then(expected_world(h, parent));
+}
+
+void test_transform_hierarchy()
+{
+    const auto local = [](const Scalar k) {
+        return Transform {
+            .translation = { k, 1, -k },
+            .rotation = Rotation::from_euler({ k, 0.5f, 0.1f * k }),
+            .scale = { 1 + 0.1f * k, 1 + 0.1f * k, 1 + 0.1f * k },
+        };
+    };
+
+    // Two roots, children added out of depth-first order
+    TransformHierarchy h;
+    const auto root = h.add(local(1));
+    const auto a = h.add(local(2), root);
+    const auto b = h.add(local(3), root);
+    std::vector<TransformHierarchy::Node> leaves;
+    for (int i = 0; i < 4; ++i)
+    {
+        leaves.push_back(h.add(local(4 + i), a));
+        leaves.push_back(h.add(local(8 + i), b));
+    }
+    const auto other = h.add(local(12));
+    const auto c = h.add(local(13), other);
+
+    assert(h.size() == 13);
+    assert(h.parent(leaves[0]) == a && h.parent(b) == root && h.parent(root) == TransformHierarchy::no_parent);
+    assert(h.is_dirty(c));
+
+    const auto check = [&] {
+        for (TransformHierarchy::Node n = 0; n < h.size(); ++n)
+        {
+            assert(!h.is_dirty(n));
+            assert(gfx::are_equivalent(h.world(n), expected_world(h, n)));
+            assert(gfx::are_equivalent(h.world_transforms()[h.index(n)], h.world(n)));
+        }
+    };
+
+    assert(h.update() == 13);
+    check();
+    assert(h.update() == 0);
+
+    // Only the changed subtrees
+    h.set_local(leaves[3], local(-1));
+    assert(h.update() == 1);
+    check();
+
+    h.set_local(a, local(-2));
+    h.set_local(leaves[0], local(-3));
+    h.set_local(c, local(-4));
+    assert(h.update() == 5 + 1);
+    check();
+
+    // A deep chain with wide fans below it, in parallel with tiny tasks
+    TransformHierarchy deep;
+    auto node = deep.add(local(0));
+    for (int i = 1; i < 200; ++i) node = deep.add(local(Scalar(i % 7)), node);
+    for (int i = 0; i < 300; ++i) deep.add(local(Scalar(i % 5)), TransformHierarchy::Node(i % 3 ? 100 : 199));
+
+    ThreadPool pool(3);
+    assert(deep.update(pool, 8) == deep.size());
+    for (TransformHierarchy::Node n = 0; n < deep.size(); ++n)
+    {
+        assert(gfx::are_equivalent(deep.world(n), expected_world(deep, n), 1e-3f));
+    }
+
+    deep.set_local(150, local(3));
+    assert(deep.update(pool, 8) == 50 + 100);
+    for (TransformHierarchy::Node n = 0; n < deep.size(); ++n)
+    {
+        assert(gfx::are_equivalent(deep.world(n), expected_world(deep, n), 1e-3f));
+    }
+}
+
+void test_render()
+{
+    const gfx::Scene scene({ { { 0, 0, 10 }, 2 } });
+    const gfx::Camera camera { .position = Vector3::origin() };
+    const gfx::RenderOptions options { .width = 33, .height = 17, .tile_size = 8 };
+
+    ThreadPool pool(2);
+    const gfx::Image image = gfx::render(camera, scene, options, pool);
+    assert(image.width() == 33 && image.height() == 17);
+
+    // The sphere is in the middle, lit from above
+    const Vector3 center = image.at(16, 8);
+    const Vector3 corner = image.at(0, 0);
+    assert(center.x > corner.x);
+    assert(image.at(16, 6).x > image.at(16, 10).x);
+}
+
+void test_archive()
+{
+    const std::string path = (std::filesystem::temp_directory_path() / "gfx_test_archive.bin").string();
+
+    const std::vector<Vector3> points = test_points(100);
+    std::vector<gfx::Sphered> spheres;
+    std::vector<Rotation> rotations;
+    std::vector<Matrix3> matrices;
+    for (const Vector3& p : points)
+    {
+        spheres.push_back({ p.cast<double>(), std::abs(p.x) });
+        rotations.push_back(Rotation::from_euler(p));
+        matrices.push_back(rotations.back().as_matrix3());
+    }
+
+    {
+        gfx::ArchiveWriter writer(path);
+        writer.write("points", points);
+        writer.write("rotations", rotations);
+        // Streamed in uneven chunks
+        writer.begin<gfx::Sphered>("spheres");
+        writer.append(std::span(spheres).first(37));
+        writer.append(std::span(spheres).subspan(37));
+        writer.write("matrices", matrices);
+        writer.write("empty", std::vector<Quaternion>());
+        assert(writer.good());
+        assert(writer.finish());
+    }
+
+    gfx::MappedArchive archive(path);
+    assert(archive.is_open() && archive.verify());
+    assert(archive.entries().size() == 5);
+
+    const auto read_points = archive.get<Vector3>("points");
+    const auto read_spheres = archive.get<gfx::Sphered>("spheres");
+    const auto read_rotations = archive.get<Rotation>("rotations");
+    const auto read_matrices = archive.get<Matrix3>("matrices");
+    assert(std::ranges::equal(read_points, points));
+    assert(std::ranges::equal(read_rotations, rotations, [](const Rotation& a, const Rotation& b) { return a.as_quaternion() == b.as_quaternion(); }));
+    assert(std::ranges::equal(read_matrices, matrices));
+    assert(read_spheres.size() == spheres.size());
+    for (std::size_t i = 0; i < spheres.size(); ++i)
+    {
+        assert(read_spheres[i].center == spheres[i].center && read_spheres[i].radius == spheres[i].radius);
+    }
+
+    // In place and aligned for SIMD loads
+    for (const void* p : { (const void*)read_points.data(), (const void*)read_spheres.data(), (const void*)read_matrices.data() })
+    {
+        assert(reinterpret_cast<std::uintptr_t>(p) % gfx::ARCHIVE_ALIGNMENT == 0);
+    }
+
+    // Missing arrays or other types
+    assert(archive.find("empty") != nullptr && archive.get<Quaternion>("empty").empty());
+    assert(archive.get<Vector3>("missing").empty());
+    assert(archive.get<gfx::Vector3d>("points").empty());
+    assert(archive.get<gfx::Sphere>("spheres").empty());
+
+    // Moves keep the mapping
+    gfx::MappedArchive moved = std::move(archive);
+    assert(!archive.is_open() && moved.get<Vector3>("points").data() == read_points.data());
+    moved.close();
+
+    std::vector<char> bytes;
+    {
+        std::ifstream file(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(file), {});
+    }
+    const auto write_modified = [&](const std::size_t offset) {
+        std::vector<char> modified = bytes;
+        modified[offset] ^= 1;
+        std::ofstream(path, std::ios::binary).write(modified.data(), std::streamsize(modified.size()));
+    };
+
+    // A damaged header or directory fails to open
+    write_modified(12);
+    assert(!gfx::MappedArchive(path).is_open());
+    write_modified(bytes.size() - 70);
+    assert(!gfx::MappedArchive(path).is_open());
+
+    // A damaged array only fails verification
+    write_modified(gfx::ARCHIVE_ALIGNMENT + 5);
+    assert(gfx::MappedArchive(path).is_open() && !gfx::MappedArchive(path).verify());
+
+    std::filesystem::remove(path);
+    assert(!gfx::MappedArchive(path).is_open());
 }
 
 int main()
 {
     test_vector3_operators();
     test_ray_sphere_intersection();
+    test_ray_hits();
     test_quaternion();
     test_180_y();
     test_60_axis();
     test_rot_matrix();
+    test_matrix3();
+    test_precision();
+    test_transform();
+    test_slerp();
+    test_fast_math();
+    test_vector3_batch();
+    test_rotation_batch();
+    test_euler();
+    test_cumulative_rotations();
+    test_rotation_accumulator();
+    test_matrix3_batch();
+    test_rotation_encoding();
+    test_transform_batch();
+    test_dual_quaternion();
+    test_skinning();
+    test_animation();
+    test_rotation_spline();
+    test_ray_packets();
+    test_triangle_mesh();
+    test_bvh();
+    test_spatial_hash();
+    test_frustum();
+    test_memory();
+    test_thread_pool();
+    test_transform_hierarchy();
+    test_render();
+    test_archive();
 
     return 0;
 }